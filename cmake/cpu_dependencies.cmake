@@ -0,0 +1,18 @@
+# Libraries of the CPU only targets (tests, headless tools). On Windows they come from thirdparty,
+# elsewhere from installed packages or, on request, fetched with CPM
+option(DX12FRAMEWORK_FETCH_DEPENDENCIES "Fetch meshoptimizer and assimp for the tests and headless tools when they are not installed" OFF)
+
+if (TARGET meshoptimizer)
+  set(MESHOPTIMIZER_LIBRARY meshoptimizer)
+else()
+  find_package(meshoptimizer CONFIG QUIET)
+  if (meshoptimizer_FOUND)
+    set(MESHOPTIMIZER_LIBRARY meshoptimizer::meshoptimizer)
+  elseif (DX12FRAMEWORK_FETCH_DEPENDENCIES)
+    include(CPM)
+    CPMAddPackage("gh:zeux/meshoptimizer#v0.22")
+    set(MESHOPTIMIZER_LIBRARY meshoptimizer)
+  else()
+    message(STATUS "meshoptimizer not found, targets that need it are skipped. Set DX12FRAMEWORK_FETCH_DEPENDENCIES to fetch it")
+  endif()
+endif()
@@ -18,7 +18,8 @@
                   SRV(t1), \
                   SRV(t2), \
                   SRV(t3), \
-                  SRV(t4) \
+                  SRV(t4), \
+                  SRV(t5) \
                   "
 
 
@@ -34,6 +35,7 @@
 struct Payload
 {
     uint MeshletIndices[AS_GROUP_SIZE];
+    uint InstanceIndex;
 };
 
 bool IsConeDegenerate(MeshletCullData c)
@@ -66,6 +68,7 @@ ConstantBuffer<CameraConstants>         CameraData              : register(b2);
 // StructuredBuffer<uint>    MeshletTriangleIndices  : register(t3);
 
 StructuredBuffer<MeshletCullData>              meshletcullData         : register(t4);
+StructuredBuffer<InstanceTransform>            Instances               : register(t5);
 
 // The groupshared payload data to export to dispatched mesh shader threadgroups
 groupshared Payload s_Payload;
@@ -115,16 +118,18 @@ bool IsVisible(MeshletCullData c, float4x4 world, float scale, float3 viewPos)
 
 [RootSignature(ROOT_SIG)]
 [NumThreads(AS_GROUP_SIZE, 1, 1)]
-void as_main(uint gtid : SV_GroupThreadID, uint dtid : SV_DispatchThreadID, uint gid : SV_GroupID)
+void as_main(uint gtid : SV_GroupThreadID, uint dtid : SV_DispatchThreadID, uint3 gid : SV_GroupID)
 {
     bool visible = false;
+    // Group Y walks the instances of the dispatch
+    uint instanceIndex = MeshInfo.InstanceOffset + gid.y;
 
     // Check bounds of meshlet cull data resource
     if (dtid < MeshInfo.MeshletCount)
     {
         // Do visibility testing for this thread
         float scale = 1.0f;
-        visible = IsVisible(meshletcullData[MeshInfo.MeshletOffset + dtid], InstanceData.World, scale, CameraData.CullViewPosition);
+        visible = IsVisible(meshletcullData[MeshInfo.MeshletOffset + dtid], Instances[instanceIndex].World, scale, CameraData.CullViewPosition);
     }
     
     // Compact visible meshlets into the export payload array
@@ -134,6 +139,8 @@ void as_main(uint gtid : SV_GroupThreadID, uint dtid : SV_DispatchThreadID, uint
         s_Payload.MeshletIndices[index] = dtid;
     }
 
+    s_Payload.InstanceIndex = instanceIndex;
+
     // Dispatch the required number of MS threadgroups to render the visible meshlets
     uint visibleCount = WaveActiveCountBits(visible);
     DispatchMesh(visibleCount, 1, 1, s_Payload);
@@ -35,6 +35,7 @@ struct Meshlet
 struct Payload
 {
     uint MeshletIndices[32];
+    uint InstanceIndex;
 };
 
 ConstantBuffer<SceneConstantBuffer> InstanceData       : register(b0);
@@ -48,6 +49,7 @@ StructuredBuffer<Vertex>  Vertices                : register(t0);
 StructuredBuffer<Meshlet> Meshlets                : register(t1);
 StructuredBuffer<uint>    MeshletIndexBuffer      : register(t2);
 StructuredBuffer<uint>    MeshletTriangleIndices  : register(t3);
+StructuredBuffer<InstanceTransform> Instances     : register(t5);
 //StructuredBuffer<CullData>              MeshletCullData         : register(t4);
 
 
@@ -58,11 +60,24 @@ StructuredBuffer<uint>    MeshletTriangleIndices  : register(t3);
                   SRV(t1), \
                   SRV(t2), \
                   SRV(t3), \
-                  SRV(t4) \
+                  SRV(t4), \
+                  SRV(t5) \
                   "
 
 
 
+// Meshes with at most 65536 vertices store two 16-bit indices per uint
+uint GetVertexIndex(uint index)
+{
+    if (MeshInfo.IndexBytes == 2)
+    {
+        uint packedIndices = MeshletIndexBuffer[index / 2];
+        return (index & 1) ? (packedIndices >> 16) : (packedIndices & 0xFFFF);
+    }
+
+    return MeshletIndexBuffer[index];
+}
+
 uint3 GetPrimitive(Meshlet m, uint index)
 {
     uint3 primitive;
@@ -74,14 +89,15 @@ uint3 GetPrimitive(Meshlet m, uint index)
     return primitive.xyz;
 }
 
-VertexOut GetVertexAttributes(uint meshletIndex, uint vertexIndex)
+VertexOut GetVertexAttributes(uint meshletIndex, uint vertexIndex, uint instanceIndex)
 {
-    Vertex v = Vertices[MeshletIndexBuffer[vertexIndex]];
+    Vertex v = Vertices[GetVertexIndex(vertexIndex)];
+    InstanceTransform instance = Instances[instanceIndex];
     
     VertexOut vout;
-    vout.PositionVS = mul(float4(v.Position, 1), InstanceData.WorldView).xyz;
-    vout.PositionHS = mul(float4(v.Position, 1), InstanceData.WorldViewProj);
-    vout.Normal = mul(float4(v.Normal, 0), InstanceData.World).xyz;
+    vout.PositionVS = mul(float4(v.Position, 1), instance.WorldView).xyz;
+    vout.PositionHS = mul(float4(v.Position, 1), instance.WorldViewProj);
+    vout.Normal = mul(float4(v.Normal, 0), instance.World).xyz;
     vout.MeshletIndex = meshletIndex;
     vout.TriangleIndex = vertexIndex / 3;
     return vout;
@@ -92,7 +108,7 @@ VertexOut GetVertexAttributes(uint meshletIndex, uint vertexIndex)
 [NumThreads(128, 1, 1)]
 void ms_main(
     uint gtid : SV_GroupThreadID,
-    uint gid : SV_GroupID,
+    uint3 gid : SV_GroupID,
     in payload Payload payload,
     out indices uint3 tris[256],
     out vertices VertexOut verts[128]
@@ -100,9 +116,11 @@ void ms_main(
 {
 
 #ifdef CULLING
-    uint meshletIndex = MeshInfo.MeshletOffset + payload.MeshletIndices[gid];
+    uint meshletIndex = MeshInfo.MeshletOffset + payload.MeshletIndices[gid.x];
+    uint instanceIndex = payload.InstanceIndex;
 #else
-    uint meshletIndex = MeshInfo.MeshletOffset + gid;
+    uint meshletIndex = MeshInfo.MeshletOffset + gid.x;
+    uint instanceIndex = MeshInfo.InstanceOffset + gid.y;
 #endif
     if (meshletIndex >= MeshInfo.MeshletOffset + MeshInfo.MeshletCount)
         return;
@@ -128,6 +146,6 @@ void ms_main(
     if (gtid < m.VertCount)
     {
         uint vertexIndex = m.VertOffset + gtid;
-        verts[gtid] = GetVertexAttributes(meshletIndex, vertexIndex);
+        verts[gtid] = GetVertexAttributes(meshletIndex, vertexIndex, instanceIndex);
     }
 }
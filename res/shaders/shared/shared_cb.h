@@ -49,6 +49,15 @@ struct MeshInfo
     uint IndexBytes;
     uint MeshletOffset;
     uint MeshletCount;
+    uint InstanceOffset; // first entry of Instances, group Y of the dispatch counts from here
+};
+
+// One per drawn instance, Instances[] is compacted to the visible ones on the CPU
+struct InstanceTransform
+{
+    float4x4 World;
+    float4x4 WorldView;
+    float4x4 WorldViewProj;
 };
 
 
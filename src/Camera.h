@@ -37,6 +37,7 @@ public:
     const Frustum& getFrustum() const { return m_frustum; }
 
     const float getAspectRatio() const { return m_width / m_height; }
+    const float getHeight() const { return m_height; }
     const float getFov() const { return m_fov; }
     const float getNearPlane() const { return m_nearPlane; }
     const float getFarPlane() const { return m_farPlane; }
@@ -0,0 +1,256 @@
+#include "MeshletBVH.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include "DXMeshletGenerator/MeshletTypes.h"
+
+namespace culling
+{
+    // DispatchMesh accepts at most 65535 groups per dimension, a range can't be bigger than that many AS groups.
+    static const uint32_t MAX_RANGE_SIZE = 65535 * MESHLET_BVH_LEAF_SIZE;
+
+    // Median splits keep the tree balanced, so its depth stays far below this for any meshlet count that fits in uint32_t.
+    static const uint32_t MAX_TRAVERSAL_DEPTH = 64;
+
+    hlsl::float4 mergeSpheres(const hlsl::float4& a, const hlsl::float4& b)
+    {
+        const hlsl::float3 centerA = hlsl::float3(a.x, a.y, a.z);
+        const hlsl::float3 centerB = hlsl::float3(b.x, b.y, b.z);
+        const hlsl::float3 direction = centerB - centerA;
+        const float distance = hlsl::length(direction);
+
+        // one sphere already contains the other
+        if (distance + b.w <= a.w)
+            return a;
+        if (distance + a.w <= b.w)
+            return b;
+
+        const float radius = 0.5f * (distance + a.w + b.w);
+        const hlsl::float3 center = centerA + direction * ((radius - a.w) / distance);
+        return hlsl::float4(center.x, center.y, center.z, radius);
+    }
+
+    namespace
+    {
+        MeshletBVHNode makeNode(uint32_t meshletOffset, uint32_t meshletCount)
+        {
+            MeshletBVHNode node = {};
+            node.meshletOffset = meshletOffset;
+            node.meshletCount = meshletCount;
+            node.firstChild = MESHLET_BVH_INVALID_NODE;
+            return node;
+        }
+
+        hlsl::float4 toSphere(const CullData& cullData)
+        {
+            return hlsl::float4(cullData.BoundingSphere.x, cullData.BoundingSphere.y, cullData.BoundingSphere.z, cullData.BoundingSphere.w);
+        }
+
+        void appendRange(std::vector<MeshSubset>& ranges, uint32_t offset, uint32_t count)
+        {
+            while (count > 0)
+            {
+                uint32_t taken;
+                if (!ranges.empty() && ranges.back().offset + ranges.back().size == offset && ranges.back().size < MAX_RANGE_SIZE)
+                {
+                    taken = std::min(count, MAX_RANGE_SIZE - ranges.back().size);
+                    ranges.back().size += taken;
+                }
+                else
+                {
+                    taken = std::min(count, MAX_RANGE_SIZE);
+                    ranges.push_back({ offset, taken });
+                }
+                offset += taken;
+                count -= taken;
+            }
+        }
+    }
+
+    void buildMeshletBVH(
+        std::vector<Meshlet>& meshlets,
+        std::vector<CullData>& cullData,
+        std::vector<MeshletBVHNode>& nodes,
+        uint32_t leafSize)
+    {
+        nodes.clear();
+
+        const uint32_t meshletCount = static_cast<uint32_t>(meshlets.size());
+        if (meshletCount == 0)
+            return;
+
+        assert(cullData.size() == meshlets.size());
+
+        std::vector<uint32_t> order(meshletCount);
+        std::iota(order.begin(), order.end(), 0);
+
+        std::vector<hlsl::float3> centers(meshletCount);
+        for (uint32_t i = 0; i < meshletCount; i++)
+        {
+            centers[i] = hlsl::float3(cullData[i].BoundingSphere.x, cullData[i].BoundingSphere.y, cullData[i].BoundingSphere.z);
+        }
+
+        struct BuildTask
+        {
+            uint32_t node;
+            uint32_t begin;
+            uint32_t end;
+        };
+
+        std::vector<BuildTask> tasks;
+        nodes.push_back(makeNode(0, meshletCount));
+        tasks.push_back({ 0, 0, meshletCount });
+
+        while (!tasks.empty())
+        {
+            const BuildTask task = tasks.back();
+            tasks.pop_back();
+
+            const uint32_t count = task.end - task.begin;
+            if (count <= leafSize)
+                continue;
+
+            hlsl::float3 min = hlsl::FLT3_MAX;
+            hlsl::float3 max = -hlsl::FLT3_MAX;
+            for (uint32_t i = task.begin; i < task.end; i++)
+            {
+                min = hlsl::min(min, centers[order[i]]);
+                max = hlsl::max(max, centers[order[i]]);
+            }
+
+            const hlsl::float3 extent = max - min;
+            uint32_t axis = 0;
+            if (extent.y > extent.x && extent.y >= extent.z)
+                axis = 1;
+            else if (extent.z > extent.x && extent.z > extent.y)
+                axis = 2;
+
+            // Split at the median, rounded so the left subtree is made of full AS groups
+            const uint32_t leafCount = hlsl::divRoundUp(count, leafSize);
+            const uint32_t middle = task.begin + hlsl::divRoundUp(leafCount, 2) * leafSize;
+
+            std::nth_element(order.begin() + task.begin, order.begin() + middle, order.begin() + task.end,
+                [&](uint32_t a, uint32_t b)
+                {
+                    return centers[a][axis] < centers[b][axis];
+                });
+
+            const uint32_t firstChild = static_cast<uint32_t>(nodes.size());
+            nodes[task.node].firstChild = firstChild;
+            nodes.push_back(makeNode(task.begin, middle - task.begin));
+            nodes.push_back(makeNode(middle, task.end - middle));
+
+            tasks.push_back({ firstChild, task.begin, middle });
+            tasks.push_back({ firstChild + 1, middle, task.end });
+        }
+
+        // Make every subtree's meshlets contiguous
+        std::vector<Meshlet> reorderedMeshlets(meshletCount);
+        std::vector<CullData> reorderedCullData(meshletCount);
+        for (uint32_t i = 0; i < meshletCount; i++)
+        {
+            reorderedMeshlets[i] = meshlets[order[i]];
+            reorderedCullData[i] = cullData[order[i]];
+        }
+        std::swap(meshlets, reorderedMeshlets);
+        std::swap(cullData, reorderedCullData);
+
+        // Children are stored after their parents, so walking backwards fits bounds bottom-up
+        for (uint32_t i = static_cast<uint32_t>(nodes.size()); i-- > 0;)
+        {
+            MeshletBVHNode& node = nodes[i];
+            if (node.isLeaf())
+            {
+                node.boundingSphere = toSphere(cullData[node.meshletOffset]);
+                for (uint32_t j = 1; j < node.meshletCount; j++)
+                {
+                    node.boundingSphere = mergeSpheres(node.boundingSphere, toSphere(cullData[node.meshletOffset + j]));
+                }
+            }
+            else
+            {
+                node.boundingSphere = mergeSpheres(nodes[node.firstChild].boundingSphere, nodes[node.firstChild + 1].boundingSphere);
+            }
+        }
+    }
+
+    uint32_t cullMeshletBVH(
+        const std::vector<MeshletBVHNode>& nodes,
+        const hlsl::float4 (&planes)[6],
+        const hlsl::float4x4& world,
+        std::vector<MeshSubset>& visibleRanges)
+    {
+        if (nodes.empty())
+            return 0;
+
+        // Camera planes are not normalized, distances have to be in world units to be compared against radii
+        hlsl::float4 normalizedPlanes[6];
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            const float length = hlsl::length(hlsl::float3(planes[i].x, planes[i].y, planes[i].z));
+            normalizedPlanes[i] = planes[i] / length;
+        }
+
+        const float scale = hlsl::maxScale(world);
+
+        uint32_t stack[MAX_TRAVERSAL_DEPTH];
+        uint32_t stackSize = 0;
+        uint32_t visited = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const MeshletBVHNode& node = nodes[stack[--stackSize]];
+            visited++;
+
+            const hlsl::float4 center = world * hlsl::float4(node.boundingSphere.x, node.boundingSphere.y, node.boundingSphere.z, 1.0f);
+            const float radius = node.boundingSphere.w * scale;
+
+            bool outside = false;
+            bool intersects = false;
+            for (uint32_t i = 0; i < 6; i++)
+            {
+                const float distance = dot(hlsl::float3(center.x, center.y, center.z), hlsl::float3(normalizedPlanes[i].x, normalizedPlanes[i].y, normalizedPlanes[i].z)) + normalizedPlanes[i].w;
+                if (distance < -radius)
+                {
+                    outside = true;
+                    break;
+                }
+                if (distance < radius)
+                    intersects = true;
+            }
+
+            if (outside)
+                continue;
+
+            if (!intersects || node.isLeaf())
+            {
+                appendRange(visibleRanges, node.meshletOffset, node.meshletCount);
+                continue;
+            }
+
+            // Right child first, so ranges come out in ascending order and can be merged
+            assert(stackSize + 2 <= MAX_TRAVERSAL_DEPTH);
+            stack[stackSize++] = node.firstChild + 1;
+            stack[stackSize++] = node.firstChild;
+        }
+
+        return visited;
+    }
+
+    bool isSphereVisible(const hlsl::float4& sphere, const hlsl::float4 (&planes)[6], const hlsl::float4x4& world)
+    {
+        const hlsl::float4 center = world * hlsl::float4(sphere.x, sphere.y, sphere.z, 1.0f);
+        const float radius = sphere.w * hlsl::maxScale(world);
+        for (uint32_t i = 0; i < 6; i++)
+        {
+            const float length = hlsl::length(hlsl::float3(planes[i].x, planes[i].y, planes[i].z));
+            const float distance = (dot(hlsl::float3(center.x, center.y, center.z), hlsl::float3(planes[i].x, planes[i].y, planes[i].z)) + planes[i].w) / length;
+            if (distance < -radius)
+                return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "MeshletStructs.h"
+#include "utils/maths.h"
+
+struct Meshlet;
+struct CullData;
+
+namespace culling
+{
+    // Number of meshlets tested by a single amplification shader group.
+    static const uint32_t MESHLET_BVH_LEAF_SIZE = 32;
+    static const uint32_t MESHLET_BVH_INVALID_NODE = UINT32_MAX;
+
+    struct MeshletBVHNode
+    {
+        hlsl::float4 boundingSphere; // xyz = center, w = radius
+        uint32_t meshletOffset;      // first meshlet of the subtree
+        uint32_t meshletCount;       // meshlets in the subtree, always contiguous
+        uint32_t firstChild;         // right child is firstChild + 1, MESHLET_BVH_INVALID_NODE for leaves
+        uint32_t padding;
+
+        bool isLeaf() const { return firstChild == MESHLET_BVH_INVALID_NODE; }
+    };
+
+    /*
+     * Builds a binary hierarchy over meshlet bounding spheres.
+     * Meshlets and their cull data are reordered in place, so every node covers a contiguous meshlet range.
+     * Node 0 is the root, children are always stored after their parent.
+     */
+    void buildMeshletBVH(
+        std::vector<Meshlet>& meshlets,
+        std::vector<CullData>& cullData,
+        std::vector<MeshletBVHNode>& nodes,
+        uint32_t leafSize = MESHLET_BVH_LEAF_SIZE);
+
+    /*
+     * Walks the hierarchy against world space frustum planes (pointing inwards) and appends meshlet ranges
+     * whose nodes are not fully outside. Subtrees fully inside the frustum are emitted without further tests,
+     * adjacent ranges are merged. Returns number of visited nodes.
+     */
+    uint32_t cullMeshletBVH(
+        const std::vector<MeshletBVHNode>& nodes,
+        const hlsl::float4 (&planes)[6],
+        const hlsl::float4x4& world,
+        std::vector<MeshSubset>& visibleRanges);
+
+    // Same test a single BVH node gets, planes don't have to be normalized
+    bool isSphereVisible(const hlsl::float4& sphere, const hlsl::float4 (&planes)[6], const hlsl::float4x4& world);
+
+    hlsl::float4 mergeSpheres(const hlsl::float4& a, const hlsl::float4& b);
+}
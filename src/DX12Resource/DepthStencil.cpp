@@ -67,5 +67,5 @@ DepthStencil::~DepthStencil()
 
 void DepthStencil::clear()
 {
-    Renderer::get_instance()->g_pd3dCommandList->ClearDepthStencilView(m_heap->GetCPUDescriptorHandleForHeapStart(), D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+    Renderer::get_instance()->get_command_list()->ClearDepthStencilView(m_heap->GetCPUDescriptorHandleForHeapStart(), D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
 }
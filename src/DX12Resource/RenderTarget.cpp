@@ -125,7 +125,7 @@ void RenderTarget::bind(PipelineState* pso, std::string name)
     if (m_tripleBuffered)
         gpuHandle.ptr += m_srvDescSize * Renderer::get_instance()->getSwapChain()->GetCurrentBackBufferIndex();
 
-    auto cmdList = Renderer::get_instance()->g_pd3dCommandList;
+    auto cmdList = Renderer::get_instance()->get_command_list();
     cmdList->SetDescriptorHeaps(1, &m_srvHeap);
     cmdList->SetGraphicsRootDescriptorTable(pso->getRootParameterIndex(name), gpuHandle);
 }
@@ -137,6 +137,6 @@ void RenderTarget::clear()
     auto rtvHandle = m_rtvHandle;
     if (m_tripleBuffered)
         rtvHandle.ptr += Renderer::get_instance()->getSwapChain()->GetCurrentBackBufferIndex() * m_rtvDescSize;
-    Renderer::get_instance()->g_pd3dCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+    Renderer::get_instance()->get_command_list()->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
 }
 
@@ -0,0 +1,36 @@
+#include "BindingTable.h"
+
+#include "PipelineState.h"
+#include "utils/ErrorHandler.h"
+
+bool BindingTable::isBuiltFor(PipelineState const* pso) const
+{
+    return m_pso == pso && m_rootSignatureVersion == pso->getRootSignatureVersion();
+}
+
+void BindingTable::begin(PipelineState const* pso)
+{
+    m_pso = pso;
+    m_rootSignatureVersion = pso->getRootSignatureVersion();
+    m_count = 0;
+}
+
+void BindingTable::addShaderResource(const char* name, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+    int32_t const index = m_pso->getRootParameterIndex(name);
+    if (index == -1)
+        return;
+
+    if (m_count == MAX_BINDINGS)
+        AssertFailed(E_OUTOFMEMORY);
+
+    m_bindings[m_count++] = { static_cast<uint32_t>(index), address };
+}
+
+void BindingTable::apply(ID3D12GraphicsCommandList* cmdList) const
+{
+    for (uint32_t i = 0; i < m_count; i++)
+    {
+        cmdList->SetGraphicsRootShaderResourceView(m_bindings[i].rootParameterIndex, m_bindings[i].address);
+    }
+}
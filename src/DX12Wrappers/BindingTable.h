@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <d3d12.h>
+
+class PipelineState;
+
+/*
+ * Root SRVs of one draw resolved to (root parameter index, GPU address) pairs, built once per pipeline state and
+ * replayed with no hashing or string handling. Stale as soon as the pipeline state's root signature is rebuilt
+ * (shader reload) or the bound resources change, owners call reset() for the latter.
+ * Per draw constants aren't part of it, ConstantBuffer caches its own index.
+ */
+class BindingTable
+{
+public:
+    static constexpr uint32_t MAX_BINDINGS = 8;
+
+    bool isBuiltFor(PipelineState const* pso) const;
+    // Empties the table and ties it to pso's current root signature
+    void begin(PipelineState const* pso);
+    // Names the shaders don't use are skipped
+    void addShaderResource(const char* name, D3D12_GPU_VIRTUAL_ADDRESS address);
+    void reset() { m_pso = nullptr; m_count = 0; }
+
+    void apply(ID3D12GraphicsCommandList* cmdList) const;
+
+private:
+    struct Binding
+    {
+        uint32_t rootParameterIndex;
+        D3D12_GPU_VIRTUAL_ADDRESS address;
+    };
+
+    PipelineState const* m_pso = nullptr;
+    uint32_t m_rootSignatureVersion = 0;
+    Binding m_bindings[MAX_BINDINGS] = {};
+    uint32_t m_count = 0;
+};
@@ -1,6 +1,7 @@
 #include "CommandQueue.h"
 
 #include <iostream>
+#include <vector>
 
 #include "utils/ErrorHandler.h"
 
@@ -67,21 +68,30 @@ ID3D12GraphicsCommandList6* CommandQueue::get_command_list()
 
 uint64_t CommandQueue::execute_command_list(ID3D12GraphicsCommandList6* commandList)
 {
-    commandList->Close();
+    return execute_command_lists(&commandList, 1);
+}
 
-    ID3D12CommandAllocator* commandAllocator;
-    UINT dataSize = sizeof(commandAllocator);
-    AssertFailed(commandList->GetPrivateData(__uuidof(ID3D12CommandAllocator), &dataSize, &commandAllocator));
+uint64_t CommandQueue::execute_command_lists(ID3D12GraphicsCommandList6* const* commandLists, uint32_t count)
+{
+    std::vector<ID3D12CommandList*> lists(count);
+    std::vector<ID3D12CommandAllocator*> commandAllocators(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        commandLists[i]->Close();
 
-    ID3D12CommandList* const ppCommandLists[] = {
-        commandList
-    };
+        UINT dataSize = sizeof(ID3D12CommandAllocator*);
+        AssertFailed(commandLists[i]->GetPrivateData(__uuidof(ID3D12CommandAllocator), &dataSize, &commandAllocators[i]));
+        lists[i] = commandLists[i];
+    }
 
-    m_d3d12CommandQueue->ExecuteCommandLists(1, ppCommandLists);
+    m_d3d12CommandQueue->ExecuteCommandLists(count, lists.data());
     uint64_t fenceValue = signal();
 
-    m_CommandAllocatorQueue.emplace(CommandAllocatorEntry{ fenceValue, commandAllocator });
-    m_CommandListQueue.push(commandList);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_CommandAllocatorQueue.emplace(CommandAllocatorEntry{ fenceValue, commandAllocators[i] });
+        m_CommandListQueue.push(commandLists[i]);
+    }
 
 	// TODO: Do I need to release the command allocator?
     //commandAllocator->Release();
@@ -101,6 +111,11 @@ bool CommandQueue::is_fence_complete(uint64_t fenceValue)
     return m_d3d12Fence->GetCompletedValue() >= fenceValue;
 }
 
+uint64_t CommandQueue::get_completed_fence_value() const
+{
+    return m_d3d12Fence->GetCompletedValue();
+}
+
 void CommandQueue::wait_for_fence_value(uint64_t fenceValue)
 {
     if (is_fence_complete(fenceValue))
@@ -21,9 +21,13 @@ public:
     // Execute a command list.
     // Returns the fence value to wait for for this command list.
     uint64_t execute_command_list(ID3D12GraphicsCommandList6* commandList);
+    // Closes and executes the lists in order in a single submission, all of them complete with the returned fence value.
+    // Lists must come from get_command_list() of this queue.
+    uint64_t execute_command_lists(ID3D12GraphicsCommandList6* const* commandLists, uint32_t count);
 
     uint64_t signal();
     bool is_fence_complete(uint64_t fenceValue);
+    uint64_t get_completed_fence_value() const;
     void wait_for_fence_value(uint64_t fenceValue);
     void flush();
 
@@ -0,0 +1,79 @@
+#include "ConstantBufferRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <d3dx12.h>
+
+#include "Renderer.h"
+#include "Tools/PerformanceCounters.h"
+#include "utils/ErrorHandler.h"
+
+ConstantBufferRing* ConstantBufferRing::m_instance;
+
+void ConstantBufferRing::create()
+{
+    m_instance = new ConstantBufferRing();
+
+    auto device = Renderer::get_instance()->get_device();
+    auto const heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+    auto const resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(SIZE);
+    AssertFailed(device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_instance->m_buffer)));
+
+    CD3DX12_RANGE readRange(0, 0);
+    AssertFailed(m_instance->m_buffer->Map(0, &readRange, reinterpret_cast<void**>(&m_instance->m_data)));
+}
+
+ConstantBufferRing* ConstantBufferRing::getInstance()
+{
+    return m_instance;
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferRing::allocate(const void* data, uint64_t size)
+{
+    std::unique_lock<std::mutex> lock(m_allocationMutex);
+    uint64_t offset = 0;
+    if (!m_ring.allocate(size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, offset))
+    {
+        // Previous frames still hold the space, only happens when the GPU is far behind
+        auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+        while (!m_ring.allocate(size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, offset))
+        {
+            // The current frame alone doesn't fit
+            if (m_ring.oldestFenceValue() == 0)
+                AssertFailed(E_OUTOFMEMORY);
+            cmdQueue->wait_for_fence_value(m_ring.oldestFenceValue());
+            m_ring.reclaim(m_ring.oldestFenceValue());
+        }
+    }
+
+    m_peakUsedBytes = std::max(m_peakUsedBytes, m_ring.usedBytes());
+    lock.unlock();
+
+    std::memcpy(m_data + offset, data, size);
+    counters::add(counters::CONSTANT_BUFFER_ALLOCATIONS);
+    counters::add(counters::CONSTANT_BYTES_UPLOADED, size);
+    return m_buffer->GetGPUVirtualAddress() + offset;
+}
+
+void ConstantBufferRing::endFrame(uint64_t fenceValue)
+{
+    m_ring.submit(fenceValue);
+}
+
+void ConstantBufferRing::reclaim()
+{
+    auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    while (m_ring.oldestFenceValue() != 0 && cmdQueue->is_fence_complete(m_ring.oldestFenceValue()))
+    {
+        m_ring.reclaim(m_ring.oldestFenceValue());
+    }
+}
+
+void ConstantBufferRing::cleanup()
+{
+    Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->flush();
+    m_buffer->Unmap(0, nullptr);
+    m_buffer->Release();
+    m_buffer = nullptr;
+    m_data = nullptr;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <d3d12.h>
+#include <mutex>
+
+#include "StagingRing.h"
+
+/*
+ * One mapped upload buffer all constant buffers are bump-allocated from. Every uploadData() gets a fresh slice,
+ * slices of a frame are reclaimed together once the frame's fence completes.
+ * allocate() can be called from recording workers, the rest is main thread only.
+ */
+class ConstantBufferRing
+{
+public:
+    static constexpr uint64_t SIZE = 16ull * 1024 * 1024;
+
+    static void create();
+    static ConstantBufferRing* getInstance();
+
+    // Copies data into a new slice, valid until the fence of the current frame completes
+    D3D12_GPU_VIRTUAL_ADDRESS allocate(const void* data, uint64_t size);
+
+    // For APIs that take a resource and offset instead of an address, ExecuteIndirect arguments
+    ID3D12Resource* getBuffer() const { return m_buffer; }
+    uint64_t getOffset(D3D12_GPU_VIRTUAL_ADDRESS address) const { return address - m_buffer->GetGPUVirtualAddress(); }
+
+    // Tags the frame's slices with the fence its command list was signalled with
+    void endFrame(uint64_t fenceValue);
+    void reclaim();
+    void cleanup();
+
+    uint64_t usedBytes() const { return m_ring.usedBytes(); }
+    uint64_t peakUsedBytes() const { return m_peakUsedBytes; }
+
+private:
+    ConstantBufferRing() : m_ring(SIZE) {}
+
+    static ConstantBufferRing* m_instance;
+
+    StagingRing m_ring;
+    ID3D12Resource* m_buffer = nullptr;
+    uint8_t* m_data = nullptr;
+
+    uint64_t m_peakUsedBytes = 0;
+    std::mutex m_allocationMutex;
+};
@@ -0,0 +1,70 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <imgui.h>
+
+#include "Renderer.h"
+#include "Tools/TimelineRecorder.h"
+
+FramePacer* FramePacer::m_instance;
+
+static_assert(FramePacer::MAX_FRAMES_IN_FLIGHT <= Renderer::NUM_FRAMES_IN_FLIGHT);
+
+void FramePacer::create()
+{
+    m_instance = new FramePacer();
+    m_instance->setFramesInFlight(2);
+}
+
+FramePacer* FramePacer::getInstance()
+{
+    return m_instance;
+}
+
+void FramePacer::beginFrame()
+{
+    TIMELINE_ZONE("FramePacer::beginFrame");
+    auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+    uint64_t const fenceValue = m_tracker.fenceToWaitFor();
+    auto const waitStart = std::chrono::high_resolution_clock::now();
+    if (fenceValue != 0)
+        cmdQueue->wait_for_fence_value(fenceValue);
+    m_lastWaitMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - waitStart).count();
+
+    // Frames newer than the waited one may have finished too
+    m_tracker.retire(cmdQueue->get_completed_fence_value());
+    m_tracker.beginFrame();
+}
+
+void FramePacer::endFrame(uint64_t fenceValue)
+{
+    m_tracker.endFrame(fenceValue);
+}
+
+void FramePacer::waitForIdle()
+{
+    assert(!m_tracker.isInFrame() && "The queue must not be drained while a frame is recorded");
+    Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->flush();
+    m_tracker.retire(Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->get_completed_fence_value());
+}
+
+void FramePacer::setFramesInFlight(uint32_t count)
+{
+    m_tracker.setFramesInFlight(std::clamp(count, 1u, MAX_FRAMES_IN_FLIGHT));
+}
+
+void FramePacer::drawEditor()
+{
+    int32_t framesInFlight = static_cast<int32_t>(m_tracker.framesInFlight());
+    if (ImGui::SliderInt("Frames in flight", &framesInFlight, 1, MAX_FRAMES_IN_FLIGHT))
+    {
+        setFramesInFlight(static_cast<uint32_t>(framesInFlight));
+    }
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+        ImGui::SetTooltip("Frames the CPU may record ahead of the GPU. 1 waits for every frame before starting the next one.");
+
+    ImGui::Text("GPU wait: %.2f ms, frames pending: %u", m_lastWaitMs, m_tracker.pendingFrames());
+}
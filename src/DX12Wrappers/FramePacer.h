@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+
+#include "Tools/FramePacing.h"
+
+/*
+ * Lets the CPU record up to framesInFlight frames ahead of the GPU, see pacing::FrameTracker.
+ * Anything the GPU may still read goes through ResourceManager instead of being freed directly.
+ * waitForIdle() is for swap chain resizes and shutdown only.
+ */
+class FramePacer
+{
+public:
+    // ImGui's DX12 backend keeps that many frames of buffers, more frames must not be in flight
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+    static void create();
+    static FramePacer* getInstance();
+
+    // Waits only for the frame framesInFlight frames back
+    void beginFrame();
+    void endFrame(uint64_t fenceValue);
+
+    void waitForIdle();
+
+    void setFramesInFlight(uint32_t count);
+    uint32_t framesInFlight() const { return m_tracker.framesInFlight(); }
+
+    void drawEditor();
+
+private:
+    FramePacer() = default;
+
+    static FramePacer* m_instance;
+
+    pacing::FrameTracker m_tracker;
+    // CPU time beginFrame() spent waiting for the GPU
+    float m_lastWaitMs = 0.0f;
+};
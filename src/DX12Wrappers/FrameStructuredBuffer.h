@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <d3d12.h>
+#include <string>
+#include "ConstantBufferRing.h"
+#include "Renderer.h"
+
+
+
+/*
+ * Read-only structured buffer rewritten every frame, bound as a root SRV. Data lives in a ConstantBufferRing slice,
+ * upload heaps are readable by shaders, so there's no copy to a default heap. Upload before setting it every frame.
+ */
+template <typename T>
+class FrameStructuredBuffer
+{
+public:
+    FrameStructuredBuffer() = delete;
+    FrameStructuredBuffer(const std::string& name) : m_name(name) {}
+    ~FrameStructuredBuffer() = default;
+
+    void setShaderResource(PipelineState* pso) const;
+    void uploadData(const T* data, uint32_t count);
+
+private:
+    D3D12_GPU_VIRTUAL_ADDRESS m_gpuAddress = 0;
+
+    std::string m_name;
+
+    mutable PipelineState const* m_indexPso = nullptr;
+    mutable uint32_t m_indexRootSignatureVersion = 0;
+    mutable int32_t m_rootParameterIndex = -1;
+};
+
+
+template <typename T>
+void FrameStructuredBuffer<T>::setShaderResource(PipelineState* pso) const
+{
+    if (pso != m_indexPso || pso->getRootSignatureVersion() != m_indexRootSignatureVersion)
+    {
+        m_indexPso = pso;
+        m_indexRootSignatureVersion = pso->getRootSignatureVersion();
+        m_rootParameterIndex = pso->getRootParameterIndex(m_name);
+    }
+
+    if (m_rootParameterIndex == -1)
+        return;
+
+    auto commandList = Renderer::get_instance()->get_command_list();
+    commandList->SetGraphicsRootShaderResourceView(m_rootParameterIndex, m_gpuAddress);
+}
+
+template <typename T>
+void FrameStructuredBuffer<T>::uploadData(const T* data, uint32_t count)
+{
+    m_gpuAddress = ConstantBufferRing::getInstance()->allocate(data, static_cast<uint64_t>(count) * sizeof(T));
+}
@@ -0,0 +1,81 @@
+#include "IndirectDispatcher.h"
+
+#include <cstddef>
+
+#include "ConstantBufferRing.h"
+#include "PipelineState.h"
+#include "Renderer.h"
+#include "ResourceLoaders/ResourceManager.h"
+#include "Tools/PerformanceCounters.h"
+#include "utils/ErrorHandler.h"
+#include "../res/shaders/shared/shared_cb.h"
+
+static_assert(sizeof(indirect::DispatchMeshArguments) == sizeof(D3D12_DISPATCH_MESH_ARGUMENTS));
+static_assert(offsetof(indirect::IndirectCommand, meshInfoAddress) == 0);
+static_assert(offsetof(indirect::IndirectCommand, dispatch) == sizeof(D3D12_GPU_VIRTUAL_ADDRESS));
+static_assert(sizeof(indirect::MeshInfoRecord) == sizeof(MeshInfo));
+static_assert(offsetof(indirect::MeshInfoRecord, IndexBytes) == offsetof(MeshInfo, IndexBytes));
+static_assert(offsetof(indirect::MeshInfoRecord, MeshletOffset) == offsetof(MeshInfo, MeshletOffset));
+static_assert(offsetof(indirect::MeshInfoRecord, MeshletCount) == offsetof(MeshInfo, MeshletCount));
+static_assert(offsetof(indirect::MeshInfoRecord, InstanceOffset) == offsetof(MeshInfo, InstanceOffset));
+static_assert(sizeof(indirect::MeshInfoRecord) % D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT == 0);
+
+IndirectDispatcher::~IndirectDispatcher()
+{
+    ResourceManager::getInstance()->scheduleRelease(m_commandSignature);
+}
+
+void IndirectDispatcher::execute(PipelineState* pso, indirect::IndirectArguments& arguments)
+{
+    if (arguments.count() == 0)
+        return;
+
+    if (pso != m_pso || pso->getRootSignatureVersion() != m_rootSignatureVersion)
+        createCommandSignature(pso);
+
+    // Shaders don't read MeshInfo, nothing to draw with
+    if (m_commandSignature == nullptr)
+        return;
+
+    auto ring = ConstantBufferRing::getInstance();
+    D3D12_GPU_VIRTUAL_ADDRESS const meshInfos = ring->allocate(arguments.meshInfos.data(), arguments.meshInfos.size() * sizeof(indirect::MeshInfoRecord));
+    indirect::patchMeshInfoAddresses(meshInfos, sizeof(indirect::MeshInfoRecord), arguments);
+    D3D12_GPU_VIRTUAL_ADDRESS const commands = ring->allocate(arguments.commands.data(), arguments.commands.size() * sizeof(indirect::IndirectCommand));
+
+    // Upload heap buffers stay in GENERIC_READ, which covers INDIRECT_ARGUMENT
+    auto cmd_list = Renderer::get_instance()->get_command_list();
+    cmd_list->ExecuteIndirect(m_commandSignature, arguments.count(), ring->getBuffer(), ring->getOffset(commands), nullptr, 0);
+
+    counters::add(counters::DISPATCH_CALLS);
+    counters::add(counters::INDIRECT_COMMANDS, arguments.count());
+    for (uint32_t i = 0; i < arguments.count(); i++)
+    {
+        counters::add(counters::MESHLETS_DISPATCHED, static_cast<uint64_t>(arguments.meshInfos[i].MeshletCount) * arguments.commands[i].dispatch.threadGroupCountY);
+    }
+}
+
+void IndirectDispatcher::createCommandSignature(PipelineState* pso)
+{
+    // Frames still in flight may execute the old one
+    ResourceManager::getInstance()->scheduleRelease(m_commandSignature);
+    m_commandSignature = nullptr;
+    m_pso = pso;
+    m_rootSignatureVersion = pso->getRootSignatureVersion();
+
+    int32_t const meshInfoIndex = pso->getRootParameterIndex("MeshInfo");
+    if (meshInfoIndex == -1)
+        return;
+
+    D3D12_INDIRECT_ARGUMENT_DESC arguments[2] = {};
+    arguments[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT_BUFFER_VIEW;
+    arguments[0].ConstantBufferView.RootParameterIndex = static_cast<UINT>(meshInfoIndex);
+    arguments[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH;
+
+    D3D12_COMMAND_SIGNATURE_DESC desc = {};
+    desc.ByteStride = sizeof(indirect::IndirectCommand);
+    desc.NumArgumentDescs = _countof(arguments);
+    desc.pArgumentDescs = arguments;
+
+    auto device = Renderer::get_instance()->get_device();
+    AssertFailed(device->CreateCommandSignature(&desc, pso->dx12RootSignature(), IID_PPV_ARGS(&m_commandSignature)));
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <d3d12.h>
+
+#include "Indirect/IndirectArguments.h"
+
+class PipelineState;
+
+/*
+ * Submits indirect::IndirectArguments with a single ExecuteIndirect. MeshInfo records and commands are copied into
+ * ConstantBufferRing slices, so the argument buffer lives exactly as long as its frame.
+ * The command signature sets a root CBV, so it's tied to the root signature and rebuilt when the pipeline state reloads.
+ */
+class IndirectDispatcher
+{
+public:
+    IndirectDispatcher() = default;
+    ~IndirectDispatcher();
+
+    // Patches MeshInfo addresses into arguments, records have to be final
+    void execute(PipelineState* pso, indirect::IndirectArguments& arguments);
+
+private:
+    void createCommandSignature(PipelineState* pso);
+
+    ID3D12CommandSignature* m_commandSignature = nullptr;
+    PipelineState const* m_pso = nullptr;
+    uint32_t m_rootSignatureVersion = 0;
+};
@@ -0,0 +1,95 @@
+#include "MeshBufferPool.h"
+
+#include <algorithm>
+#include <d3dx12.h>
+
+#include "Renderer.h"
+#include "utils/ErrorHandler.h"
+
+MeshBufferPool* MeshBufferPool::m_instance;
+
+void MeshBufferPool::create()
+{
+    m_instance = new MeshBufferPool();
+}
+
+MeshBufferPool* MeshBufferPool::getInstance()
+{
+    return m_instance;
+}
+
+void MeshBufferPool::addPage(uint64_t size)
+{
+    auto device = Renderer::get_instance()->get_device();
+    auto const heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+    auto const resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+
+    Page page{ nullptr, TLSFAllocator(size, ALIGNMENT) };
+    // Buffers decay to COMMON after every ExecuteCommandLists and get promoted by copies and shader reads,
+    // so sub-ranges never need barriers of their own
+    AssertFailed(device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&page.buffer)));
+    m_pages.push_back(std::move(page));
+}
+
+MeshBufferPool::Allocation MeshBufferPool::allocate(uint64_t size)
+{
+    Allocation allocation;
+    for (uint32_t i = 0; i < m_pages.size(); i++)
+    {
+        if (m_pages[i].allocator.allocate(size, allocation.range))
+        {
+            allocation.page = i;
+            return allocation;
+        }
+    }
+
+    addPage(std::max(PAGE_SIZE, (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT));
+    allocation.page = static_cast<uint32_t>(m_pages.size() - 1);
+    // A fresh page always fits
+    m_pages.back().allocator.allocate(size, allocation.range);
+    return allocation;
+}
+
+void MeshBufferPool::free(Allocation& allocation)
+{
+    // Pages are gone after cleanup, whatever is left goes with them
+    if (!allocation.isValid() || allocation.page >= m_pages.size())
+        return;
+
+    m_pages[allocation.page].allocator.free(allocation.range);
+    allocation = Allocation();
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS MeshBufferPool::getGPUVirtualAddress(Allocation const& allocation) const
+{
+    return m_pages[allocation.page].buffer->GetGPUVirtualAddress() + allocation.range.offset;
+}
+
+uint64_t MeshBufferPool::reservedBytes() const
+{
+    uint64_t bytes = 0;
+    for (auto const& page : m_pages)
+    {
+        bytes += page.allocator.capacity();
+    }
+    return bytes;
+}
+
+uint64_t MeshBufferPool::usedBytes() const
+{
+    uint64_t bytes = 0;
+    for (auto const& page : m_pages)
+    {
+        bytes += page.allocator.usedBytes();
+    }
+    return bytes;
+}
+
+void MeshBufferPool::cleanup()
+{
+    for (auto& page : m_pages)
+    {
+        page.buffer->Release();
+    }
+    m_pages.clear();
+}
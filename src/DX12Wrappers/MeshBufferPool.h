@@ -0,0 +1,56 @@
+#pragma once
+#include <d3d12.h>
+#include <vector>
+
+#include "TLSFAllocator.h"
+
+/*
+ * Mesh buffers live as sub-ranges of a few large default heap buffers instead of one committed
+ * resource each, which costs a 64KB aligned allocation no matter how small the buffer is.
+ * Shaders see the buffers through root SRVs, so a sub-range is just the page address plus offset.
+ */
+class MeshBufferPool
+{
+public:
+    static constexpr uint64_t PAGE_SIZE = 256ull * 1024 * 1024;
+    // Root SRVs of raw and structured buffers need 16 byte aligned addresses
+    static constexpr uint64_t ALIGNMENT = D3D12_RAW_UAV_SRV_BYTE_ALIGNMENT;
+
+    struct Allocation
+    {
+        uint32_t page = 0;
+        TLSFAllocator::Allocation range;
+
+        bool isValid() const { return range.isValid(); }
+    };
+
+    static void create();
+    static MeshBufferPool* getInstance();
+
+    // Adds a page when the existing ones are too fragmented, buffers bigger than a page get a page of their own
+    Allocation allocate(uint64_t size);
+    // Caller makes sure the GPU is done with the range
+    void free(Allocation& allocation);
+
+    ID3D12Resource* getBuffer(Allocation const& allocation) const { return m_pages[allocation.page].buffer; }
+    D3D12_GPU_VIRTUAL_ADDRESS getGPUVirtualAddress(Allocation const& allocation) const;
+
+    uint64_t reservedBytes() const;
+    uint64_t usedBytes() const;
+    uint32_t pageCount() const { return static_cast<uint32_t>(m_pages.size()); }
+
+    void cleanup();
+
+private:
+    struct Page
+    {
+        ID3D12Resource* buffer = nullptr;
+        TLSFAllocator allocator;
+    };
+
+    void addPage(uint64_t size);
+
+    static MeshBufferPool* m_instance;
+
+    std::vector<Page> m_pages;
+};
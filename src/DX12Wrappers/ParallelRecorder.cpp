@@ -0,0 +1,102 @@
+#include "ParallelRecorder.h"
+
+#include <algorithm>
+#include <imgui.h>
+#include <thread>
+
+#include "Renderer.h"
+#include "Tools/GPUProfiler.h"
+#include "Tools/MeshletBenchmark.h"
+#include "Tools/TimelineRecorder.h"
+
+ParallelRecorder* ParallelRecorder::m_instance;
+
+void ParallelRecorder::create()
+{
+    m_instance = new ParallelRecorder();
+    // One core is left to the main thread, it only waits while workers record but runs everything around them
+    uint32_t const cores = std::thread::hardware_concurrency();
+    m_instance->setWorkerCount(cores > 1 ? std::min(cores - 1, MAX_WORKERS) : 0);
+}
+
+ParallelRecorder* ParallelRecorder::getInstance()
+{
+    return m_instance;
+}
+
+void ParallelRecorder::recordAll(std::function<void(ID3D12GraphicsCommandList6*)> const& setup)
+{
+    TIMELINE_ZONE("ParallelRecorder::recordAll");
+    auto renderer = Renderer::get_instance();
+
+    m_costs.clear();
+    for (auto const recordable : m_recordables)
+    {
+        m_costs.push_back(recordable->recordingCost());
+    }
+    recording::partitionByCost(m_costs, m_workerCount, MIN_CHUNK_COST, m_chunks);
+
+    // The benchmark sums "Dispatch Mesh" profiler entries, those are only recorded on the main thread
+    if (m_workerCount == 0 || m_chunks.size() <= 1 || MeshletBenchmark::getInstance()->isRunning())
+    {
+        for (auto const recordable : m_recordables)
+        {
+            recordable->record();
+        }
+        m_recordables.clear();
+        return;
+    }
+
+    // CommandQueue isn't thread safe, lists are taken here and handed to the workers
+    auto cmdQueue = renderer->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    m_commandLists.resize(m_chunks.size());
+    for (auto& commandList : m_commandLists)
+    {
+        commandList = cmdQueue->get_command_list();
+        renderer->setup_command_list(commandList);
+        setup(commandList);
+    }
+
+    auto profiler = GPUProfiler::getInstance();
+    static const uint32_t parallelDrawName = profiler->internName("Parallel Draw");
+    auto const profilerEntry = profiler->startEntry(renderer->g_pd3dCommandList, parallelDrawName);
+
+    m_workers.run(static_cast<uint32_t>(m_chunks.size()), [this](uint32_t chunkIndex)
+    {
+        TIMELINE_ZONE("Record chunk");
+        auto const& chunk = m_chunks[chunkIndex];
+        Renderer::set_thread_command_list(m_commandLists[chunkIndex]);
+        for (uint32_t i = chunk.first; i < chunk.first + chunk.count; i++)
+        {
+            m_recordables[i]->record();
+        }
+        Renderer::set_thread_command_list(nullptr);
+    });
+
+    renderer->insert_command_lists(m_commandLists.data(), static_cast<uint32_t>(m_commandLists.size()));
+    // Started at the end of the list before the workers' lists, ends at the start of the one after them
+    profiler->endEntry(renderer->g_pd3dCommandList, profilerEntry);
+    m_recordables.clear();
+}
+
+void ParallelRecorder::setWorkerCount(uint32_t count)
+{
+    m_workerCount = std::min(count, MAX_WORKERS);
+    m_workers.start(m_workerCount);
+}
+
+void ParallelRecorder::drawEditor()
+{
+    int32_t workers = static_cast<int32_t>(m_workerCount);
+    if (ImGui::SliderInt("Recording workers", &workers, 0, MAX_WORKERS))
+    {
+        setWorkerCount(static_cast<uint32_t>(workers));
+    }
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+        ImGui::SetTooltip("Threads recording model draws into their own command lists, 0 records on the main thread.\nChunks are split by cost, a frame with little to draw still uses one list.");
+}
+
+void ParallelRecorder::cleanup()
+{
+    m_workers.stop();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <d3d12.h>
+#include <functional>
+#include <vector>
+
+#include "Tools/RecordingSchedule.h"
+
+// Something that records its own draws. State it reads must not change while workers record, see ParallelRecorder
+class IRecordable
+{
+public:
+    virtual ~IRecordable() = default;
+
+    virtual void record() = 0;
+    // Rough CPU cost of record(), about one per dispatch, only relative values matter
+    virtual uint64_t recordingCost() const = 0;
+};
+
+/*
+ * Collects the frame's recordables and records them on worker threads, every chunk of recording::partitionByCost
+ * into its own command list. The lists go between the frame list recorded so far and a fresh one for the rest of
+ * the frame, in chunk order, so the GPU sees the draws in the same order as with a single list.
+ * Recordables only run on workers, everything they share has to be thread safe: ConstantBufferRing and counters are,
+ * GPU profiler entries are skipped off the main thread and the whole parallel part is timed as one entry instead.
+ */
+class ParallelRecorder
+{
+public:
+    static constexpr uint32_t MAX_WORKERS = 16;
+    // A command list per few draws costs more than it saves
+    static constexpr uint64_t MIN_CHUNK_COST = 64;
+
+    static void create();
+    static ParallelRecorder* getInstance();
+
+    void add(IRecordable* recordable) { m_recordables.push_back(recordable); }
+    // Records and forgets everything added this frame. setup runs on the main thread for every worker list before
+    // recording starts, lists already have the frame's viewport and scissor
+    void recordAll(std::function<void(ID3D12GraphicsCommandList6*)> const& setup);
+
+    // 0 records on the main thread into the frame list, exactly like before parallel recording existed
+    void setWorkerCount(uint32_t count);
+    uint32_t workerCount() const { return m_workerCount; }
+
+    void drawEditor();
+    void cleanup();
+
+private:
+    ParallelRecorder() = default;
+
+    static ParallelRecorder* m_instance;
+
+    std::vector<IRecordable*> m_recordables;
+    std::vector<uint64_t> m_costs;
+    std::vector<recording::RecordingChunk> m_chunks;
+    std::vector<ID3D12GraphicsCommandList6*> m_commandLists;
+    recording::WorkerPool m_workers;
+    uint32_t m_workerCount = 0;
+};
@@ -3,6 +3,8 @@
 #include <d3dx12.h>
 
 #include "Renderer.h"
+#include "UploadManager.h"
+#include "Tools/PerformanceCounters.h"
 #include "utils/ErrorHandler.h"
 
 Resource::Resource(ID3D12Resource* dx12Resource)
@@ -12,7 +14,10 @@ Resource::Resource(ID3D12Resource* dx12Resource)
 
 Resource::~Resource()
 {
-    m_dx12Resource->Release();
+    if (m_poolAllocation.isValid())
+        MeshBufferPool::getInstance()->free(m_poolAllocation);
+    else
+        m_dx12Resource->Release();
 }
 
 
@@ -25,52 +30,37 @@ void Resource::transitionResource(D3D12_RESOURCE_STATES newState)
         m_currentState, newState);
     m_currentState = newState;
 
-    auto commandList = Renderer::get_instance()->g_pd3dCommandList;
+    auto commandList = Renderer::get_instance()->get_command_list();
     commandList->ResourceBarrier(1, &barrier);
 }
 
 void Resource::create(uint64_t size, void* data)
 {
     auto device = Renderer::get_instance()->get_device();
-    auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
-    auto cmdList = cmdQueue->get_command_list();
 
     auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
     auto defaultHeapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
     AssertFailed(device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&m_dx12Resource)));
 
-    ID3D12Resource* uploadResource;
-    auto uploadHeapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-    AssertFailed(device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadResource)));
-
-    {
-        uint8_t* memory = nullptr;
-        uploadResource->Map(0, nullptr, reinterpret_cast<void**>(&memory));
-        std::memcpy(memory, data, size);
-        uploadResource->Unmap(0, nullptr);
-    }
-
-    cmdQueue->flush();
-
-    D3D12_RESOURCE_BARRIER postCopyBarrier;
-
-    cmdList->CopyResource(m_dx12Resource, uploadResource);
-    postCopyBarrier = CD3DX12_RESOURCE_BARRIER::Transition(m_dx12Resource, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-    cmdList->ResourceBarrier(1, &postCopyBarrier);
+    // Batched with the other uploads, submitted before the next frame's command list
+    UploadManager::getInstance()->uploadBuffer(m_dx12Resource, data, size, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    counters::add(counters::BYTES_UPLOADED, size);
+}
 
-    cmdQueue->execute_command_list(cmdList);
+void Resource::createPooled(uint64_t size, void* data)
+{
+    auto pool = MeshBufferPool::getInstance();
+    m_poolAllocation = pool->allocate(size);
+    m_dx12Resource = pool->getBuffer(m_poolAllocation);
+    m_offset = m_poolAllocation.range.offset;
 
-    auto fence_value = cmdQueue->signal();
-    cmdQueue->wait_for_fence_value(fence_value);
-    uploadResource->Release();
+    UploadManager::getInstance()->uploadBufferRange(m_dx12Resource, m_offset, data, size);
+    counters::add(counters::BYTES_UPLOADED, size);
 }
 
 void Resource::createTexture(D3D12_RESOURCE_DESC descriptor)
 {
     auto device = Renderer::get_instance()->get_device();
-    auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
-    auto cmdList = cmdQueue->get_command_list();
 
     auto defaultHeapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
 
@@ -83,24 +73,18 @@ void Resource::createTexture(D3D12_RESOURCE_DESC descriptor)
     clearValue.Color[2] = clearColor[2];
     clearValue.Color[3] = clearColor[3];
 
+    // Stays in COMMON, the first transitionResource() on the frame list moves it where it's needed, no queue wait
     AssertFailed(device->CreateCommittedResource(&defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &descriptor, D3D12_RESOURCE_STATE_COMMON, &clearValue, IID_PPV_ARGS(&m_dx12Resource)));
-
-    D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(m_dx12Resource, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-    cmdList->ResourceBarrier(1, &barrier);
-
-    cmdQueue->flush();
-
-    auto fence_value = cmdQueue->signal();
-    cmdQueue->wait_for_fence_value(fence_value);
+    m_currentState = D3D12_RESOURCE_STATE_COMMON;
 }
 
-void Resource::bindResource(PipelineState* pso, std::string variableName)
+void Resource::bindResource(PipelineState* pso, std::string_view variableName)
 {
     int32_t index = pso->getRootParameterIndex(variableName);
 
     if (index == -1)
         return;
 
-    auto cmd_list = Renderer::get_instance()->g_pd3dCommandList;
-    cmd_list->SetGraphicsRootShaderResourceView(index, m_dx12Resource->GetGPUVirtualAddress());
+    auto cmd_list = Renderer::get_instance()->get_command_list();
+    cmd_list->SetGraphicsRootShaderResourceView(index, getGPUVirtualAddress());
 }
@@ -2,7 +2,9 @@
 #include <d3dx12.h>
 
 #include "DXMeshletGenerator/D3D12MeshletGenerator.h"
+#include "MeshBufferPool.h"
 #include <string>
+#include <string_view>
 
 class PipelineState;
 
@@ -16,17 +18,24 @@ public:
 
     void transitionResource(D3D12_RESOURCE_STATES newState);
     void create(uint64_t size, void* data);
+    // Sub-range of a MeshBufferPool page instead of a committed resource of its own
+    void createPooled(uint64_t size, void* data);
     void createTexture(D3D12_RESOURCE_DESC descriptor);
 
     ID3D12Resource* getDx12Resource() { return m_dx12Resource; }
 
-    D3D12_GPU_VIRTUAL_ADDRESS getGPUVirtualAddress() const { return m_dx12Resource->GetGPUVirtualAddress(); }
+    D3D12_GPU_VIRTUAL_ADDRESS getGPUVirtualAddress() const { return m_dx12Resource->GetGPUVirtualAddress() + m_offset; }
 
-    void bindResource(PipelineState* pso, std::string variableName);
+    // Looks the name up every call, per draw bindings go through a BindingTable
+    void bindResource(PipelineState* pso, std::string_view variableName);
 
 private:
     ID3D12Resource* m_dx12Resource;
     D3D12_RESOURCE_STATES m_currentState = D3D12_RESOURCE_STATE_COMMON;
 
+    // Set for pooled resources, m_dx12Resource is then the page and isn't owned
+    MeshBufferPool::Allocation m_poolAllocation;
+    uint64_t m_offset = 0;
+
 };
 
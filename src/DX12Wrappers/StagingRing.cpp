@@ -0,0 +1,48 @@
+#include "StagingRing.h"
+
+bool StagingRing::allocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+    if (size == 0 || size > m_capacity)
+        return false;
+
+    // Nothing in flight, start over from the beginning so large allocations don't have to wrap
+    if (m_usedBytes == 0)
+        m_head = 0;
+
+    alignment = alignment == 0 ? 1 : alignment;
+    uint64_t start = (m_head + alignment - 1) / alignment * alignment;
+    if (start + size > m_capacity)
+        start = 0;
+
+    // Space from the head to the start of the allocation is skipped, it's freed together with the allocation
+    uint64_t const skipped = start >= m_head ? start - m_head : m_capacity - m_head;
+    uint64_t const required = skipped + size;
+    if (m_usedBytes + required > m_capacity)
+        return false;
+
+    offset = start;
+    m_head = start + size;
+    if (m_head == m_capacity)
+        m_head = 0;
+    m_usedBytes += required;
+    m_unsubmittedBytes += required;
+    return true;
+}
+
+void StagingRing::submit(uint64_t fenceValue)
+{
+    if (m_unsubmittedBytes == 0)
+        return;
+
+    m_submissions.push({ fenceValue, m_unsubmittedBytes });
+    m_unsubmittedBytes = 0;
+}
+
+void StagingRing::reclaim(uint64_t completedFenceValue)
+{
+    while (!m_submissions.empty() && m_submissions.front().fenceValue <= completedFenceValue)
+    {
+        m_usedBytes -= m_submissions.front().bytes;
+        m_submissions.pop();
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <queue>
+
+/*
+ * Bookkeeping of a ring shaped staging buffer, no device involved. Allocations are handed out in order,
+ * everything allocated between two submit() calls is freed together once reclaim() sees its fence value completed.
+ * An allocation that doesn't fit at the end of the buffer wraps to the start, the skipped tail is freed with it.
+ */
+class StagingRing
+{
+public:
+    explicit StagingRing(uint64_t capacity) : m_capacity(capacity) {}
+
+    // Returns false when there's no contiguous free space, caller should submit, reclaim and retry
+    bool allocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+    // Tags all allocations since the previous submit with fenceValue
+    void submit(uint64_t fenceValue);
+    // Frees allocations of every submission with fence value <= completedFenceValue
+    void reclaim(uint64_t completedFenceValue);
+
+    // Fence value of the oldest submission still holding memory, 0 when there is none
+    uint64_t oldestFenceValue() const { return m_submissions.empty() ? 0 : m_submissions.front().fenceValue; }
+    bool hasUnsubmitted() const { return m_unsubmittedBytes > 0; }
+
+    uint64_t capacity() const { return m_capacity; }
+    uint64_t usedBytes() const { return m_usedBytes; }
+
+private:
+    struct Submission
+    {
+        uint64_t fenceValue;
+        uint64_t bytes; // including alignment and wrap padding
+    };
+
+    uint64_t m_capacity;
+    uint64_t m_head = 0;
+    uint64_t m_usedBytes = 0;
+    uint64_t m_unsubmittedBytes = 0;
+    std::queue<Submission> m_submissions;
+};
@@ -0,0 +1,289 @@
+#include "TLSFAllocator.h"
+
+#include <bit>
+
+TLSFAllocator::TLSFAllocator(uint64_t capacity, uint64_t alignment)
+{
+    m_alignment = alignment == 0 ? 1 : std::bit_ceil(alignment);
+    m_alignmentShift = static_cast<uint32_t>(std::countr_zero(m_alignment));
+    m_capacity = capacity / m_alignment * m_alignment;
+
+    for (auto& lists : m_freeLists)
+    {
+        for (auto& list : lists)
+        {
+            list = INVALID_BLOCK;
+        }
+    }
+
+    if (m_capacity == 0)
+        return;
+
+    uint32_t const block = createBlock();
+    m_blocks[block].offset = 0;
+    m_blocks[block].size = m_capacity;
+    insertFree(block);
+}
+
+void TLSFAllocator::mapping(uint64_t units, uint32_t& fl, uint32_t& sl)
+{
+    uint32_t const msb = 63 - static_cast<uint32_t>(std::countl_zero(units));
+    if (msb < SL_BITS)
+    {
+        fl = 0;
+        sl = static_cast<uint32_t>(units);
+        return;
+    }
+    fl = msb - SL_BITS + 1;
+    sl = static_cast<uint32_t>(units >> (msb - SL_BITS)) - SL_COUNT;
+}
+
+void TLSFAllocator::mappingSearch(uint64_t units, uint32_t& fl, uint32_t& sl)
+{
+    uint32_t const msb = 63 - static_cast<uint32_t>(std::countl_zero(units));
+    if (msb >= SL_BITS)
+        units += (1ull << (msb - SL_BITS)) - 1;
+    mapping(units, fl, sl);
+}
+
+uint32_t TLSFAllocator::findFreeBlock(uint32_t fl, uint32_t sl) const
+{
+    if (fl >= FL_COUNT)
+        return INVALID_BLOCK;
+
+    uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+    if (slMap == 0)
+    {
+        uint64_t const flMap = fl + 1 < 64 ? m_flBitmap & (~0ull << (fl + 1)) : 0;
+        if (flMap == 0)
+            return INVALID_BLOCK;
+        fl = static_cast<uint32_t>(std::countr_zero(flMap));
+        slMap = m_slBitmap[fl];
+    }
+    sl = static_cast<uint32_t>(std::countr_zero(slMap));
+    return m_freeLists[fl][sl];
+}
+
+void TLSFAllocator::insertFree(uint32_t block)
+{
+    uint32_t fl, sl;
+    mapping(m_blocks[block].size >> m_alignmentShift, fl, sl);
+
+    Block& b = m_blocks[block];
+    b.free = true;
+    b.prevFree = INVALID_BLOCK;
+    b.nextFree = m_freeLists[fl][sl];
+    if (b.nextFree != INVALID_BLOCK)
+        m_blocks[b.nextFree].prevFree = block;
+    m_freeLists[fl][sl] = block;
+    m_flBitmap |= 1ull << fl;
+    m_slBitmap[fl] |= 1u << sl;
+    m_freeBlockCount++;
+}
+
+void TLSFAllocator::removeFree(uint32_t block)
+{
+    uint32_t fl, sl;
+    mapping(m_blocks[block].size >> m_alignmentShift, fl, sl);
+
+    Block& b = m_blocks[block];
+    if (b.prevFree != INVALID_BLOCK)
+        m_blocks[b.prevFree].nextFree = b.nextFree;
+    else
+        m_freeLists[fl][sl] = b.nextFree;
+    if (b.nextFree != INVALID_BLOCK)
+        m_blocks[b.nextFree].prevFree = b.prevFree;
+
+    if (m_freeLists[fl][sl] == INVALID_BLOCK)
+    {
+        m_slBitmap[fl] &= ~(1u << sl);
+        if (m_slBitmap[fl] == 0)
+            m_flBitmap &= ~(1ull << fl);
+    }
+    b.free = false;
+    b.prevFree = INVALID_BLOCK;
+    b.nextFree = INVALID_BLOCK;
+    m_freeBlockCount--;
+}
+
+uint32_t TLSFAllocator::createBlock()
+{
+    if (!m_unusedBlocks.empty())
+    {
+        uint32_t const block = m_unusedBlocks.back();
+        m_unusedBlocks.pop_back();
+        m_blocks[block] = Block();
+        return block;
+    }
+    m_blocks.emplace_back();
+    return static_cast<uint32_t>(m_blocks.size() - 1);
+}
+
+void TLSFAllocator::releaseBlock(uint32_t block)
+{
+    m_blocks[block].size = 0;
+    m_unusedBlocks.push_back(block);
+}
+
+void TLSFAllocator::mergeWithNext(uint32_t block)
+{
+    uint32_t const next = m_blocks[block].nextPhysical;
+    m_blocks[block].size += m_blocks[next].size;
+    m_blocks[block].nextPhysical = m_blocks[next].nextPhysical;
+    if (m_blocks[next].nextPhysical != INVALID_BLOCK)
+        m_blocks[m_blocks[next].nextPhysical].prevPhysical = block;
+    releaseBlock(next);
+}
+
+bool TLSFAllocator::allocate(uint64_t size, Allocation& allocation)
+{
+    if (size == 0 || size > m_capacity)
+        return false;
+
+    uint64_t const units = (size + m_alignment - 1) >> m_alignmentShift;
+    uint32_t fl, sl;
+    mappingSearch(units, fl, sl);
+    uint32_t const block = findFreeBlock(fl, sl);
+    if (block == INVALID_BLOCK)
+        return false;
+
+    removeFree(block);
+
+    // Remainder goes back to the free lists as its own block
+    uint64_t const allocatedSize = units << m_alignmentShift;
+    if (m_blocks[block].size > allocatedSize)
+    {
+        uint32_t const remainder = createBlock();
+        Block& b = m_blocks[block];
+        Block& r = m_blocks[remainder];
+        r.offset = b.offset + allocatedSize;
+        r.size = b.size - allocatedSize;
+        r.prevPhysical = block;
+        r.nextPhysical = b.nextPhysical;
+        if (b.nextPhysical != INVALID_BLOCK)
+            m_blocks[b.nextPhysical].prevPhysical = remainder;
+        b.nextPhysical = remainder;
+        b.size = allocatedSize;
+        insertFree(remainder);
+    }
+
+    allocation.offset = m_blocks[block].offset;
+    allocation.size = m_blocks[block].size;
+    allocation.block = block;
+    m_usedBytes += allocation.size;
+    m_allocationCount++;
+    return true;
+}
+
+void TLSFAllocator::free(Allocation& allocation)
+{
+    if (!allocation.isValid())
+        return;
+
+    uint32_t block = allocation.block;
+    m_usedBytes -= m_blocks[block].size;
+    m_allocationCount--;
+
+    uint32_t const next = m_blocks[block].nextPhysical;
+    if (next != INVALID_BLOCK && m_blocks[next].free)
+    {
+        removeFree(next);
+        mergeWithNext(block);
+    }
+    uint32_t const prev = m_blocks[block].prevPhysical;
+    if (prev != INVALID_BLOCK && m_blocks[prev].free)
+    {
+        removeFree(prev);
+        mergeWithNext(prev);
+        block = prev;
+    }
+    insertFree(block);
+    allocation = Allocation();
+}
+
+uint64_t TLSFAllocator::largestFreeBlock() const
+{
+    if (m_flBitmap == 0)
+        return 0;
+
+    uint32_t const fl = 63 - static_cast<uint32_t>(std::countl_zero(m_flBitmap));
+    uint32_t const sl = 31 - static_cast<uint32_t>(std::countl_zero(m_slBitmap[fl]));
+    uint64_t largest = 0;
+    for (uint32_t block = m_freeLists[fl][sl]; block != INVALID_BLOCK; block = m_blocks[block].nextFree)
+    {
+        largest = largest > m_blocks[block].size ? largest : m_blocks[block].size;
+    }
+    return largest;
+}
+
+bool TLSFAllocator::validate() const
+{
+    if (m_capacity == 0)
+        return m_blocks.empty();
+
+    // Physical chain starts at the block with offset 0 and covers the range without gaps
+    uint32_t first = INVALID_BLOCK;
+    for (uint32_t i = 0; i < m_blocks.size(); i++)
+    {
+        if (m_blocks[i].size != 0 && m_blocks[i].prevPhysical == INVALID_BLOCK)
+        {
+            if (first != INVALID_BLOCK)
+                return false;
+            first = i;
+        }
+    }
+    if (first == INVALID_BLOCK || m_blocks[first].offset != 0)
+        return false;
+
+    uint64_t offset = 0;
+    uint64_t used = 0;
+    uint32_t allocations = 0;
+    uint32_t freeBlocks = 0;
+    bool previousFree = false;
+    for (uint32_t block = first; block != INVALID_BLOCK; block = m_blocks[block].nextPhysical)
+    {
+        Block const& b = m_blocks[block];
+        if (b.offset != offset || b.size == 0 || b.size % m_alignment != 0)
+            return false;
+        if (b.nextPhysical != INVALID_BLOCK && m_blocks[b.nextPhysical].prevPhysical != block)
+            return false;
+        // Two free neighbours should have been merged
+        if (b.free && previousFree)
+            return false;
+        previousFree = b.free;
+        offset += b.size;
+        if (b.free)
+        {
+            freeBlocks++;
+        }
+        else
+        {
+            used += b.size;
+            allocations++;
+        }
+    }
+    if (offset != m_capacity || used != m_usedBytes || allocations != m_allocationCount || freeBlocks != m_freeBlockCount)
+        return false;
+
+    // Every free block sits in the list of its class, bitmaps match the lists
+    uint32_t listed = 0;
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++)
+    {
+        if (((m_flBitmap >> fl) & 1) != (m_slBitmap[fl] != 0 ? 1u : 0u))
+            return false;
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++)
+        {
+            if (((m_slBitmap[fl] >> sl) & 1) != (m_freeLists[fl][sl] != INVALID_BLOCK ? 1u : 0u))
+                return false;
+            for (uint32_t block = m_freeLists[fl][sl]; block != INVALID_BLOCK; block = m_blocks[block].nextFree)
+            {
+                uint32_t blockFl, blockSl;
+                mapping(m_blocks[block].size >> m_alignmentShift, blockFl, blockSl);
+                if (!m_blocks[block].free || blockFl != fl || blockSl != sl)
+                    return false;
+                listed++;
+            }
+        }
+    }
+    return listed == m_freeBlockCount;
+}
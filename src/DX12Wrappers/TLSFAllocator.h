@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/*
+ * Two-level segregated fit allocator over an abstract range [0, capacity), it never touches the memory itself.
+ * Free blocks are binned by size class, first level is the power of two, second level splits that into
+ * SL_COUNT linear steps, so allocate and free are O(1) with a worst case waste of 1/SL_COUNT per allocation.
+ * Neighbouring free blocks are merged on free.
+ */
+class TLSFAllocator
+{
+public:
+    static constexpr uint32_t INVALID_BLOCK = UINT32_MAX;
+    static constexpr uint32_t SL_BITS = 4;
+    static constexpr uint32_t SL_COUNT = 1 << SL_BITS;
+    static constexpr uint32_t FL_COUNT = 64 - SL_BITS;
+
+    struct Allocation
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0; // size of the block, can be larger than requested
+        uint32_t block = INVALID_BLOCK;
+
+        bool isValid() const { return block != INVALID_BLOCK; }
+    };
+
+    // alignment must be a power of two, all offsets and block sizes are multiples of it
+    TLSFAllocator(uint64_t capacity, uint64_t alignment);
+
+    bool allocate(uint64_t size, Allocation& allocation);
+    void free(Allocation& allocation);
+
+    uint64_t capacity() const { return m_capacity; }
+    uint64_t alignment() const { return m_alignment; }
+    uint64_t usedBytes() const { return m_usedBytes; }
+    uint64_t freeBytes() const { return m_capacity - m_usedBytes; }
+    uint32_t allocationCount() const { return m_allocationCount; }
+    uint32_t freeBlockCount() const { return m_freeBlockCount; }
+    uint64_t largestFreeBlock() const;
+
+    // Walks every block and checks links, bitmaps and counters, for debugging and fuzzing
+    bool validate() const;
+
+private:
+    struct Block
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t prevPhysical = INVALID_BLOCK;
+        uint32_t nextPhysical = INVALID_BLOCK;
+        uint32_t prevFree = INVALID_BLOCK;
+        uint32_t nextFree = INVALID_BLOCK;
+        bool free = false;
+    };
+
+    static void mapping(uint64_t units, uint32_t& fl, uint32_t& sl);
+    // Smallest class whose every block fits units
+    static void mappingSearch(uint64_t units, uint32_t& fl, uint32_t& sl);
+
+    uint32_t findFreeBlock(uint32_t fl, uint32_t sl) const;
+    void insertFree(uint32_t block);
+    void removeFree(uint32_t block);
+    uint32_t createBlock();
+    void releaseBlock(uint32_t block);
+    // Merges block with next, next goes away
+    void mergeWithNext(uint32_t block);
+
+    uint64_t m_capacity;
+    uint64_t m_alignment;
+    uint32_t m_alignmentShift = 0;
+    uint64_t m_usedBytes = 0;
+    uint32_t m_allocationCount = 0;
+    uint32_t m_freeBlockCount = 0;
+
+    uint64_t m_flBitmap = 0;
+    uint32_t m_slBitmap[FL_COUNT] = {};
+    uint32_t m_freeLists[FL_COUNT][SL_COUNT];
+
+    std::vector<Block> m_blocks;
+    std::vector<uint32_t> m_unusedBlocks; // records in m_blocks free for reuse
+};
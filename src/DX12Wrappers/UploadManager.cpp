@@ -0,0 +1,145 @@
+#include "UploadManager.h"
+
+#include <cstring>
+#include <d3dx12.h>
+
+#include "Renderer.h"
+#include "utils/ErrorHandler.h"
+
+UploadManager* UploadManager::m_instance;
+
+void UploadManager::create()
+{
+    m_instance = new UploadManager();
+
+    auto device = Renderer::get_instance()->get_device();
+    auto const heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+    auto const resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(STAGING_SIZE);
+    AssertFailed(device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_instance->m_stagingBuffer)));
+
+    // Upload heaps can stay mapped for their whole lifetime
+    CD3DX12_RANGE readRange(0, 0);
+    AssertFailed(m_instance->m_stagingBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_instance->m_stagingData)));
+}
+
+UploadManager* UploadManager::getInstance()
+{
+    return m_instance;
+}
+
+ID3D12GraphicsCommandList6* UploadManager::getCommandList()
+{
+    if (m_cmdList == nullptr)
+        m_cmdList = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->get_command_list();
+    return m_cmdList;
+}
+
+bool UploadManager::allocateStaging(uint64_t size, uint64_t& offset)
+{
+    if (size > m_ring.capacity())
+        return false;
+
+    if (m_ring.allocate(size, STAGING_ALIGNMENT, offset))
+        return true;
+
+    // Copies already recorded hold the space we need, get them going first
+    auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    flush();
+    reclaim();
+    while (!m_ring.allocate(size, STAGING_ALIGNMENT, offset))
+    {
+        if (m_ring.oldestFenceValue() == 0)
+            return false;
+        cmdQueue->wait_for_fence_value(m_ring.oldestFenceValue());
+        reclaim();
+    }
+    return true;
+}
+
+void UploadManager::recordCopy(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size)
+{
+    uint64_t offset = 0;
+    ID3D12Resource* source = m_stagingBuffer;
+    if (allocateStaging(size, offset))
+    {
+        std::memcpy(m_stagingData + offset, data, size);
+    }
+    else
+    {
+        auto device = Renderer::get_instance()->get_device();
+        auto const heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+        auto const resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+        AssertFailed(device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&source)));
+
+        uint8_t* memory = nullptr;
+        AssertFailed(source->Map(0, nullptr, reinterpret_cast<void**>(&memory)));
+        std::memcpy(memory, data, size);
+        source->Unmap(0, nullptr);
+        m_unsubmittedDedicated.push_back(source);
+    }
+
+    // Buffers in COMMON are promoted to COPY_DEST by the copy itself
+    getCommandList()->CopyBufferRegion(destination, destinationOffset, source, offset, size);
+}
+
+void UploadManager::uploadBuffer(ID3D12Resource* destination, const void* data, uint64_t size, D3D12_RESOURCE_STATES finalState)
+{
+    recordCopy(destination, 0, data, size);
+    auto const barrier = CD3DX12_RESOURCE_BARRIER::Transition(destination, D3D12_RESOURCE_STATE_COPY_DEST, finalState);
+    getCommandList()->ResourceBarrier(1, &barrier);
+}
+
+void UploadManager::uploadBufferRange(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size)
+{
+    recordCopy(destination, destinationOffset, data, size);
+}
+
+uint64_t UploadManager::flush()
+{
+    if (m_cmdList == nullptr)
+        return 0;
+
+    auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    uint64_t const fenceValue = cmdQueue->execute_command_list(m_cmdList);
+    m_cmdList = nullptr;
+
+    m_ring.submit(fenceValue);
+    for (auto resource : m_unsubmittedDedicated)
+    {
+        m_dedicated.push_back({ fenceValue, resource });
+    }
+    m_unsubmittedDedicated.clear();
+    return fenceValue;
+}
+
+void UploadManager::reclaim()
+{
+    auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    while (m_ring.oldestFenceValue() != 0 && cmdQueue->is_fence_complete(m_ring.oldestFenceValue()))
+    {
+        m_ring.reclaim(m_ring.oldestFenceValue());
+    }
+
+    std::erase_if(m_dedicated, [&](DedicatedStaging const& staging)
+    {
+        if (!cmdQueue->is_fence_complete(staging.fenceValue))
+            return false;
+        staging.resource->Release();
+        return true;
+    });
+}
+
+void UploadManager::cleanup()
+{
+    uint64_t const fenceValue = flush();
+    auto cmdQueue = Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    if (fenceValue != 0)
+        cmdQueue->wait_for_fence_value(fenceValue);
+    cmdQueue->flush();
+    reclaim();
+
+    m_stagingBuffer->Unmap(0, nullptr);
+    m_stagingBuffer->Release();
+    m_stagingBuffer = nullptr;
+    m_stagingData = nullptr;
+}
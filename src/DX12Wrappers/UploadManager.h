@@ -0,0 +1,62 @@
+#pragma once
+#include <d3d12.h>
+#include <vector>
+
+#include "StagingRing.h"
+
+/*
+ * Batches buffer uploads. Data is copied into a persistently mapped staging ring and the copies are recorded
+ * into one command list, which is submitted on flush() without waiting for it. Staging memory is reclaimed
+ * once the fence of its batch completes.
+ * Uploads run on the direct queue, everything submitted after flush() sees the data.
+ */
+class UploadManager
+{
+public:
+    static constexpr uint64_t STAGING_SIZE = 64ull * 1024 * 1024;
+    static constexpr uint64_t STAGING_ALIGNMENT = 16;
+
+    static void create();
+    static UploadManager* getInstance();
+
+    // Records a copy of size bytes of data into destination, which has to be in COMMON state.
+    // data can be freed right after the call.
+    void uploadBuffer(ID3D12Resource* destination, const void* data, uint64_t size, D3D12_RESOURCE_STATES finalState);
+    // Copies into [destinationOffset, destinationOffset + size) without a barrier, for buffers shared by many
+    // sub-ranges that rely on decaying to COMMON after the batch
+    void uploadBufferRange(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size);
+
+    // Submits recorded copies, returns the fence value to wait for, 0 if nothing was recorded
+    uint64_t flush();
+    // Frees staging memory of finished batches, once per frame
+    void reclaim();
+    // Waits for every upload, releases the staging buffer
+    void cleanup();
+
+    uint64_t stagingUsedBytes() const { return m_ring.usedBytes(); }
+
+private:
+    UploadManager() : m_ring(STAGING_SIZE) {}
+
+    ID3D12GraphicsCommandList6* getCommandList();
+    void recordCopy(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size);
+    // Makes room for size bytes, stalls only when the whole ring is still in flight
+    bool allocateStaging(uint64_t size, uint64_t& offset);
+
+    static UploadManager* m_instance;
+
+    StagingRing m_ring;
+    ID3D12Resource* m_stagingBuffer = nullptr;
+    uint8_t* m_stagingData = nullptr;
+
+    ID3D12GraphicsCommandList6* m_cmdList = nullptr;
+
+    // Uploads bigger than the ring get their own staging buffer, released with the batch
+    struct DedicatedStaging
+    {
+        uint64_t fenceValue;
+        ID3D12Resource* resource;
+    };
+    std::vector<ID3D12Resource*> m_unsubmittedDedicated;
+    std::vector<DedicatedStaging> m_dedicated;
+};
@@ -15,6 +15,10 @@
 
 using namespace DirectX;
 
+#ifndef UNREFERENCED_PARAMETER
+#define UNREFERENCED_PARAMETER(P) (void)(P)
+#endif
+
 namespace
 {
     inline XMVECTOR QuantizeSNorm(XMVECTOR value)
@@ -253,7 +257,7 @@ HRESULT internal::ComputeCullData(
 
         // Calculate spatial bounds
         XMVECTOR positionBounds = MinimumBoundingSphere(vertices, m.VertCount);
-        XMStoreFloat4(&c.BoundingSphere, positionBounds);
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&c.BoundingSphere), positionBounds);
 
         // Calculate the normal cone
         // 1. Normalized center point of minimum bounding sphere of unit normals == conic axis
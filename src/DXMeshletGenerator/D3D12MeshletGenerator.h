@@ -10,49 +10,22 @@
 //*********************************************************
 #pragma once
 
+#ifdef _WIN32
 #include <d3d12.h>
+#else
+// HRESULT and DWORD, DirectX-Headers' adapter for other platforms
+#include <wsl/winadapter.h>
+#endif
 #include <DirectXMath.h>
 #include <vector>
 
+#include "MeshletTypes.h"
+
 enum Flags : uint32_t
 {
     CNORM_WIND_CW = 0x4
 };
 
-struct Subset
-{
-    uint32_t Offset;
-    uint32_t Count;
-};
-
-struct Meshlet
-{
-    uint32_t VertOffset;
-    uint32_t PrimOffset;
-    uint32_t VertCount;
-    uint32_t PrimCount;
-};
-
-union PackedTriangle
-{
-    struct
-    {
-        uint32_t i0 : 10;
-        uint32_t i1 : 10;
-        uint32_t i2 : 10;
-        uint32_t _unused : 2;
-    } indices;
-    uint32_t packed;
-};
-
-struct CullData
-{
-    DirectX::XMFLOAT4 BoundingSphere; // xyz = center, w = radius
-    uint8_t           NormalCone[4];  // xyz = axis, w = sin(a + 90)
-    float             ApexOffset;     // apex = center - axis * offset
-};
-
-
 HRESULT ComputeMeshlets(
     uint32_t maxVerts, uint32_t maxPrims,
     const uint16_t* indices, uint32_t nFaces, 
@@ -14,7 +14,7 @@
 #include <DirectXMath.h>
 
 #include <algorithm>
-#include <unordered_set>
+#include <chrono>
 
 using namespace DirectX;
 
@@ -31,6 +31,28 @@ namespace internal
         std::vector<InlineMeshlet<T>>& output);
 }
 
+namespace
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    thread_local MeshletizeTimings g_timings = {};
+
+    double Seconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+void ResetMeshletizeTimings()
+{
+    g_timings = {};
+}
+
+const MeshletizeTimings& GetMeshletizeTimings()
+{
+    return g_timings;
+}
+
 void Meshletize(
     uint32_t maxVerts, uint32_t maxPrims,
     const uint16_t* indices, uint32_t indexCount,
@@ -55,10 +77,20 @@ void Meshletize(
 ///
 // Helpers
 
-// Sort in reverse order to use vector as a queue with pop_back.
-bool CompareScores(const std::pair<uint32_t, float>& a, const std::pair<uint32_t, float>& b)
+// Relative bounding sphere growth after which all queued candidates are rescored.
+const float FullRescoreGrowth = 1.1f;
+
+struct Candidate
+{
+    uint32_t Index;
+    float    Score;
+    uint32_t Version; // meshlet state the score was computed against
+};
+
+// Heap ordering, keeps the lowest score on top.
+bool CompareScores(const Candidate& a, const Candidate& b)
 {
-    return a.second > b.second;
+    return a.Score > b.Score;
 }
 
 XMVECTOR ComputeNormal(XMFLOAT3* tri)
@@ -73,20 +105,36 @@ XMVECTOR ComputeNormal(XMFLOAT3* tri)
     return XMVector3Normalize(XMVector3Cross(v01, v02));
 }
 
+// Expands a sphere to contain a point, the same step MinimumBoundingSphere applies to each of its points.
+XMVECTOR GrowSphere(FXMVECTOR sphere, FXMVECTOR point)
+{
+    XMVECTOR radius = XMVectorSplatW(sphere);
+    XMVECTOR distSq = XMVector3LengthSq(point - sphere);
+
+    if (!XMVector3Greater(distSq, radius * radius))
+        return sphere;
+
+    XMVECTOR dist = XMVectorSqrt(distSq);
+    XMVECTOR k = (radius / dist) * 0.5f + XMVectorReplicate(0.5f);
+
+    XMVECTOR center = sphere * k + point * (g_XMOne - k);
+    radius = (radius + dist) * 0.5f;
+
+    XMVECTOR select0001 = XMVectorSelectControl(0, 0, 0, 1);
+    return XMVectorSelect(center, radius, select0001);
+}
+
 // Compute number of triangle vertices already exist in the meshlet
 template <typename T>
-uint32_t ComputeReuse(const InlineMeshlet<T>& meshlet, T (&triIndices)[3])
+uint32_t ComputeReuse(const std::vector<uint32_t>& vertexStamps, uint32_t stamp, T (&triIndices)[3])
 {
     uint32_t count = 0;
 
-    for (uint32_t i = 0; i < static_cast<uint32_t>(meshlet.UniqueVertexIndices.size()); ++i)
+    for (uint32_t j = 0; j < 3u; ++j)
     {
-        for (uint32_t j = 0; j < 3u; ++j)
+        if (vertexStamps[triIndices[j]] == stamp)
         {
-            if (meshlet.UniqueVertexIndices[i] == triIndices[j])
-            {
-                ++count;
-            }
+            ++count;
         }
     }
 
@@ -94,15 +142,13 @@ uint32_t ComputeReuse(const InlineMeshlet<T>& meshlet, T (&triIndices)[3])
 }
 
 // Computes a candidacy score based on spatial locality, orientational coherence, and vertex re-use within a meshlet.
-template <typename T>
-float ComputeScore(const InlineMeshlet<T>& meshlet, XMVECTOR sphere, XMVECTOR normal, T (&triIndices)[3], XMFLOAT3* triVerts)
+float ComputeScore(uint32_t reuse, XMVECTOR sphere, XMVECTOR normal, XMFLOAT3* triVerts)
 {
     const float reuseWeight = 0.334f;
     const float locWeight = 0.333f;
     const float oriWeight = 0.333f;
     
     // Vertex reuse
-    uint32_t reuse = ComputeReuse(meshlet, triIndices);
     XMVECTOR reuseScore = g_XMOne - (XMVectorReplicate(float(reuse)) / 3.0f);
 
     // Distance from center point
@@ -201,6 +247,7 @@ void internal::Meshletize(
     std::vector<InlineMeshlet<T>>& output
 )
 {
+    const Clock::time_point totalStart = Clock::now();
     const uint32_t triCount = indexCount / 3;
 
     // Build a primitive adjacency list
@@ -209,6 +256,22 @@ void internal::Meshletize(
 
     BuildAdjacencyList(indices, indexCount, positions, vertexCount, adjacency.data());
 
+    // Triangles touching each vertex, so candidates gaining vertex reuse can be found without a search
+    std::vector<uint32_t> vertexTriOffsets(vertexCount + 1, 0);
+    std::vector<uint32_t> vertexTris(indexCount);
+
+    for (uint32_t i = 0; i < indexCount; ++i)
+        ++vertexTriOffsets[indices[i] + 1];
+    for (uint32_t i = 0; i < vertexCount; ++i)
+        vertexTriOffsets[i + 1] += vertexTriOffsets[i];
+    {
+        std::vector<uint32_t> fill(vertexTriOffsets.begin(), vertexTriOffsets.end() - 1);
+        for (uint32_t i = 0; i < indexCount; ++i)
+            vertexTris[fill[indices[i]]++] = i / 3;
+    }
+
+    g_timings.Adjacency += Seconds(totalStart);
+
     // Rest our outputs
     output.clear();
     output.emplace_back();
@@ -218,150 +281,250 @@ void internal::Meshletize(
     std::vector<bool> checklist;
     checklist.resize(triCount);
 
-    std::vector<XMFLOAT3> m_positions;
-    std::vector<XMFLOAT3> normals;
-    std::vector<std::pair<uint32_t, float>> candidates;
-    std::unordered_set<uint32_t> candidateCheck;
+    // Stamps hold the meshlet a triangle was queued for / a vertex was added to, so nothing is cleared between meshlets.
+    std::vector<uint32_t> candidateStamps(triCount, 0);
+    std::vector<uint32_t> vertexStamps(vertexCount, 0);
+    uint32_t stamp = 1;
+
+    // Version of each candidate's newest heap entry; older entries of the same triangle are skipped when popped.
+    std::vector<uint32_t> scoredAt(triCount, 0);
+    uint32_t version = 0;
 
-    XMVECTOR psphere, normal;
+    std::vector<Candidate> candidates;
+
+    XMVECTOR psphere = g_XMZero;
+    XMVECTOR nsphere = g_XMZero;
+    XMVECTOR normal = g_XMZero;
+    float rescoreRadius = 0.0f;
+
+    auto scoreCandidate = [&](uint32_t candidate)
+    {
+        T triIndices[3] =
+        {
+            indices[candidate * 3],
+            indices[candidate * 3 + 1],
+            indices[candidate * 3 + 2],
+        };
+
+        assert(triIndices[0] < vertexCount);
+        assert(triIndices[1] < vertexCount);
+        assert(triIndices[2] < vertexCount);
+
+        XMFLOAT3 triVerts[3] =
+        {
+            positions[triIndices[0]],
+            positions[triIndices[1]],
+            positions[triIndices[2]],
+        };
+
+        return ComputeScore(ComputeReuse(vertexStamps, stamp, triIndices), psphere, normal, triVerts);
+    };
+
+    auto pushCandidate = [&](uint32_t candidate, float score)
+    {
+        scoredAt[candidate] = version;
+        candidates.push_back({ candidate, score, version });
+        std::push_heap(candidates.begin(), candidates.end(), &CompareScores);
+    };
+
+    auto popCandidate = [&]()
+    {
+        std::pop_heap(candidates.begin(), candidates.end(), &CompareScores);
+        Candidate top = candidates.back();
+        candidates.pop_back();
+        return top;
+    };
+
+    auto isLive = [&](const Candidate& c)
+    {
+        return !checklist[c.Index] && c.Version == scoredAt[c.Index];
+    };
+
+    auto startMeshlet = [&]()
+    {
+        output.emplace_back();
+        curr = &output.back();
+        ++stamp;
+    };
+
+    auto seed = [&](uint32_t index)
+    {
+        candidates.clear();
+        candidateStamps[index] = stamp;
+        pushCandidate(index, 0.0f);
+    };
 
     // Arbitrarily start at triangle zero.
     uint32_t triIndex = 0;
-    candidates.push_back(std::make_pair(triIndex, 0.0f));
-    candidateCheck.insert(triIndex);
-    
+    if (triCount > 0)
+        seed(triIndex);
+
+    double scoringTime = 0.0;
+
     // Continue adding triangles until 
     while (!candidates.empty())
     {
-        uint32_t index = candidates.back().first;
-        candidates.pop_back();
+        Candidate best = popCandidate();
+        bool take = isLive(best);
 
-        T tri[3] =
+        // Scores only go stale through sphere and cone growth, which moves every candidate a little.
+        // Refresh the top one and take it only if it still beats the next best (lazy rescoring).
+        if (take && best.Version != version && !curr->PrimitiveIndices.empty())
         {
-            indices[index * 3],
-            indices[index * 3 + 1],
-            indices[index * 3 + 2],
-        };
+            const Clock::time_point scoringStart = Clock::now();
+            best.Score = scoreCandidate(best.Index);
+            scoringTime += Seconds(scoringStart);
+            ++g_timings.Rescored;
 
-        assert(tri[0] < vertexCount);
-        assert(tri[1] < vertexCount);
-        assert(tri[2] < vertexCount);
+            if (!candidates.empty() && best.Score > candidates.front().Score)
+            {
+                pushCandidate(best.Index, best.Score);
+                take = false;
+            }
+        }
 
-        // Try to add triangle to meshlet
-        if (AddToMeshlet(maxVerts, maxPrims, *curr, tri))
+        if (take)
         {
-            // Success! Mark as added.
-            checklist[index] = true;
+            uint32_t index = best.Index;
 
-            // Add m_positions & normal to list
-            XMFLOAT3 points[3] =
+            T tri[3] =
             {
-                positions[tri[0]],
-                positions[tri[1]],
-                positions[tri[2]],
+                indices[index * 3],
+                indices[index * 3 + 1],
+                indices[index * 3 + 2],
             };
 
-            m_positions.push_back(points[0]);
-            m_positions.push_back(points[1]);
-            m_positions.push_back(points[2]);
+            assert(tri[0] < vertexCount);
+            assert(tri[1] < vertexCount);
+            assert(tri[2] < vertexCount);
 
-            XMFLOAT3 Normal;
-            XMStoreFloat3(&Normal, ComputeNormal(points));
-            normals.push_back(Normal);
+            const bool first = curr->PrimitiveIndices.empty();
 
-            // Compute new bounding sphere & normal axis
-            psphere = MinimumBoundingSphere(m_positions.data(), static_cast<uint32_t>(m_positions.size()));
-            
-            XMVECTOR nsphere = MinimumBoundingSphere(normals.data(), static_cast<uint32_t>(normals.size()));
-            normal = XMVector3Normalize(nsphere);
+            // Try to add triangle to meshlet
+            if (AddToMeshlet(maxVerts, maxPrims, *curr, tri))
+            {
+                // Success! Mark as added.
+                checklist[index] = true;
+                ++version;
 
-            // Find and add all applicable adjacent triangles to candidate list
-            const uint32_t adjIndex = index * 3;
+                XMFLOAT3 points[3] =
+                {
+                    positions[tri[0]],
+                    positions[tri[1]],
+                    positions[tri[2]],
+                };
 
-            uint32_t adj[3] =
-            {
-                adjacency[adjIndex],
-                adjacency[adjIndex + 1],
-                adjacency[adjIndex + 2],
-            };
+                XMFLOAT3 Normal;
+                XMStoreFloat3(&Normal, ComputeNormal(points));
 
-            for (uint32_t i = 0; i < 3u; ++i)
-            {
-                // Invalid triangle in adjacency slot
-                if (adj[i] == -1)
-                    continue;
-                
-                // Already processed triangle
-                if (checklist[adj[i]])
-                    continue;
-
-                // Triangle already in the candidate list
-                if (candidateCheck.count(adj[i]))
-                    continue;
-
-                candidates.push_back(std::make_pair(adj[i], FLT_MAX));
-                candidateCheck.insert(adj[i]);
-            }
+                // Grow bounding sphere & normal axis with just the new triangle
+                if (first)
+                {
+                    psphere = MinimumBoundingSphere(points, 3);
+                    nsphere = MinimumBoundingSphere(&Normal, 1);
+                }
+                else
+                {
+                    for (uint32_t i = 0; i < 3u; ++i)
+                        psphere = GrowSphere(psphere, XMLoadFloat3(&points[i]));
+                    nsphere = GrowSphere(nsphere, XMLoadFloat3(&Normal));
+                }
+                normal = XMVector3Normalize(nsphere);
 
-            // Re-score remaining candidate triangles
-            for (uint32_t i = 0; i < static_cast<uint32_t>(candidates.size()); ++i)
-            {
-                uint32_t candidate = candidates[i].first;
+                const Clock::time_point scoringStart = Clock::now();
 
-                T triIndices[3] =
+                // Candidates sharing a new vertex gained reuse, rescore them now since their scores only improved
+                for (uint32_t i = 0; i < 3u; ++i)
                 {
-                    indices[candidate * 3],
-                    indices[candidate * 3 + 1],
-                    indices[candidate * 3 + 2],
-                };
+                    if (vertexStamps[tri[i]] == stamp)
+                        continue;
+                    vertexStamps[tri[i]] = stamp;
+
+                    for (uint32_t j = vertexTriOffsets[tri[i]]; j < vertexTriOffsets[tri[i] + 1]; ++j)
+                    {
+                        uint32_t candidate = vertexTris[j];
+                        if (checklist[candidate] || candidateStamps[candidate] != stamp || scoredAt[candidate] == version)
+                            continue;
+
+                        pushCandidate(candidate, scoreCandidate(candidate));
+                    }
+                }
 
-                assert(triIndices[0] < vertexCount);
-                assert(triIndices[1] < vertexCount);
-                assert(triIndices[2] < vertexCount);
+                // Find and add all applicable adjacent triangles to candidate list
+                const uint32_t adjIndex = index * 3;
 
-                XMFLOAT3 triVerts[3] =
+                uint32_t adj[3] =
                 {
-                    positions[triIndices[0]],
-                    positions[triIndices[1]],
-                    positions[triIndices[2]],
+                    adjacency[adjIndex],
+                    adjacency[adjIndex + 1],
+                    adjacency[adjIndex + 2],
                 };
 
-                candidates[i].second = ComputeScore(*curr, psphere, normal, triIndices, triVerts);
-            }
-
-            // Determine whether we need to move to the next meshlet.
-            if (IsMeshletFull(maxVerts, maxPrims, *curr))
-            {
-                m_positions.clear();
-                normals.clear();
-                candidateCheck.clear();
+                for (uint32_t i = 0; i < 3u; ++i)
+                {
+                    // Invalid triangle in adjacency slot
+                    if (adj[i] == -1)
+                        continue;
+                    
+                    // Already processed triangle
+                    if (checklist[adj[i]])
+                        continue;
+
+                    // Triangle already in the candidate list
+                    if (candidateStamps[adj[i]] == stamp)
+                        continue;
+
+                    candidateStamps[adj[i]] = stamp;
+                    pushCandidate(adj[i], scoreCandidate(adj[i]));
+                }
 
-                // Use one of our existing candidates as the next meshlet seed.
-                if (!candidates.empty())
+                // Sphere growth lowers most location scores at once, which lazy rescoring alone would miss.
+                // Rescore the whole queue whenever the radius grew noticeably since the last full pass.
+                const float radius = XMVectorGetW(psphere);
+                if (first)
                 {
-                    candidates[0] = candidates.back();
-                    candidates.resize(1);
-                    candidateCheck.insert(candidates[0].first);
+                    rescoreRadius = radius;
+                }
+                else if (radius > rescoreRadius * FullRescoreGrowth)
+                {
+                    rescoreRadius = radius;
+
+                    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](const Candidate& c) { return !isLive(c); }), candidates.end());
+                    for (auto& c : candidates)
+                    {
+                        c.Score = scoreCandidate(c.Index);
+                        c.Version = version;
+                        scoredAt[c.Index] = version;
+                    }
+                    std::make_heap(candidates.begin(), candidates.end(), &CompareScores);
+
+                    g_timings.Rescored += static_cast<uint32_t>(candidates.size());
                 }
 
-                output.emplace_back();
-                curr = &output.back();
-            }
-            else
-            {
-                std::sort(candidates.begin(), candidates.end(), &CompareScores);
+                scoringTime += Seconds(scoringStart);
+
+                // Determine whether we need to move to the next meshlet.
+                if (IsMeshletFull(maxVerts, maxPrims, *curr))
+                {
+                    // Use the best remaining candidate as the next meshlet seed.
+                    uint32_t next = uint32_t(-1);
+                    while (!candidates.empty() && next == uint32_t(-1))
+                    {
+                        Candidate c = popCandidate();
+                        if (isLive(c))
+                            next = c.Index;
+                    }
+
+                    startMeshlet();
+                    if (next != uint32_t(-1))
+                        seed(next);
+                    else
+                        candidates.clear();
+                }
             }
-        }
-        else
-        {
-            if (candidates.empty())
+            else if (candidates.empty())
             {
-                m_positions.clear();
-                normals.clear();
-                candidateCheck.clear();
-
-                output.emplace_back();
-                curr = &output.back();
+                startMeshlet();
             }
         }
 
@@ -374,8 +537,7 @@ void internal::Meshletize(
             if (triIndex == triCount)
                 break;
 
-            candidates.push_back(std::make_pair(triIndex, 0.0f));
-            candidateCheck.insert(triIndex);
+            seed(triIndex);
         }
     }
 
@@ -384,4 +546,8 @@ void internal::Meshletize(
     {
         output.pop_back();
     }
+
+    const double total = Seconds(totalStart);
+    g_timings.Scoring += scoringTime;
+    g_timings.Total += total;
 }
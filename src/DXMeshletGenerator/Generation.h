@@ -30,6 +30,18 @@ struct InlineMeshlet
     std::vector<T>              UniqueVertexIndices;
     std::vector<PackedTriangle> PrimitiveIndices;
 };
+
+// Wall clock breakdown of Meshletize, accumulated per thread across calls until reset. Times are in seconds.
+struct MeshletizeTimings
+{
+    double   Adjacency; // edge and vertex-triangle adjacency
+    double   Scoring;   // candidate scoring, including lazy rescoring
+    double   Total;
+    uint32_t Rescored;  // stale candidates rescored when they reached the top of the queue
+};
+
+void ResetMeshletizeTimings();
+const MeshletizeTimings& GetMeshletizeTimings();
     
 void Meshletize(
     uint32_t maxVerts, uint32_t maxPrims,
@@ -0,0 +1,66 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+
+#include "utils/maths.h"
+
+// Meshlet data shared by the meshletizers and the CPU modules, no D3D12 or DirectXMath dependencies
+
+struct Subset
+{
+    uint32_t Offset;
+    uint32_t Count;
+};
+
+struct Meshlet
+{
+    uint32_t VertOffset;
+    uint32_t PrimOffset;
+    uint32_t VertCount;
+    uint32_t PrimCount;
+};
+
+union PackedTriangle
+{
+    struct
+    {
+        uint32_t i0 : 10;
+        uint32_t i1 : 10;
+        uint32_t i2 : 10;
+        uint32_t _unused : 2;
+    } indices;
+    uint32_t packed;
+};
+
+struct CullData
+{
+    hlsl::float4 BoundingSphere; // xyz = center, w = radius
+    uint8_t      NormalCone[4];  // xyz = axis, w = sin(a + 90)
+    float        ApexOffset;     // apex = center - axis * offset
+};
+
+namespace olej_utils
+{
+    // Local vertex indices of a meshlet triangle, 8 bits each
+    inline uint32_t packTriangle(uint8_t x, uint8_t y, uint8_t z)
+    {
+        uint32_t packed_triangle =
+            (static_cast<uint32_t>(x) << 0)
+            | (static_cast<uint32_t>(y) << 8)
+            | (static_cast<uint32_t>(z) << 16);
+        return packed_triangle;
+    }
+}
+
+// Uploaded as is, has to match the shader side
+static_assert(sizeof(CullData) == 24);
@@ -10,6 +10,7 @@
 //*********************************************************
 #include "Utilities.h"
 
+#include <cstring>
 #include <unordered_map>
 #include <memory>
 
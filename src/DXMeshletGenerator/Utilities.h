@@ -12,6 +12,7 @@
 
 #include <DirectXMath.h>
 
+#include <cstdint>
 #include <vector>
 
 void BuildAdjacencyList(
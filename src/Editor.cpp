@@ -10,6 +10,9 @@
 #include "Keyboard.h"
 #include "Renderer.h"
 #include "Window.h"
+#include "DX12Wrappers/FramePacer.h"
+#include "DX12Wrappers/ParallelRecorder.h"
+#include "ResourceLoaders/ResourceManager.h"
 #include "Tools/GPUProfiler.h"
 #include "Tools/MeshletBenchmark.h"
 
@@ -117,7 +120,7 @@ void Editor::update()
         }
     }
     ImGui::Render();
-    auto cmdlist = Renderer::get_instance()->g_pd3dCommandList;
+    auto cmdlist = Renderer::get_instance()->get_command_list();
     auto hp = Renderer::get_instance()->get_srv_desc_heap();
     cmdlist->SetDescriptorHeaps(1, &hp);
     ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), cmdlist);
@@ -497,6 +500,9 @@ void Editor::drawDebugWindow(EditorWindow* const& window)
     {
         Renderer::get_instance()->set_vsync(vsync);
     }
+    FramePacer::getInstance()->drawEditor();
+    ResourceManager::getInstance()->drawEditor();
+    ParallelRecorder::getInstance()->drawEditor();
 
     Renderer::get_instance()->getDebugDrawer()->drawEditor();
     // TODO: Implement scene saving
@@ -14,13 +14,17 @@
 #include "ResourceLoaders/ResourceManager.h"
 #include "Tools/GPUProfiler.h"
 #include "Tools/MeshletBenchmark.h"
+#include "Tools/PerformanceCounters.h"
+#include "Tools/TimelineRecorder.h"
 
 
 void Engine::setup()
 {
     Window::create();
+    TimelineRecorder::create();
     GPUProfiler::create();
     MeshletBenchmark::create();
+    ResourceManager::create();
     Renderer::create();
     Editor::create();
     Input::create();
@@ -30,7 +34,6 @@ void Engine::setup()
     Renderer::get_instance()->camera_entity->add_component(Camera::getMainCamera());
     Game::init();
     Renderer::get_instance()->initDebugDrawings();
-    ResourceManager::create();
 }
 
 void Engine::run()
@@ -39,12 +42,26 @@ void Engine::run()
     while (run)
     {
         //MainScene::getInstance()->runFrame();
-        Input::getInstance()->update();
-        Renderer::get_instance()->start_frame();
-        Renderer::get_instance()->render();
-        Editor::get_instance()->update();
-        Renderer::get_instance()->end_frame();
-        ResourceManager::getInstance()->deleteScheduled();
+        {
+            TIMELINE_ZONE("Input update");
+            Input::getInstance()->update();
+        }
+        {
+            TIMELINE_ZONE("Render");
+            Renderer::get_instance()->start_frame();
+            Renderer::get_instance()->render();
+        }
+        {
+            TIMELINE_ZONE("Editor update");
+            Editor::get_instance()->update();
+        }
+        {
+            TIMELINE_ZONE("Submit and present");
+            Renderer::get_instance()->end_frame();
+        }
+        GPUProfiler::getInstance()->processFinishedFrames();
+        TimelineRecorder::getInstance()->endFrame();
+        counters::endFrame();
         MSG msg;
 
         // Poll events after running engine to prevent exceptions when closing the window
@@ -62,6 +79,7 @@ void Engine::run()
 
 void Engine::cleanup()
 {
+    counters::stopLog();
     Editor::get_instance()->cleanup();
     Renderer::get_instance()->cleanup();
 }
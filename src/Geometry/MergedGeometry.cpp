@@ -0,0 +1,154 @@
+#include "MergedGeometry.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace geometry
+{
+    namespace
+    {
+        uint32_t unpackCorner(uint32_t packedTriangle, uint32_t corner)
+        {
+            return (packedTriangle >> (corner * 8)) & 0xFF;
+        }
+
+        bool sameVertex(Vertex const& a, Vertex const& b)
+        {
+            return a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z
+                && a.normal.x == b.normal.x && a.normal.y == b.normal.y && a.normal.z == b.normal.z
+                && a.UV.x == b.UV.x && a.UV.y == b.UV.y;
+        }
+    }
+
+    void packMergedGeometry(std::vector<MeshGeometryView> const& meshes, MergedGeometry& merged)
+    {
+        merged = {};
+
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        size_t meshletCount = 0;
+        size_t triangleCount = 0;
+        for (auto const& mesh : meshes)
+        {
+            vertexCount += mesh.vertices->size();
+            indexCount += mesh.indices->size();
+            meshletCount += mesh.meshlets->size();
+            triangleCount += mesh.meshletTriangles->size();
+        }
+        merged.vertices.reserve(vertexCount);
+        merged.indices.reserve(indexCount);
+        merged.meshlets.reserve(meshletCount);
+        merged.meshletTriangles.reserve(triangleCount);
+        merged.cullData.reserve(meshletCount);
+        merged.ranges.reserve(meshes.size());
+
+        for (auto const& mesh : meshes)
+        {
+            MergedMeshRange range;
+            range.vertexOffset = static_cast<uint32_t>(merged.vertices.size());
+            range.indexOffset = static_cast<uint32_t>(merged.indices.size());
+            range.meshletOffset = static_cast<uint32_t>(merged.meshlets.size());
+            range.meshletCount = static_cast<uint32_t>(mesh.meshlets->size());
+            range.triangleOffset = static_cast<uint32_t>(merged.meshletTriangles.size());
+            merged.ranges.push_back(range);
+
+            merged.vertices.insert(merged.vertices.end(), mesh.vertices->begin(), mesh.vertices->end());
+            for (uint32_t index : *mesh.indices)
+            {
+                merged.indices.push_back(index + range.vertexOffset);
+            }
+            for (Meshlet meshlet : *mesh.meshlets)
+            {
+                meshlet.VertOffset += range.indexOffset;
+                meshlet.PrimOffset += range.triangleOffset;
+                merged.meshlets.push_back(meshlet);
+            }
+            // Triangles are local to their meshlet, copied as they are
+            merged.meshletTriangles.insert(merged.meshletTriangles.end(), mesh.meshletTriangles->begin(), mesh.meshletTriangles->end());
+
+            // Meshlet i reads cull data i, meshes without it get zeroed entries to keep both arrays aligned
+            if (mesh.cullData->size() == mesh.meshlets->size())
+                merged.cullData.insert(merged.cullData.end(), mesh.cullData->begin(), mesh.cullData->end());
+            else
+                merged.cullData.resize(merged.meshlets.size(), CullData{});
+        }
+
+        merged.indexBytes = getIndexBytes(merged.vertices.size());
+    }
+
+    bool verifyMergedGeometry(std::vector<MeshGeometryView> const& meshes, MergedGeometry const& merged)
+    {
+        if (merged.ranges.size() != meshes.size() || merged.cullData.size() != merged.meshlets.size())
+            return false;
+
+        for (uint32_t m = 0; m < meshes.size(); m++)
+        {
+            auto const& mesh = meshes[m];
+            auto const& range = merged.ranges[m];
+            if (range.meshletCount != mesh.meshlets->size() || range.meshletOffset + range.meshletCount > merged.meshlets.size())
+                return false;
+
+            for (uint32_t i = 0; i < range.meshletCount; i++)
+            {
+                Meshlet const& source = (*mesh.meshlets)[i];
+                Meshlet const& packed = merged.meshlets[range.meshletOffset + i];
+                if (source.VertCount != packed.VertCount || source.PrimCount != packed.PrimCount)
+                    return false;
+                if (packed.VertOffset + packed.VertCount > merged.indices.size() || packed.PrimOffset + packed.PrimCount > merged.meshletTriangles.size())
+                    return false;
+
+                for (uint32_t p = 0; p < source.PrimCount; p++)
+                {
+                    uint32_t const sourceTriangle = (*mesh.meshletTriangles)[source.PrimOffset + p];
+                    uint32_t const packedTriangle = merged.meshletTriangles[packed.PrimOffset + p];
+                    for (uint32_t corner = 0; corner < 3; corner++)
+                    {
+                        uint32_t const sourceVertex = (*mesh.indices)[source.VertOffset + unpackCorner(sourceTriangle, corner)];
+                        uint32_t const packedVertex = merged.indices[packed.VertOffset + unpackCorner(packedTriangle, corner)];
+                        if (packedVertex >= merged.vertices.size() || !sameVertex((*mesh.vertices)[sourceVertex], merged.vertices[packedVertex]))
+                            return false;
+                    }
+                }
+
+                if (mesh.cullData->size() == mesh.meshlets->size()
+                    && std::memcmp(&(*mesh.cullData)[i], &merged.cullData[range.meshletOffset + i], sizeof(CullData)) != 0)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    void coalesceRanges(std::vector<MeshSubset>& ranges, uint32_t maxMeshlets)
+    {
+        std::erase_if(ranges, [](MeshSubset const& range) { return range.size == 0; });
+        std::sort(ranges.begin(), ranges.end(), [](MeshSubset const& a, MeshSubset const& b) { return a.offset < b.offset; });
+
+        // Join in place, then split from the back so splitting doesn't shift ranges still to be visited
+        uint32_t joined = 0;
+        for (uint32_t i = 0; i < ranges.size(); i++)
+        {
+            if (joined > 0 && ranges[joined - 1].offset + ranges[joined - 1].size == ranges[i].offset)
+                ranges[joined - 1].size += ranges[i].size;
+            else
+                ranges[joined++] = ranges[i];
+        }
+        ranges.resize(joined);
+
+        for (uint32_t i = joined; i-- > 0;)
+        {
+            MeshSubset const range = ranges[i];
+            if (range.size <= maxMeshlets)
+                continue;
+
+            uint32_t const pieces = (range.size + maxMeshlets - 1) / maxMeshlets;
+            ranges[i].size = maxMeshlets;
+            std::vector<MeshSubset> rest;
+            for (uint32_t p = 1; p < pieces; p++)
+            {
+                uint32_t const offset = p * maxMeshlets;
+                rest.push_back({ range.offset + offset, std::min(maxMeshlets, range.size - offset) });
+            }
+            ranges.insert(ranges.begin() + i + 1, rest.begin(), rest.end());
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "DX12Wrappers/Vertex.h"
+#include "DXMeshletGenerator/MeshletTypes.h"
+#include "MeshletStructs.h"
+
+/*
+ * All meshes of a model packed into one set of vertex, index, meshlet, triangle and cull data buffers.
+ * Offsets are rebased while packing, so the mesh shader reads merged buffers exactly like a single mesh's
+ * and a run of neighbouring meshes draws with one binding set and one dispatch.
+ * No engine dependencies, the packed layout can be checked against the per mesh one on the CPU.
+ */
+namespace geometry
+{
+    // Per mesh buffers, same layout Mesh keeps and uploads
+    struct MeshGeometryView
+    {
+        const std::vector<Vertex>* vertices;
+        const std::vector<uint32_t>* indices;          // meshlet local vertex -> mesh vertex, Meshlet::VertOffset indexes it
+        const std::vector<Meshlet>* meshlets;
+        const std::vector<uint32_t>* meshletTriangles; // packed local triangles, Meshlet::PrimOffset indexes it
+        const std::vector<CullData>* cullData;         // one per meshlet, may be empty
+    };
+
+    // Where one source mesh landed in the merged buffers
+    struct MergedMeshRange
+    {
+        uint32_t vertexOffset;
+        uint32_t indexOffset;
+        uint32_t meshletOffset;
+        uint32_t meshletCount;
+        uint32_t triangleOffset;
+    };
+
+    struct MergedGeometry
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices; // rebased to merged vertices, narrowed on upload when indexBytes is 2
+        std::vector<Meshlet> meshlets; // VertOffset and PrimOffset rebased to merged indices and triangles
+        std::vector<uint32_t> meshletTriangles;
+        std::vector<CullData> cullData;
+        std::vector<MergedMeshRange> ranges; // in input order
+        // For the whole model, see getIndexBytes()
+        uint32_t indexBytes = sizeof(uint32_t);
+    };
+
+    void packMergedGeometry(std::vector<MeshGeometryView> const& meshes, MergedGeometry& merged);
+
+    /*
+     * Resolves every triangle corner of every meshlet through both layouts and compares the vertices they end at,
+     * plus cull data per meshlet. Returns false on the first mismatch.
+     */
+    bool verifyMergedGeometry(std::vector<MeshGeometryView> const& meshes, MergedGeometry const& merged);
+
+    /*
+     * Sorts meshlet ranges, joins the ones that touch and splits the result so no range is longer than maxMeshlets.
+     * Neighbouring meshes packed next to each other end up as a single dispatch.
+     */
+    void coalesceRanges(std::vector<MeshSubset>& ranges, uint32_t maxMeshlets);
+}
@@ -108,14 +108,20 @@ namespace meshletizers::greedy
         std::vector<uint32_t>& uniqueVertexIndices,
         std::vector<uint32_t>& packedPrimitiveIndices)
     {
-        std::unordered_map<uint32_t, MeshletizerVertex*> indexVertexMap;
-        std::vector<Triangle*> triangles;
-        std::vector<MeshletizerVertex*> vertexVector;
-
-        generateMeshGraph(&indexVertexMap, &triangles, indices, vertices);
-        sortVertices(vertices, indexVertexMap, triangles, vertexVector);
+        MeshGraph graph;
+        graph.build(indices, vertices);
+        meshletize(maxVerts, maxPrims, graph, meshlets, uniqueVertexIndices, packedPrimitiveIndices);
+    }
 
-        generateMeshlets(vertexVector, meshlets, maxVerts, maxPrims, uniqueVertexIndices, packedPrimitiveIndices, indexVertexMap);
+    void meshletize(
+        uint32_t maxVerts, uint32_t maxPrims,
+        MeshGraph& graph,
+        std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& uniqueVertexIndices,
+        std::vector<uint32_t>& packedPrimitiveIndices)
+    {
+        graph.resetTriangleState();
+        generateMeshlets(graph.sortedVertices, meshlets, maxVerts, maxPrims, uniqueVertexIndices, packedPrimitiveIndices, graph.indexVertexMap);
     }
 
 }
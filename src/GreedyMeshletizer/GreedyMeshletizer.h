@@ -2,8 +2,7 @@
 
 #include <cstdint>
 
-#include "DirectXMesh.h"
-#include "DXMeshletGenerator/D3D12MeshletGenerator.h"
+#include "DXMeshletGenerator/MeshletTypes.h"
 #include "meshletizerCommon.h"
 
 
@@ -30,5 +29,13 @@ namespace meshletizers::greedy
         std::vector<uint32_t>& uniqueVertexIndices,
         std::vector<uint32_t>& packedPrimitiveIndices);
 
+    // Partitions a prebuilt graph, lets callers keep the graph between runs with different limits
+    void meshletize(
+        uint32_t maxVerts, uint32_t maxPrims,
+        MeshGraph& graph,
+        std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& uniqueVertexIndices,
+        std::vector<uint32_t>& packedPrimitiveIndices);
+
 
 }
@@ -1,5 +1,6 @@
 #include "boundingSphereMeshletizer.h"
 
+#include <algorithm>
 #include <queue>
 #include <unordered_set>
 
@@ -49,12 +50,16 @@ namespace meshletizers::boundingSphere
         std::vector<Vertex>& vertices, std::vector<Meshlet>& meshlets, std::vector<uint32_t>& uniqueVertexIndices,
         std::vector<uint32_t>& packedPrimitiveIndices)
     {
-        std::unordered_map<uint32_t, MeshletizerVertex*> indexVertexMap;
-        std::vector<Triangle*> triangles;
-        std::vector<MeshletizerVertex*> vertexVector;
-        generateMeshGraph(&indexVertexMap, &triangles, indices, vertices);
-        sortVertices(vertices, indexVertexMap, triangles, vertexVector);
-        generateMeshlets(vertexVector, triangles, maxVerts, maxPrims, meshlets, uniqueVertexIndices, packedPrimitiveIndices, indexVertexMap);
+        MeshGraph graph;
+        graph.build(indices, vertices);
+        meshletize(maxVerts, maxPrims, graph, meshlets, uniqueVertexIndices, packedPrimitiveIndices);
+    }
+
+    void meshletize(uint32_t maxVerts, uint32_t maxPrims, MeshGraph& graph, std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& uniqueVertexIndices, std::vector<uint32_t>& packedPrimitiveIndices)
+    {
+        graph.resetTriangleState();
+        generateMeshlets(graph.sortedVertices, graph.triangles, maxVerts, maxPrims, meshlets, uniqueVertexIndices, packedPrimitiveIndices, graph.indexVertexMap);
     }
 
     void generateMeshlets(const std::vector<MeshletizerVertex*>& vertsVector, const std::vector<Triangle*>& triangles,
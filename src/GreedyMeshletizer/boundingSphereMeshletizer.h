@@ -34,5 +34,9 @@ namespace meshletizers::boundingSphere
         std::vector<Vertex>& vertices, std::vector<Meshlet>& meshlets, std::vector<uint32_t>& uniqueVertexIndices,
         std::vector<uint32_t>& packedPrimitiveIndices);
 
+    // Partitions a prebuilt graph, lets callers keep the graph between runs with different limits
+    void meshletize(uint32_t maxVerts, uint32_t maxPrims, MeshGraph& graph, std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& uniqueVertexIndices, std::vector<uint32_t>& packedPrimitiveIndices);
+
 
 }
\ No newline at end of file
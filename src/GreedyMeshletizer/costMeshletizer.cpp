@@ -0,0 +1,228 @@
+#include "costMeshletizer.h"
+
+#include <cfloat>
+
+
+namespace meshletizers::cost
+{
+    namespace
+    {
+        struct MeshletState
+        {
+            hlsl::float3 center;
+            float radius;
+            hlsl::float3 normalSum;
+        };
+
+        // Ritter style growth, cheap and never shrinks
+        void growSphere(hlsl::float3& center, float& radius, const hlsl::float3& point)
+        {
+            const hlsl::float3 offset = point - center;
+            const float distance = hlsl::length(offset);
+            if (distance <= radius)
+                return;
+
+            const float newRadius = 0.5f * (radius + distance);
+            center = center + offset * ((newRadius - radius) / distance);
+            radius = newRadius;
+        }
+    }
+
+    void meshletize(
+        uint32_t maxVerts, uint32_t maxPrims,
+        const MeshletCostWeights& weights,
+        std::vector<uint32_t>& indices,
+        std::vector<Vertex>& vertices,
+        std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& uniqueVertexIndices,
+        std::vector<uint32_t>& packedPrimitiveIndices)
+    {
+        nvidia::AdjacencyInfo adjacency;
+        nvidia::buildAdjacency(static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(indices.size()), indices, adjacency);
+        meshletize(maxVerts, maxPrims, weights, adjacency, indices, vertices, meshlets, uniqueVertexIndices, packedPrimitiveIndices);
+    }
+
+    void meshletize(
+        uint32_t maxVerts, uint32_t maxPrims,
+        const MeshletCostWeights& weights,
+        const nvidia::AdjacencyInfo& adjacency,
+        const std::vector<uint32_t>& indices,
+        const std::vector<Vertex>& vertices,
+        std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& uniqueVertexIndices,
+        std::vector<uint32_t>& packedPrimitiveIndices)
+    {
+        const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+        std::vector<hlsl::float3> normals(triangleCount);
+        std::vector<hlsl::float3> centroids(triangleCount);
+        float totalEdgeLength = 0.0f;
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            const hlsl::float3 a = vertices[indices[t * 3 + 0]].position;
+            const hlsl::float3 b = vertices[indices[t * 3 + 1]].position;
+            const hlsl::float3 c = vertices[indices[t * 3 + 2]].position;
+            normals[t] = hlsl::normalizeSafe(hlsl::cross(b - a, c - a));
+            centroids[t] = (a + b + c) / 3.0f;
+            totalEdgeLength += hlsl::length(b - a) + hlsl::length(c - b) + hlsl::length(a - c);
+        }
+
+        // Sphere growth is measured against this so tiny meshlets aren't punished for their first triangles
+        const float minRadius = std::max(FLT_EPSILON, totalEdgeLength / (3.0f * std::max(triangleCount, 1u)));
+
+        std::vector<uint8_t> used(triangleCount, 0);
+        // meshlet index + 1 a vertex/triangle was last seen in, avoids clearing per meshlet
+        std::vector<uint32_t> vertexStamp(vertexCount, 0);
+        std::vector<uint32_t> candidateStamp(triangleCount, 0);
+        std::vector<uint32_t> candidates;
+
+        PrimitiveCache cache(maxVerts, maxPrims);
+        cache.reset();
+        MeshletState state = {};
+        uint32_t stamp = 1;
+        uint32_t cursor = 0;
+
+        auto addCandidates = [&](uint32_t vertex)
+        {
+            const uint32_t begin = adjacency.indexBufferOffset[vertex];
+            const uint32_t end = begin + adjacency.trianglesPerVertex[vertex];
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const uint32_t triangle = adjacency.triangleData[i];
+                if (used[triangle] || candidateStamp[triangle] == stamp)
+                    continue;
+                candidateStamp[triangle] = stamp;
+                candidates.push_back(triangle);
+            }
+        };
+
+        auto insertTriangle = [&](uint32_t triangle)
+        {
+            const uint32_t* triangleIndices = &indices[triangle * 3];
+            used[triangle] = 1;
+
+            // degenerate triangles are dropped by the cache, don't let them seed anything
+            if (triangleIndices[0] == triangleIndices[1] || triangleIndices[0] == triangleIndices[2] || triangleIndices[1] == triangleIndices[2])
+                return;
+
+            if (cache.empty())
+            {
+                state.center = centroids[triangle];
+                state.radius = 0.0f;
+                state.normalSum = hlsl::float3(0.0f, 0.0f, 0.0f);
+            }
+
+            cache.insert(triangleIndices);
+            state.normalSum = state.normalSum + normals[triangle];
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                growSphere(state.center, state.radius, vertices[triangleIndices[i]].position);
+                if (vertexStamp[triangleIndices[i]] != stamp)
+                {
+                    vertexStamp[triangleIndices[i]] = stamp;
+                    addCandidates(triangleIndices[i]);
+                }
+            }
+        };
+
+        auto flushMeshlet = [&]()
+        {
+            addMeshlet(meshlets, uniqueVertexIndices, packedPrimitiveIndices, cache);
+            cache.reset();
+            stamp++;
+
+            // unused border triangles of the finished meshlet seed the next one, keeps meshlets spatially coherent
+            uint32_t seed = UINT32_MAX;
+            for (uint32_t triangle : candidates)
+            {
+                if (!used[triangle])
+                {
+                    seed = triangle;
+                    break;
+                }
+            }
+            candidates.clear();
+            return seed;
+        };
+
+        uint32_t seed = UINT32_MAX;
+        for (;;)
+        {
+            if (cache.empty())
+            {
+                if (seed == UINT32_MAX)
+                {
+                    while (cursor < triangleCount && used[cursor])
+                        cursor++;
+                    if (cursor == triangleCount)
+                        break;
+                    seed = cursor;
+                }
+                insertTriangle(seed);
+                seed = UINT32_MAX;
+                continue;
+            }
+
+            const hlsl::float3 axis = hlsl::normalizeSafe(state.normalSum);
+            const float radiusScale = 1.0f / std::max(state.radius, minRadius);
+
+            uint32_t best = UINT32_MAX;
+            float bestCost = FLT_MAX;
+            for (uint32_t i = 0; i < candidates.size();)
+            {
+                const uint32_t triangle = candidates[i];
+                if (used[triangle])
+                {
+                    candidates[i] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                i++;
+
+                const uint32_t* triangleIndices = &indices[triangle * 3];
+                uint32_t newVertices = 0;
+                for (uint32_t v = 0; v < 3; v++)
+                {
+                    if (vertexStamp[triangleIndices[v]] != stamp)
+                        newVertices++;
+                }
+
+                // stamps already tell us what's in the meshlet, no need to search the cache
+                if (cache.numVertices + newVertices > maxVerts || cache.numPrimitives + 1 > maxPrims)
+                    continue;
+
+                hlsl::float3 center = state.center;
+                float radius = state.radius;
+                for (uint32_t v = 0; v < 3; v++)
+                {
+                    growSphere(center, radius, vertices[triangleIndices[v]].position);
+                }
+
+                const float cost =
+                    weights.newVertices * (newVertices / 3.0f) +
+                    weights.sphereGrowth * ((radius - state.radius) * radiusScale) +
+                    weights.coneSpread * (0.5f * (1.0f - dot(axis, normals[triangle])));
+
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    best = triangle;
+                }
+            }
+
+            if (best == UINT32_MAX)
+            {
+                seed = flushMeshlet();
+                continue;
+            }
+
+            insertTriangle(best);
+        }
+
+        if (!cache.empty())
+        {
+            flushMeshlet();
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "meshletizerCommon.h"
+#include "nvMeshletizer.h"
+#include "MeshletStructs.h"
+
+namespace meshletizers::cost
+{
+    /*
+     * Grows meshlets one triangle at a time, always taking the border triangle with the lowest
+     * weighted cost of new vertices, bounding sphere growth and normal cone spread.
+     * All terms are normalized to roughly [0, 1], so weights are directly comparable.
+     */
+    void meshletize(
+        uint32_t maxVerts, uint32_t maxPrims,
+        const MeshletCostWeights& weights,
+        std::vector<uint32_t>& indices,
+        std::vector<Vertex>& vertices,
+        std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& uniqueVertexIndices,
+        std::vector<uint32_t>& packedPrimitiveIndices);
+
+    // Same as above with vertex -> triangle adjacency of indices built by the caller, see nvidia::buildAdjacency()
+    void meshletize(
+        uint32_t maxVerts, uint32_t maxPrims,
+        const MeshletCostWeights& weights,
+        const nvidia::AdjacencyInfo& adjacency,
+        const std::vector<uint32_t>& indices,
+        const std::vector<Vertex>& vertices,
+        std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& uniqueVertexIndices,
+        std::vector<uint32_t>& packedPrimitiveIndices);
+}
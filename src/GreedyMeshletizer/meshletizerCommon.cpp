@@ -1,11 +1,9 @@
 #include "meshletizerCommon.h"
 
+#include <algorithm>
 #include <iostream>
 
-#include "Mesh.h"
-
-
-#include "utils/Utils.h"
+#include "DXMeshletGenerator/MeshletTypes.h"
 
 namespace meshletizers
 {
@@ -265,4 +263,35 @@ namespace meshletizers
             std::cout << "Sorted by Z axis" << std::endl;
         }
     }
+
+    void MeshGraph::build(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices)
+    {
+        clear();
+        generateMeshGraph(&indexVertexMap, &triangles, indices, vertices);
+        sortVertices(vertices, indexVertexMap, triangles, sortedVertices);
+    }
+
+    void MeshGraph::resetTriangleState()
+    {
+        for (Triangle* triangle : triangles)
+        {
+            triangle->usedFlag = 0;
+        }
+    }
+
+    void MeshGraph::clear()
+    {
+        for (Triangle* triangle : triangles)
+        {
+            delete triangle;
+        }
+        // sortVertices() can leave null entries for unreferenced vertices
+        for (auto& [index, vertex] : indexVertexMap)
+        {
+            delete vertex;
+        }
+        triangles.clear();
+        indexVertexMap.clear();
+        sortedVertices.clear();
+    }
 }
\ No newline at end of file
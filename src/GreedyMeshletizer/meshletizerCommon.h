@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <unordered_map>
 
 #include "utils/maths.h"
@@ -52,6 +53,28 @@ namespace meshletizers
         unsigned int degree;
     };
 
+    /*
+     * Triangle/vertex graph plus the axis sorted vertex order GREEDY and BSPHERE walk.
+     * Partitioning only flips Triangle::usedFlag, so one graph can be partitioned any number of times.
+     */
+    struct MeshGraph
+    {
+        std::unordered_map<uint32_t, MeshletizerVertex*> indexVertexMap;
+        std::vector<Triangle*> triangles;
+        std::vector<MeshletizerVertex*> sortedVertices;
+
+        bool empty() const { return triangles.empty(); }
+        void build(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices);
+        // Marks every triangle unused again, has to run before each partition
+        void resetTriangleState();
+        void clear();
+
+        MeshGraph() = default;
+        MeshGraph(const MeshGraph&) = delete;
+        MeshGraph& operator=(const MeshGraph&) = delete;
+        ~MeshGraph() { clear(); }
+    };
+
     void addMeshlet(
         std::vector<Meshlet>& meshlets,
         std::vector<uint32_t>& uniqueVertexIndices,
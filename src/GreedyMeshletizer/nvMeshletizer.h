@@ -1,3 +1,4 @@
+#pragma once
 
 #include "meshletizerCommon.h"
 
@@ -12,11 +13,15 @@ namespace meshletizers::nvidia
     };
 
 
-    void tipsifyIndexBuffer(
-        const std::vector<uint32_t>& indices,
+    /*
+     * Builds flat vertex -> triangle adjacency, triangles of vertex v are
+     * triangleData[indexBufferOffset[v]] ... triangleData[indexBufferOffset[v] + trianglesPerVertex[v] - 1]
+     */
+    void buildAdjacency(
         const uint32_t numVerts,
-        const int cacheSize,
-        std::vector<uint32_t>& optimizedIdxBuffer);
+        const uint32_t numIndices,
+        const std::vector<uint32_t>& indices,
+        AdjacencyInfo& info);
 
     void generateMeshlets(
         const std::vector<MeshletizerVertex*>& vertsVector,
@@ -28,7 +33,8 @@ namespace meshletizers::nvidia
         MeshletizerVertex*>& indexVertexMap);
 
     /*
-     * Greedily meshletizes a mesh
+     * Greedily meshletizes a mesh, triangles are taken in index buffer order
+     * so it should be vertex cache optimized first (see vertexCacheOptimizer.h)
      */
     void meshletize(
         uint32_t maxVerts, uint32_t maxPrims,
@@ -0,0 +1,344 @@
+#include "vertexCacheOptimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "meshoptimizer.h"
+#include "nvMeshletizer.h"
+
+namespace meshletizers::vcache
+{
+    namespace
+    {
+        static const uint32_t INVALID_VERTEX = UINT32_MAX;
+
+        // Forsyth's constants, see https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+        static const float LAST_TRIANGLE_SCORE = 0.75f;
+        static const float CACHE_DECAY_POWER = 1.5f;
+        static const float VALENCE_BOOST_SCALE = 2.0f;
+        static const float VALENCE_BOOST_POWER = 0.5f;
+
+        // Valences above this are rare enough to be scored without the table
+        static const uint32_t FORSYTH_VALENCE_TABLE_SIZE = 64;
+
+        struct ForsythScoreTables
+        {
+            float cachePosition[FORSYTH_CACHE_SIZE];
+            float valence[FORSYTH_VALENCE_TABLE_SIZE];
+
+            ForsythScoreTables()
+            {
+                for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE; i++)
+                {
+                    // vertices of the last triangle are penalized a bit so strips don't just ping-pong
+                    const float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                    cachePosition[i] = i < 3 ? LAST_TRIANGLE_SCORE : std::pow(1.0f - (i - 3) * scaler, CACHE_DECAY_POWER);
+                }
+                for (uint32_t i = 0; i < FORSYTH_VALENCE_TABLE_SIZE; i++)
+                {
+                    valence[i] = valenceScore(i);
+                }
+            }
+
+            static float valenceScore(uint32_t liveTriangles)
+            {
+                return liveTriangles == 0 ? 0.0f : VALENCE_BOOST_SCALE * std::pow(static_cast<float>(liveTriangles), -VALENCE_BOOST_POWER);
+            }
+
+            float vertexScore(int32_t position, uint32_t liveTriangles) const
+            {
+                if (liveTriangles == 0)
+                    return -1.0f;
+
+                const float positionScore = position >= 0 ? cachePosition[position] : 0.0f;
+                return positionScore + (liveTriangles < FORSYTH_VALENCE_TABLE_SIZE ? valence[liveTriangles] : valenceScore(liveTriangles));
+            }
+        };
+    }
+
+    void optimize(VertexCacheOptimizer optimizer, const std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& optimizedIndices)
+    {
+        switch (optimizer)
+        {
+        case VCACHE_TIPSIFY:
+            tipsify(indices, vertexCount, DEFAULT_CACHE_SIZE, optimizedIndices);
+            break;
+        case VCACHE_FORSYTH:
+            forsyth(indices, vertexCount, optimizedIndices);
+            break;
+        case VCACHE_MESHOPT:
+            optimizedIndices.resize(indices.size());
+            meshopt_optimizeVertexCache(optimizedIndices.data(), indices.data(), indices.size(), vertexCount);
+            break;
+        default:
+            optimizedIndices = indices;
+            break;
+        }
+    }
+
+    void tipsify(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>& optimizedIndices)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        optimizedIndices.resize(triangleCount * 3);
+        if (triangleCount == 0)
+            return;
+
+        nvidia::AdjacencyInfo adjacency;
+        nvidia::buildAdjacency(vertexCount, triangleCount * 3, indices, adjacency);
+
+        std::vector<uint32_t> liveTriangles = adjacency.trianglesPerVertex;
+        std::vector<uint32_t> cacheTimeStamps(vertexCount, 0);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+
+        // Every emitted index is pushed once, so this never grows
+        std::vector<uint32_t> deadEndStack(triangleCount * 3);
+        uint32_t deadEndSize = 0;
+
+        uint32_t maxValence = 0;
+        for (uint32_t count : adjacency.trianglesPerVertex)
+            maxValence = std::max(maxValence, count);
+        std::vector<uint32_t> oneRing(maxValence * 3);
+
+        uint32_t written = 0;
+        uint32_t timeStamp = cacheSize + 1;
+        uint32_t cursor = 0;
+        uint32_t fanVertex = indices[0];
+
+        while (fanVertex != INVALID_VERTEX)
+        {
+            uint32_t oneRingSize = 0;
+
+            const uint32_t begin = adjacency.indexBufferOffset[fanVertex];
+            const uint32_t end = begin + adjacency.trianglesPerVertex[fanVertex];
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const uint32_t triangle = adjacency.triangleData[i];
+                if (emitted[triangle])
+                    continue;
+                emitted[triangle] = 1;
+
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    const uint32_t vertex = indices[triangle * 3 + j];
+                    optimizedIndices[written++] = vertex;
+                    deadEndStack[deadEndSize++] = vertex;
+                    oneRing[oneRingSize++] = vertex;
+                    liveTriangles[vertex]--;
+
+                    if (timeStamp - cacheTimeStamps[vertex] > cacheSize)
+                    {
+                        cacheTimeStamps[vertex] = timeStamp++;
+                    }
+                }
+            }
+
+            // Prefer the oldest one-ring vertex that survives in the cache while its fan is emitted
+            uint32_t next = INVALID_VERTEX;
+            int64_t bestPriority = -1;
+            for (uint32_t i = 0; i < oneRingSize; i++)
+            {
+                const uint32_t vertex = oneRing[i];
+                if (liveTriangles[vertex] == 0)
+                    continue;
+
+                int64_t priority = 0;
+                const uint32_t age = timeStamp - cacheTimeStamps[vertex];
+                if (age + 2 * liveTriangles[vertex] <= cacheSize)
+                    priority = age;
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    next = vertex;
+                }
+            }
+
+            // Dead end, back up through recently emitted vertices, then scan for anything left
+            while (next == INVALID_VERTEX && deadEndSize > 0)
+            {
+                const uint32_t vertex = deadEndStack[--deadEndSize];
+                if (liveTriangles[vertex] > 0)
+                    next = vertex;
+            }
+            while (next == INVALID_VERTEX && cursor < vertexCount)
+            {
+                if (liveTriangles[cursor] > 0)
+                    next = cursor;
+                else
+                    cursor++;
+            }
+
+            fanVertex = next;
+        }
+    }
+
+    void forsyth(const std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& optimizedIndices)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        optimizedIndices.resize(triangleCount * 3);
+        if (triangleCount == 0)
+            return;
+
+        nvidia::AdjacencyInfo adjacency;
+        nvidia::buildAdjacency(vertexCount, triangleCount * 3, indices, adjacency);
+
+        // Emitted triangles are swapped past the live end of each vertex's adjacency range
+        std::vector<uint32_t> liveTriangles = adjacency.trianglesPerVertex;
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+
+        static const ForsythScoreTables scores;
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            vertexScores[v] = scores.vertexScore(-1, liveTriangles[v]);
+        }
+
+        // LRU cache, 3 extra slots hold the vertices pushed out by the newest triangle
+        uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+        uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+        uint32_t cacheCount = 0;
+
+        uint32_t written = 0;
+        uint32_t cursor = 0;
+        uint32_t best = 0;
+        bool bestIsValid = true;
+
+        while (written < triangleCount * 3)
+        {
+            if (!bestIsValid)
+            {
+                // Nothing in cache touches a live triangle, continue from the first unemitted one
+                while (emitted[cursor])
+                    cursor++;
+                best = cursor;
+            }
+
+            const uint32_t* triangleIndices = &indices[best * 3];
+            emitted[best] = 1;
+
+            uint32_t newCount = 0;
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                const uint32_t vertex = triangleIndices[i];
+                optimizedIndices[written++] = vertex;
+
+                const uint32_t begin = adjacency.indexBufferOffset[vertex];
+                const uint32_t live = liveTriangles[vertex];
+                for (uint32_t j = begin; j < begin + live; j++)
+                {
+                    if (adjacency.triangleData[j] == best)
+                    {
+                        std::swap(adjacency.triangleData[j], adjacency.triangleData[begin + live - 1]);
+                        break;
+                    }
+                }
+                liveTriangles[vertex]--;
+
+                // degenerate triangles repeat a vertex, it can only take one cache slot
+                if (std::find(newCache, newCache + newCount, vertex) == newCache + newCount)
+                    newCache[newCount++] = vertex;
+            }
+
+            for (uint32_t i = 0; i < cacheCount; i++)
+            {
+                const uint32_t vertex = cache[i];
+                if (vertex != triangleIndices[0] && vertex != triangleIndices[1] && vertex != triangleIndices[2])
+                    newCache[newCount++] = vertex;
+            }
+
+            for (uint32_t i = 0; i < newCount; i++)
+            {
+                const uint32_t vertex = newCache[i];
+                cachePositions[vertex] = i < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+                vertexScores[vertex] = scores.vertexScore(cachePositions[vertex], liveTriangles[vertex]);
+            }
+
+            // Rescore live triangles around the cache and pick the best one for the next step
+            bestIsValid = false;
+            float bestScore = -1.0f;
+            for (uint32_t i = 0; i < newCount; i++)
+            {
+                const uint32_t vertex = newCache[i];
+                const uint32_t begin = adjacency.indexBufferOffset[vertex];
+                for (uint32_t j = begin; j < begin + liveTriangles[vertex]; j++)
+                {
+                    const uint32_t triangle = adjacency.triangleData[j];
+                    const float score =
+                        vertexScores[indices[triangle * 3]] +
+                        vertexScores[indices[triangle * 3 + 1]] +
+                        vertexScores[indices[triangle * 3 + 2]];
+
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        best = triangle;
+                        bestIsValid = true;
+                    }
+                }
+            }
+
+            cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+            std::copy(newCache, newCache + cacheCount, cache);
+        }
+    }
+
+    float computeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        if (triangleCount == 0)
+            return 0.0f;
+
+        std::vector<uint32_t> cacheTimeStamps(vertexCount, 0);
+        uint32_t timeStamp = cacheSize + 1;
+        uint32_t misses = 0;
+
+        for (uint32_t index : indices)
+        {
+            if (timeStamp - cacheTimeStamps[index] > cacheSize)
+            {
+                cacheTimeStamps[index] = timeStamp++;
+                misses++;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(triangleCount);
+    }
+
+    std::vector<OptimizerBenchmark> benchmark(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+    {
+        std::vector<OptimizerBenchmark> results;
+        std::vector<uint32_t> optimizedIndices;
+
+        for (uint32_t i = 0; i < VCACHE_COUNT; i++)
+        {
+            const VertexCacheOptimizer optimizer = static_cast<VertexCacheOptimizer>(i);
+
+            auto const start = std::chrono::high_resolution_clock::now();
+            optimize(optimizer, indices, vertexCount, optimizedIndices);
+            auto const end = std::chrono::high_resolution_clock::now();
+
+            results.push_back({ optimizer, std::chrono::duration<float>(end - start).count(), computeACMR(optimizedIndices, vertexCount) });
+        }
+
+        return results;
+    }
+
+    const char* getName(VertexCacheOptimizer optimizer)
+    {
+        switch (optimizer)
+        {
+        case VCACHE_NONE:
+            return "None";
+        case VCACHE_TIPSIFY:
+            return "Tipsify";
+        case VCACHE_FORSYTH:
+            return "Forsyth";
+        case VCACHE_MESHOPT:
+            return "meshoptimizer";
+        default:
+            return "Unknown";
+        }
+    }
+}
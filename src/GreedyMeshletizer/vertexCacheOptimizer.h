@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MeshletStructs.h"
+
+namespace meshletizers::vcache
+{
+    // FIFO size used by Tipsify and the ACMR metric
+    static const uint32_t DEFAULT_CACHE_SIZE = 32;
+    // LRU size Forsyth's scoring is tuned for
+    static const uint32_t FORSYTH_CACHE_SIZE = 32;
+
+    struct OptimizerBenchmark
+    {
+        VertexCacheOptimizer optimizer;
+        float seconds;
+        float acmr;
+    };
+
+    /*
+     * Reorders triangles for vertex reuse with the given optimizer, output has the same size as indices.
+     * VCACHE_NONE copies the input.
+     */
+    void optimize(
+        VertexCacheOptimizer optimizer,
+        const std::vector<uint32_t>& indices,
+        uint32_t vertexCount,
+        std::vector<uint32_t>& optimizedIndices);
+
+    /*
+     * Tipsify (Sander et al. 2007): fans around the current vertex, then moves to the one-ring vertex
+     * that will still be in a FIFO cache of cacheSize after its remaining triangles are emitted.
+     * All scratch memory is sized up front.
+     */
+    void tipsify(
+        const std::vector<uint32_t>& indices,
+        uint32_t vertexCount,
+        uint32_t cacheSize,
+        std::vector<uint32_t>& optimizedIndices);
+
+    /*
+     * Forsyth's linear-speed optimizer: greedily emits the best scored triangle touching a simulated LRU cache,
+     * scores favour recently used vertices and vertices with few remaining triangles.
+     */
+    void forsyth(
+        const std::vector<uint32_t>& indices,
+        uint32_t vertexCount,
+        std::vector<uint32_t>& optimizedIndices);
+
+    // Average cache misses per triangle for a FIFO cache of cacheSize, 0.5 is the practical optimum for regular meshes
+    float computeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    // Runs every optimizer on the same input and reports runtime and resulting ACMR
+    std::vector<OptimizerBenchmark> benchmark(const std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+    const char* getName(VertexCacheOptimizer optimizer);
+}
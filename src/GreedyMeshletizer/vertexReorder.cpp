@@ -0,0 +1,83 @@
+#include "vertexReorder.h"
+
+#include <algorithm>
+
+#include "DXMeshletGenerator/MeshletTypes.h"
+#include "utils/maths.h"
+
+namespace meshletizers::reorder
+{
+    void reorderVertices(
+        const std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& meshletVertices,
+        uint32_t vertexCount,
+        float duplicationThreshold,
+        std::vector<uint32_t>& sourceVertices)
+    {
+        sourceVertices.clear();
+        sourceVertices.reserve(vertexCount);
+
+        // original vertex -> its first copy in the new buffer
+        std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+
+        for (auto const& meshlet : meshlets)
+        {
+            uint32_t* vertices = meshletVertices.data() + meshlet.VertOffset;
+
+            uint32_t sharedVertices = 0;
+            for (uint32_t i = 0; i < meshlet.VertCount; i++)
+            {
+                if (remap[vertices[i]] != UINT32_MAX)
+                    sharedVertices++;
+            }
+            const bool duplicate = sharedVertices > 0 && sharedVertices <= duplicationThreshold * meshlet.VertCount;
+
+            for (uint32_t i = 0; i < meshlet.VertCount; i++)
+            {
+                const uint32_t source = vertices[i];
+                if (remap[source] != UINT32_MAX && !duplicate)
+                {
+                    vertices[i] = remap[source];
+                    continue;
+                }
+
+                const uint32_t index = static_cast<uint32_t>(sourceVertices.size());
+                sourceVertices.push_back(source);
+                if (remap[source] == UINT32_MAX)
+                    remap[source] = index;
+                vertices[i] = index;
+            }
+        }
+    }
+
+    float computeFetchLocality(const std::vector<Meshlet>& meshlets, const std::vector<uint32_t>& meshletVertices, uint32_t vertexStride)
+    {
+        if (meshlets.empty())
+            return 1.0f;
+
+        std::vector<uint64_t> lines;
+        double locality = 0.0;
+        for (auto const& meshlet : meshlets)
+        {
+            if (meshlet.VertCount == 0)
+            {
+                locality += 1.0;
+                continue;
+            }
+
+            lines.clear();
+            for (uint32_t i = 0; i < meshlet.VertCount; i++)
+            {
+                const uint64_t byteOffset = static_cast<uint64_t>(meshletVertices[meshlet.VertOffset + i]) * vertexStride;
+                lines.push_back(byteOffset / FETCH_LINE_SIZE);
+            }
+            std::sort(lines.begin(), lines.end());
+            const size_t touchedLines = std::unique(lines.begin(), lines.end()) - lines.begin();
+            const uint32_t minimalLines = hlsl::divRoundUp(meshlet.VertCount * vertexStride, FETCH_LINE_SIZE);
+
+            // vertices are attributed to the line they start in, so a packed range can come out slightly above 1
+            locality += std::min(1.0, static_cast<double>(minimalLines) / static_cast<double>(touchedLines));
+        }
+        return static_cast<float>(locality / meshlets.size());
+    }
+}
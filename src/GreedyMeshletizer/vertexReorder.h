@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct Meshlet;
+
+namespace meshletizers::reorder
+{
+    // Granularity used by the locality metric, matches a GPU cache line
+    static const uint32_t FETCH_LINE_SIZE = 128;
+
+    /*
+     * Renumbers vertices in the order meshlets first use them, so every meshlet reads a mostly contiguous range.
+     * Vertices already emitted by an earlier meshlet are duplicated only when they make up at most
+     * duplicationThreshold of the meshlet's vertices, then the whole meshlet ends up contiguous.
+     * meshletVertices is rewritten in place, sourceVertices maps every new vertex to its original index.
+     */
+    void reorderVertices(
+        const std::vector<Meshlet>& meshlets,
+        std::vector<uint32_t>& meshletVertices,
+        uint32_t vertexCount,
+        float duplicationThreshold,
+        std::vector<uint32_t>& sourceVertices);
+
+    /*
+     * Average over meshlets of minimal cache lines needed for its vertices divided by lines actually touched.
+     * 1.0 means every meshlet reads a tightly packed range.
+     */
+    float computeFetchLocality(const std::vector<Meshlet>& meshlets, const std::vector<uint32_t>& meshletVertices, uint32_t vertexStride);
+
+    template <typename T>
+    void remapVertexStream(std::vector<T>& stream, const std::vector<uint32_t>& sourceVertices)
+    {
+        if (stream.empty())
+            return;
+
+        std::vector<T> remapped(sourceVertices.size());
+        for (uint32_t i = 0; i < sourceVertices.size(); i++)
+        {
+            remapped[i] = stream[sourceVertices[i]];
+        }
+        std::swap(stream, remapped);
+    }
+
+    // Undoes remapVertexStream, vertices no meshlet referenced come back default initialized
+    template <typename T>
+    void restoreVertexStream(std::vector<T>& stream, const std::vector<uint32_t>& sourceVertices, uint32_t sourceVertexCount)
+    {
+        if (stream.empty())
+            return;
+
+        std::vector<T> restored(sourceVertexCount);
+        for (uint32_t i = 0; i < sourceVertices.size(); i++)
+        {
+            restored[sourceVertices[i]] = stream[i];
+        }
+        std::swap(stream, restored);
+    }
+}
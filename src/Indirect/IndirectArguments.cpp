@@ -0,0 +1,64 @@
+#include "IndirectArguments.h"
+
+#include <algorithm>
+
+namespace indirect
+{
+    void appendCommands(std::vector<MeshSubset> const& ranges, uint32_t indexBytes, uint32_t meshletsPerGroup, uint32_t instanceCount, IndirectArguments& arguments)
+    {
+        uint32_t const maxMeshlets = meshletsPerGroup * MAX_DISPATCH_GROUPS_PER_DIMENSION;
+        for (auto const& range : ranges)
+        {
+            for (uint32_t offset = 0; offset < range.size; offset += maxMeshlets)
+            {
+                uint32_t const size = std::min(maxMeshlets, range.size - offset);
+                uint32_t const groups = (size + meshletsPerGroup - 1) / meshletsPerGroup;
+                uint32_t const maxInstances = getMaxInstancesPerDispatch(groups);
+
+                for (uint32_t instance = 0; instance < instanceCount; instance += maxInstances)
+                {
+                    MeshInfoRecord info = {};
+                    info.IndexBytes = indexBytes;
+                    info.MeshletOffset = range.offset + offset;
+                    info.MeshletCount = size;
+                    info.InstanceOffset = instance;
+                    arguments.meshInfos.push_back(info);
+
+                    IndirectCommand command = {};
+                    command.dispatch = { groups, std::min(maxInstances, instanceCount - instance), 1 };
+                    arguments.commands.push_back(command);
+                }
+            }
+        }
+    }
+
+    uint32_t compactCommands(std::vector<uint8_t> const& visibility, IndirectArguments& arguments)
+    {
+        uint32_t const count = std::min(arguments.count(), static_cast<uint32_t>(visibility.size()));
+
+        // Running exclusive prefix sum of visibility
+        uint32_t writeIndex = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (visibility[i] == 0)
+                continue;
+
+            // writeIndex <= i, records are only ever moved towards the front
+            arguments.meshInfos[writeIndex] = arguments.meshInfos[i];
+            arguments.commands[writeIndex] = arguments.commands[i];
+            writeIndex++;
+        }
+
+        arguments.meshInfos.resize(writeIndex);
+        arguments.commands.resize(writeIndex);
+        return writeIndex;
+    }
+
+    void patchMeshInfoAddresses(uint64_t baseAddress, uint64_t stride, IndirectArguments& arguments)
+    {
+        for (uint32_t i = 0; i < arguments.count(); i++)
+        {
+            arguments.commands[i].meshInfoAddress = baseAddress + i * stride;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "MeshletStructs.h"
+
+/*
+ * Argument records for ExecuteIndirect, one per mesh instance: MeshInfo constants plus mesh dispatch dimensions.
+ * Built on the CPU for now, the layout and the compaction step are what a culling compute pass would write instead.
+ * No device dependencies, IndirectDispatcher turns the records into a command signature and argument buffer.
+ */
+namespace indirect
+{
+    // Same layout as MeshInfo in shared_cb.h, which can't be included without the Windows compiler.
+    // Padded to a whole constant buffer slice, records are uploaded back to back
+    struct alignas(256) MeshInfoRecord
+    {
+        uint32_t IndexBytes;
+        uint32_t MeshletOffset;
+        uint32_t MeshletCount;
+        uint32_t InstanceOffset;
+    };
+
+    // Same layout as D3D12_DISPATCH_MESH_ARGUMENTS
+    struct DispatchMeshArguments
+    {
+        uint32_t threadGroupCountX;
+        uint32_t threadGroupCountY;
+        uint32_t threadGroupCountZ;
+    };
+
+    // One command signature stride: root CBV address of the record's MeshInfo, then the dispatch
+    struct IndirectCommand
+    {
+        uint64_t meshInfoAddress; // D3D12_GPU_VIRTUAL_ADDRESS
+        DispatchMeshArguments dispatch;
+        uint32_t padding;
+    };
+
+    struct IndirectArguments
+    {
+        std::vector<MeshInfoRecord> meshInfos;       // meshInfos[i] belongs to commands[i]
+        std::vector<IndirectCommand> commands;
+
+        void clear() { meshInfos.clear(); commands.clear(); }
+        uint32_t count() const { return static_cast<uint32_t>(commands.size()); }
+    };
+
+    /*
+     * One record per meshlet range and batch of instances, group Y of every record walks its instances.
+     * Ranges longer than meshletsPerGroup * 65535 are split, instances are batched to stay within 2^22 groups per record.
+     * meshletsPerGroup is 1 when the mesh shader runs alone, a BVH leaf when the AS culls meshlets.
+     */
+    void appendCommands(std::vector<MeshSubset> const& ranges, uint32_t indexBytes, uint32_t meshletsPerGroup, uint32_t instanceCount, IndirectArguments& arguments);
+
+    /*
+     * Stream compaction: keeps the records whose visibility entry is non-zero, in order, and drops the rest.
+     * Every survivor lands at the exclusive prefix sum of visibility before it, the same scatter a compute pass
+     * would do after a scan. Returns the surviving count.
+     */
+    uint32_t compactCommands(std::vector<uint8_t> const& visibility, IndirectArguments& arguments);
+
+    // Points every record at its MeshInfo once meshInfos are copied to GPU memory, stride in bytes
+    void patchMeshInfoAddresses(uint64_t baseAddress, uint64_t stride, IndirectArguments& arguments);
+}
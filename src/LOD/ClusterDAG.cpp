@@ -0,0 +1,366 @@
+#include "ClusterDAG.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+
+#include "meshoptimizer.h"
+#include "Culling/MeshletBVH.h"
+
+namespace lod
+{
+    namespace
+    {
+        // Groups that can't drop at least 15% of their triangles are considered stuck
+        const float MIN_SIMPLIFICATION_RATIO = 0.85f;
+
+        typedef std::vector<std::pair<uint32_t, uint32_t>> ClusterNeighbours; // neighbour, shared vertices
+
+        void gatherTriangles(const ClusterDAG& dag, uint32_t clusterIndex, std::vector<uint32_t>& indices)
+        {
+            const Meshlet& meshlet = dag.clusters[clusterIndex].meshlet;
+            for (uint32_t i = 0; i < meshlet.PrimCount; i++)
+            {
+                const uint32_t packed = dag.triangles[meshlet.PrimOffset + i];
+                indices.push_back(dag.vertexIndices[meshlet.VertOffset + (packed & 0xFF)]);
+                indices.push_back(dag.vertexIndices[meshlet.VertOffset + ((packed >> 8) & 0xFF)]);
+                indices.push_back(dag.vertexIndices[meshlet.VertOffset + ((packed >> 16) & 0xFF)]);
+            }
+        }
+
+        hlsl::float4 computeBounds(const std::vector<uint32_t>& indices, const std::vector<hlsl::float3>& positions)
+        {
+            const meshopt_Bounds bounds = meshopt_computeClusterBounds(indices.data(), indices.size(), &positions[0].x, positions.size(), sizeof(hlsl::float3));
+            return hlsl::float4(bounds.center[0], bounds.center[1], bounds.center[2], bounds.radius);
+        }
+
+        void buildAdjacency(const ClusterDAG& dag, const std::vector<uint32_t>& level, uint32_t vertexCount, std::vector<ClusterNeighbours>& adjacency)
+        {
+            // vertex -> clusters of this level referencing it, stored flat
+            std::vector<uint32_t> offsets(vertexCount + 1, 0);
+            for (uint32_t clusterIndex : level)
+            {
+                const Meshlet& meshlet = dag.clusters[clusterIndex].meshlet;
+                for (uint32_t i = 0; i < meshlet.VertCount; i++)
+                {
+                    offsets[dag.vertexIndices[meshlet.VertOffset + i] + 1]++;
+                }
+            }
+            for (uint32_t i = 0; i < vertexCount; i++)
+            {
+                offsets[i + 1] += offsets[i];
+            }
+
+            std::vector<uint32_t> users(offsets.back());
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (uint32_t i = 0; i < level.size(); i++)
+            {
+                const Meshlet& meshlet = dag.clusters[level[i]].meshlet;
+                for (uint32_t j = 0; j < meshlet.VertCount; j++)
+                {
+                    users[cursor[dag.vertexIndices[meshlet.VertOffset + j]]++] = i;
+                }
+            }
+
+            adjacency.assign(level.size(), {});
+            std::vector<uint32_t> neighbours;
+            for (uint32_t i = 0; i < level.size(); i++)
+            {
+                neighbours.clear();
+                const Meshlet& meshlet = dag.clusters[level[i]].meshlet;
+                for (uint32_t j = 0; j < meshlet.VertCount; j++)
+                {
+                    const uint32_t vertex = dag.vertexIndices[meshlet.VertOffset + j];
+                    for (uint32_t k = offsets[vertex]; k < offsets[vertex + 1]; k++)
+                    {
+                        if (users[k] != i)
+                            neighbours.push_back(users[k]);
+                    }
+                }
+
+                std::sort(neighbours.begin(), neighbours.end());
+                for (uint32_t j = 0; j < neighbours.size();)
+                {
+                    uint32_t k = j;
+                    while (k < neighbours.size() && neighbours[k] == neighbours[j])
+                        k++;
+                    adjacency[i].push_back({ neighbours[j], k - j });
+                    j = k;
+                }
+            }
+        }
+
+        // Greedily grows groups from seeds, always taking the ungrouped neighbour sharing the most vertices
+        void groupClusters(const std::vector<ClusterNeighbours>& adjacency, std::vector<std::vector<uint32_t>>& groups)
+        {
+            std::vector<bool> grouped(adjacency.size(), false);
+            for (uint32_t seed = 0; seed < adjacency.size(); seed++)
+            {
+                if (grouped[seed])
+                    continue;
+
+                std::vector<uint32_t> group = { seed };
+                grouped[seed] = true;
+                while (group.size() < CLUSTER_GROUP_SIZE)
+                {
+                    uint32_t best = UINT32_MAX;
+                    uint32_t bestWeight = 0;
+                    for (uint32_t member : group)
+                    {
+                        for (auto const& [neighbour, weight] : adjacency[member])
+                        {
+                            if (!grouped[neighbour] && weight > bestWeight)
+                            {
+                                best = neighbour;
+                                bestWeight = weight;
+                            }
+                        }
+                    }
+
+                    if (best == UINT32_MAX)
+                        break;
+
+                    grouped[best] = true;
+                    group.push_back(best);
+                }
+                groups.push_back(group);
+            }
+        }
+
+        hlsl::float4 transformSphere(const hlsl::float4x4& world, const hlsl::float4& sphere, float scale)
+        {
+            const hlsl::float4 center = world * hlsl::float4(sphere.x, sphere.y, sphere.z, 1.0f);
+            return hlsl::float4(center.x, center.y, center.z, sphere.w * scale);
+        }
+    }
+
+    void buildClusterDAG(
+        const std::vector<Meshlet>& meshlets,
+        const std::vector<uint32_t>& meshletVertices,
+        const std::vector<uint32_t>& meshletTriangles,
+        const std::vector<hlsl::float3>& positions,
+        uint32_t maxVerts,
+        uint32_t maxPrims,
+        ClusterDAG& dag)
+    {
+        dag = ClusterDAG();
+        if (meshlets.empty())
+            return;
+
+        // Groups are re-meshletized with meshopt_buildMeshlets whatever meshletizer built level 0, so the limits are
+        // rounded down to what it accepts. Coarser clusters then still fit the pipeline the mesh was built for
+        const uint32_t clusterMaxVerts = std::min(maxVerts, static_cast<uint32_t>(MESHOPT_MAX_MESHLET_VERTICES));
+        const uint32_t clusterMaxPrims = maxPrims / MESHOPT_MESHLET_TRIANGLE_GRANULARITY * MESHOPT_MESHLET_TRIANGLE_GRANULARITY;
+        if (!fitsMeshoptimizerLimits(static_cast<int32_t>(clusterMaxVerts), static_cast<int32_t>(clusterMaxPrims)))
+        {
+            printf("Cluster DAG not built, meshlet limits %u/%u are too small for meshoptimizer\n", maxVerts, maxPrims);
+            return;
+        }
+
+        std::vector<uint32_t> current;
+        std::vector<uint32_t> indices;
+
+        // Level 0 are the meshlets we already render
+        for (auto const& meshlet : meshlets)
+        {
+            Cluster cluster = {};
+            cluster.meshlet.VertOffset = static_cast<uint32_t>(dag.vertexIndices.size());
+            cluster.meshlet.PrimOffset = static_cast<uint32_t>(dag.triangles.size());
+            cluster.meshlet.VertCount = meshlet.VertCount;
+            cluster.meshlet.PrimCount = meshlet.PrimCount;
+            cluster.error = 0.0f;
+            cluster.parentError = FLT_MAX;
+            cluster.level = 0;
+
+            dag.vertexIndices.insert(dag.vertexIndices.end(), meshletVertices.begin() + meshlet.VertOffset, meshletVertices.begin() + meshlet.VertOffset + meshlet.VertCount);
+            dag.triangles.insert(dag.triangles.end(), meshletTriangles.begin() + meshlet.PrimOffset, meshletTriangles.begin() + meshlet.PrimOffset + meshlet.PrimCount);
+
+            current.push_back(static_cast<uint32_t>(dag.clusters.size()));
+            dag.clusters.push_back(cluster);
+
+            indices.clear();
+            gatherTriangles(dag, current.back(), indices);
+            dag.clusters.back().boundingSphere = computeBounds(indices, positions);
+            dag.clusters.back().lodBounds = dag.clusters.back().boundingSphere;
+        }
+        dag.levelCount = 1;
+
+        std::vector<ClusterNeighbours> adjacency;
+        std::vector<std::vector<uint32_t>> groups;
+        std::vector<uint32_t> next;
+        std::vector<uint32_t> simplified;
+        std::vector<meshopt_Meshlet> groupMeshlets;
+        std::vector<unsigned int> groupMeshletVertices;
+        std::vector<unsigned char> groupMeshletTriangles;
+
+        while (current.size() > 1 && dag.levelCount < CLUSTER_DAG_MAX_LEVELS)
+        {
+            groups.clear();
+            next.clear();
+            buildAdjacency(dag, current, static_cast<uint32_t>(positions.size()), adjacency);
+            groupClusters(adjacency, groups);
+
+            bool progressed = false;
+            for (auto const& group : groups)
+            {
+                indices.clear();
+                hlsl::float4 groupBounds = dag.clusters[current[group[0]]].lodBounds;
+                float groupError = 0.0f;
+                for (uint32_t member : group)
+                {
+                    const Cluster& cluster = dag.clusters[current[member]];
+                    gatherTriangles(dag, current[member], indices);
+                    groupBounds = culling::mergeSpheres(groupBounds, cluster.lodBounds);
+                    groupError = std::max(groupError, cluster.error);
+                }
+
+                // Border vertices are locked so the group still matches its neighbours at any LOD
+                float simplifyError = 0.0f;
+                simplified.resize(indices.size());
+                simplified.resize(meshopt_simplify(
+                    simplified.data(),
+                    indices.data(),
+                    indices.size(),
+                    &positions[0].x,
+                    positions.size(),
+                    sizeof(hlsl::float3),
+                    (indices.size() / 6) * 3,
+                    FLT_MAX,
+                    meshopt_SimplifyLockBorder | meshopt_SimplifySparse | meshopt_SimplifyErrorAbsolute,
+                    &simplifyError));
+
+                if (simplified.empty() || simplified.size() > indices.size() * MIN_SIMPLIFICATION_RATIO)
+                {
+                    // Stay roots for now, grouped with different neighbours next pass they may still simplify
+                    for (uint32_t member : group)
+                    {
+                        next.push_back(current[member]);
+                    }
+                    continue;
+                }
+                progressed = true;
+
+                groupError = std::max(groupError, simplifyError);
+                for (uint32_t member : group)
+                {
+                    dag.clusters[current[member]].parentError = groupError;
+                    dag.clusters[current[member]].parentLodBounds = groupBounds;
+                }
+
+                const size_t maxMeshlets = meshopt_buildMeshletsBound(simplified.size(), clusterMaxVerts, clusterMaxPrims);
+                groupMeshlets.resize(maxMeshlets);
+                groupMeshletVertices.resize(maxMeshlets * clusterMaxVerts);
+                groupMeshletTriangles.resize(maxMeshlets * clusterMaxPrims * 3);
+                const size_t meshletCount = meshopt_buildMeshlets(
+                    groupMeshlets.data(),
+                    groupMeshletVertices.data(),
+                    groupMeshletTriangles.data(),
+                    simplified.data(),
+                    simplified.size(),
+                    &positions[0].x,
+                    positions.size(),
+                    sizeof(hlsl::float3),
+                    clusterMaxVerts,
+                    clusterMaxPrims,
+                    0.0f);
+
+                for (size_t i = 0; i < meshletCount; i++)
+                {
+                    const meshopt_Meshlet& meshlet = groupMeshlets[i];
+
+                    Cluster cluster = {};
+                    cluster.meshlet.VertOffset = static_cast<uint32_t>(dag.vertexIndices.size());
+                    cluster.meshlet.PrimOffset = static_cast<uint32_t>(dag.triangles.size());
+                    cluster.meshlet.VertCount = meshlet.vertex_count;
+                    cluster.meshlet.PrimCount = meshlet.triangle_count;
+                    cluster.lodBounds = groupBounds;
+                    cluster.error = groupError;
+                    cluster.parentError = FLT_MAX;
+                    cluster.level = dag.levelCount;
+
+                    const meshopt_Bounds bounds = meshopt_computeMeshletBounds(
+                        &groupMeshletVertices[meshlet.vertex_offset],
+                        &groupMeshletTriangles[meshlet.triangle_offset],
+                        meshlet.triangle_count,
+                        &positions[0].x,
+                        positions.size(),
+                        sizeof(hlsl::float3));
+                    cluster.boundingSphere = hlsl::float4(bounds.center[0], bounds.center[1], bounds.center[2], bounds.radius);
+
+                    dag.vertexIndices.insert(dag.vertexIndices.end(), groupMeshletVertices.begin() + meshlet.vertex_offset, groupMeshletVertices.begin() + meshlet.vertex_offset + meshlet.vertex_count);
+                    for (uint32_t t = 0; t < meshlet.triangle_count; t++)
+                    {
+                        const unsigned char* triangle = &groupMeshletTriangles[meshlet.triangle_offset + t * 3];
+                        dag.triangles.push_back(olej_utils::packTriangle(triangle[0], triangle[1], triangle[2]));
+                    }
+
+                    next.push_back(static_cast<uint32_t>(dag.clusters.size()));
+                    dag.clusters.push_back(cluster);
+                }
+            }
+
+            if (!progressed)
+                break;
+
+            dag.levelCount++;
+            std::swap(current, next);
+        }
+    }
+
+    float computeProjectionScale(float fovVerticalInDegrees, float screenHeight)
+    {
+        return screenHeight / (2.0f * tanf(fovVerticalInDegrees * hlsl::DEG2RAD * 0.5f));
+    }
+
+    float projectedError(const hlsl::float4& lodBounds, float error, const hlsl::float3& cameraPosition, float projectionScale)
+    {
+        if (error <= 0.0f)
+            return 0.0f;
+        if (error == FLT_MAX)
+            return FLT_MAX;
+
+        const float distance = hlsl::length(hlsl::float3(lodBounds.x, lodBounds.y, lodBounds.z) - cameraPosition) - lodBounds.w;
+
+        // camera inside the bounds, only the finest level is good enough
+        if (distance <= 0.0f)
+            return FLT_MAX;
+
+        return error / distance * projectionScale;
+    }
+
+    uint32_t selectCut(
+        const ClusterDAG& dag,
+        const hlsl::float4x4& world,
+        const hlsl::float3& cameraPosition,
+        float projectionScale,
+        float thresholdPixels,
+        std::vector<uint32_t>& selectedClusters)
+    {
+        selectedClusters.clear();
+
+        const float scale = hlsl::maxScale(world);
+        uint32_t triangleCount = 0;
+
+        // Every cluster decides on its own, which is what makes the test trivially parallel on the GPU later
+        for (uint32_t i = 0; i < dag.clusters.size(); i++)
+        {
+            const Cluster& cluster = dag.clusters[i];
+
+            if (cluster.parentError != FLT_MAX)
+            {
+                const float parentError = projectedError(transformSphere(world, cluster.parentLodBounds, scale), cluster.parentError * scale, cameraPosition, projectionScale);
+                if (parentError <= thresholdPixels)
+                    continue;
+            }
+
+            const float error = projectedError(transformSphere(world, cluster.lodBounds, scale), cluster.error * scale, cameraPosition, projectionScale);
+            if (error > thresholdPixels)
+                continue;
+
+            selectedClusters.push_back(i);
+            triangleCount += cluster.meshlet.PrimCount;
+        }
+
+        return triangleCount;
+    }
+}
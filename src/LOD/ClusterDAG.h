@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "DXMeshletGenerator/MeshletTypes.h"
+#include "utils/maths.h"
+
+namespace lod
+{
+    // Number of neighbouring clusters simplified together
+    static const uint32_t CLUSTER_GROUP_SIZE = 4;
+    static const uint32_t CLUSTER_DAG_MAX_LEVELS = 16;
+
+    struct Cluster
+    {
+        Meshlet meshlet;              // VertOffset indexes ClusterDAG::vertexIndices, PrimOffset indexes ClusterDAG::triangles
+        hlsl::float4 boundingSphere;  // culling bounds of the cluster itself
+        hlsl::float4 lodBounds;       // bounds of the group this cluster was simplified from
+        hlsl::float4 parentLodBounds; // bounds of the group this cluster was simplified into
+        float error;                  // object space error of this cluster, 0 for the original meshlets
+        float parentError;            // error of the coarser clusters replacing it, FLT_MAX for roots
+        uint32_t level;
+        uint32_t padding;
+    };
+
+    struct ClusterDAG
+    {
+        std::vector<Cluster> clusters;
+        std::vector<uint32_t> vertexIndices; // cluster local vertex -> mesh vertex
+        std::vector<uint32_t> triangles;     // packed local triangles, same layout as Mesh::m_meshletTriangles
+        uint32_t levelCount = 0;
+
+        bool empty() const { return clusters.empty(); }
+    };
+
+    /*
+     * Builds a continuous LOD hierarchy on top of existing meshlets.
+     * Every pass groups neighbouring clusters, simplifies each group to half of its triangles with the group border locked,
+     * and splits the result into new clusters. Passes repeat until nothing can be simplified anymore.
+     * Errors are monotonic: a cluster's error is never smaller than the errors of the clusters it was built from.
+     */
+    void buildClusterDAG(
+        const std::vector<Meshlet>& meshlets,
+        const std::vector<uint32_t>& meshletVertices,
+        const std::vector<uint32_t>& meshletTriangles,
+        const std::vector<hlsl::float3>& positions,
+        uint32_t maxVerts,
+        uint32_t maxPrims,
+        ClusterDAG& dag);
+
+    // Pixels per unit of object space error at distance 1
+    float computeProjectionScale(float fovVerticalInDegrees, float screenHeight);
+
+    // Error of a cluster in pixels when seen from cameraPosition
+    float projectedError(const hlsl::float4& lodBounds, float error, const hlsl::float3& cameraPosition, float projectionScale);
+
+    /*
+     * Picks the DAG cut for the given camera: a cluster is selected when its own error is within the threshold
+     * and the error of its parent group is not. Siblings share both values, so the cut never mixes a group with its parents.
+     * Returns number of selected triangles.
+     */
+    uint32_t selectCut(
+        const ClusterDAG& dag,
+        const hlsl::float4x4& world,
+        const hlsl::float3& cameraPosition,
+        float projectionScale,
+        float thresholdPixels,
+        std::vector<uint32_t>& selectedClusters);
+}
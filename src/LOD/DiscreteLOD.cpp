@@ -0,0 +1,91 @@
+#include "DiscreteLOD.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "meshoptimizer.h"
+
+namespace lod
+{
+    void generateLODChain(
+        const std::vector<uint32_t>& indices,
+        const std::vector<hlsl::float3>& positions,
+        uint32_t lodCount,
+        std::vector<LODLevel>& levels)
+    {
+        levels.clear();
+        levels.push_back({ indices, 0.0f });
+
+        for (uint32_t i = 1; i < lodCount; i++)
+        {
+            const LODLevel& previous = levels.back();
+            const size_t targetIndexCount = (previous.indices.size() / 6) * 3;
+            if (targetIndexCount == 0)
+                break;
+
+            LODLevel level;
+            float error = 0.0f;
+            level.indices.resize(previous.indices.size());
+            level.indices.resize(meshopt_simplify(
+                level.indices.data(),
+                previous.indices.data(),
+                previous.indices.size(),
+                &positions[0].x,
+                positions.size(),
+                sizeof(hlsl::float3),
+                targetIndexCount,
+                FLT_MAX,
+                meshopt_SimplifyErrorAbsolute,
+                &error));
+
+            if (level.indices.empty() || level.indices.size() > previous.indices.size() * LOD_MIN_REDUCTION)
+                break;
+
+            level.error = std::max(previous.error, error);
+            levels.push_back(std::move(level));
+        }
+    }
+
+    void compactVertices(std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& sourceVertices)
+    {
+        std::vector<uint32_t> remap(vertexCount);
+        const size_t uniqueVertices = meshopt_optimizeVertexFetchRemap(remap.data(), indices.data(), indices.size(), vertexCount);
+
+        sourceVertices.resize(uniqueVertices);
+        for (uint32_t i = 0; i < vertexCount; i++)
+        {
+            if (remap[i] != UINT32_MAX)
+                sourceVertices[remap[i]] = i;
+        }
+
+        for (auto& index : indices)
+        {
+            index = remap[index];
+        }
+    }
+
+    float projectedSphereSize(const hlsl::float4& sphere, const hlsl::float3& cameraPosition, float projectionScale)
+    {
+        const float distance = hlsl::length(hlsl::float3(sphere.x, sphere.y, sphere.z) - cameraPosition);
+        if (distance <= sphere.w)
+            return FLT_MAX;
+
+        return 2.0f * sphere.w / distance * projectionScale;
+    }
+
+    uint32_t selectLOD(float projectedSize, float sphereRadius, const std::vector<float>& lodErrors, float thresholdPixels)
+    {
+        if (projectedSize == FLT_MAX || sphereRadius <= 0.0f)
+            return 0;
+
+        const float pixelsPerUnit = projectedSize / (2.0f * sphereRadius);
+        uint32_t selected = 0;
+        for (uint32_t i = 1; i < lodErrors.size(); i++)
+        {
+            if (lodErrors[i] * pixelsPerUnit > thresholdPixels)
+                break;
+            selected = i;
+        }
+        return selected;
+    }
+}
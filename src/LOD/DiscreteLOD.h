@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "utils/maths.h"
+
+namespace lod
+{
+    // Coarser LODs are dropped once simplification can't remove at least 15% of the triangles
+    static const float LOD_MIN_REDUCTION = 0.85f;
+
+    struct LODLevel
+    {
+        std::vector<uint32_t> indices;
+        float error; // object space, never smaller than the error of the previous level
+    };
+
+    /*
+     * Generates up to lodCount levels, each one simplified from the previous to half of its triangles.
+     * Level 0 is the source index buffer. Indices still reference the source vertex buffer.
+     * Doesn't touch the GPU, can run anywhere.
+     */
+    void generateLODChain(
+        const std::vector<uint32_t>& indices,
+        const std::vector<hlsl::float3>& positions,
+        uint32_t lodCount,
+        std::vector<LODLevel>& levels);
+
+    /*
+     * Drops vertices the index buffer doesn't reference and renumbers the rest in first use order.
+     * sourceVertices maps new vertex index to the index in the original vertex buffer.
+     */
+    void compactVertices(std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& sourceVertices);
+
+    // Diameter of a world space sphere on screen in pixels, FLT_MAX when the camera is inside
+    float projectedSphereSize(const hlsl::float4& sphere, const hlsl::float3& cameraPosition, float projectionScale);
+
+    /*
+     * Returns the coarsest level whose error stays within thresholdPixels for a sphere of the given size on screen.
+     * Error grows linearly with projected size, so it is measured relative to the sphere it was computed for.
+     */
+    uint32_t selectLOD(float projectedSize, float sphereRadius, const std::vector<float>& lodErrors, float thresholdPixels);
+}
@@ -2,10 +2,10 @@
 #include <vector>
 
 
-#include "DX12Wrappers/Vertex.h"
+#include "MeshGeometry.h"
 #include "Texture.h"
 
-#include "MeshletStructs.h"
+#include "DX12Wrappers/BindingTable.h"
 #include "DX12Wrappers/Resource.h"
 #include "../res/shaders/shared/shared_cb.h"
 
@@ -28,17 +28,11 @@ struct Attribute
     uint32_t Offset;
 };
 
-struct MeshSubset
-{
-    uint32_t offset;
-    uint32_t size;
-};
-
 template <typename T>
 class ConstantBuffer;
 
 
-class Mesh
+class Mesh : public MeshGeometry
 {
 public:
     Mesh(std::vector<Vertex> const& vertices,
@@ -50,7 +44,10 @@ public:
         std::vector<uint32_t> const& attributes,
         MeshletizerType meshletizerType,
         int32_t maxVerts,
-        int32_t maxPrims);
+        int32_t maxPrims,
+        VertexReorderSettings const& vertexReorder = {},
+        MeshletCostWeights const& costWeights = {},
+        VertexCacheOptimizer vertexCacheOptimizer = VCACHE_NONE);
 
 
     Mesh(std::vector<Vertex> const& vertices, 
@@ -65,55 +62,55 @@ public:
         int32_t maxPrims,
         std::vector<Meshlet> const& meshlets,
         std::vector<uint32_t> const& meshletTriangles,
-        std::vector<CullData> const&  cullData);
+        std::vector<CullData> const&  cullData,
+        std::vector<culling::MeshletBVHNode> const& bvhNodes);
 
     ~Mesh();
 
     void bindTextures();
-    void bindMeshInfo(uint32_t meshletCount, uint32_t meshletOffset, uint32_t subsetIndex, PipelineState* pso);
-
-    void dispatch(PipelineState* pso);
-
-    void meshletizeDXMESH();
-    void meshletizeMeshoptimizer();
-    void meshletizeGreedy();
-    void meshletizeBoundingSphere();
-    void meshletizeNvidia();
+#ifdef CULLING
+    // Every AS group tests a BVH leaf worth of meshlets
+    static constexpr uint32_t MESHLETS_PER_GROUP = culling::MESHLET_BVH_LEAF_SIZE;
+#else
+    static constexpr uint32_t MESHLETS_PER_GROUP = 1;
+#endif
 
+    // One meshlet range for instanceCount instances, split into as many dispatches as the group limits require
+    static void dispatchRange(ConstantBuffer<MeshInfo>* meshInfoBuffer, PipelineState* pso, uint32_t indexBytes, MeshSubset const& range, uint32_t instanceCount);
 
+    // Instances are read from the Instances buffer bound by the caller, world and the caller's frustum planes
+    // (top, bottom, right, left, far, near) are used for CPU culling of a single instance
+    void dispatch(PipelineState* pso, hlsl::float4x4 const& world, hlsl::float4 const (&planes)[6], uint32_t instanceCount = 1);
+    BindingTable const& getBindingTable(PipelineState const* pso);
 
     void changeMeshletizerType(MeshletizerType type);
 
+    // MeshGeometry::remeshletize, then drops this frame's visible ranges and reports the partition time
+    void remeshletize(MeshletizerType type, int32_t maxVerts, int32_t maxPrims, VertexCacheOptimizer vertexCacheOptimizer);
 
-    std::vector<Vertex> m_vertices;
-    std::vector<uint32_t> m_indices;
-    std::vector<CullData> m_cullData;
+    // Schedules GPU buffers for deletion, they may still be used by frames in flight
+    void releaseGPUResources();
 
-    std::vector<Meshlet> m_meshlets;
-    std::vector<uint32_t> m_meshletTriangles;
 
     std::vector<Texture*> m_textures;
-    std::vector<uint32_t> m_attributes;
 
-    std::vector<hlsl::float3> m_positions;
-    std::vector<hlsl::float3> m_normals;
-    std::vector<hlsl::float2> m_UVs;
+    // Meshlet ranges that survived BVH culling this frame
+    std::vector<MeshSubset> m_visibleRanges;
 
-    std::vector<MeshSubset> m_subsets;
+    Resource*              VertexResource = nullptr;
+    Resource*              IndexResource = nullptr;
+    Resource*              MeshletResource = nullptr;
+    Resource*              MeshletTriangleIndicesResource = nullptr;
+    Resource*              CullDataResource = nullptr;
 
-    Resource*              VertexResource;
-    Resource*              IndexResource;
-    Resource*              MeshletResource;
-    Resource*              MeshletTriangleIndicesResource;
-    Resource*              CullDataResource;
+    // Every bind uploads a new slice, so one is enough for all subsets
+    ConstantBuffer<MeshInfo>* m_meshInfoBuffer = nullptr;
 
-    std::vector<ConstantBuffer<MeshInfo>*> m_meshInfoBuffers;
+    // Buffers above, one table per pipeline state so switching between small and big meshlet PSOs doesn't rebuild
+    BindingTable m_bindingTables[2];
+    uint32_t m_nextBindingTable = 0;
 
-    int32_t m_MeshletMaxVerts = 64;
-    int32_t m_MeshletMaxPrims = 124;
-
-    MeshletizerType m_type = MESHOPT;
 private:
-    void generateSubsets();
+    // Shown by the benchmark editor and added to the meshletizer counters
+    void reportPartitionTime() const;
 };
-
@@ -0,0 +1,721 @@
+#include "MeshGeometry.h"
+
+#include <DirectXMesh.h>
+#include <stdexcept>
+#include <utility>
+
+#include "meshoptimizer.h"
+#include "GreedyMeshletizer/GreedyMeshletizer.h"
+#include "DXMeshletGenerator/D3D12MeshletGenerator.h"
+#include "DXMeshletGenerator/Generation.h"
+#include "GreedyMeshletizer/boundingSphereMeshletizer.h"
+#include "GreedyMeshletizer/nvMeshletizer.h"
+#include "GreedyMeshletizer/vertexReorder.h"
+#include "GreedyMeshletizer/costMeshletizer.h"
+#include "GreedyMeshletizer/vertexCacheOptimizer.h"
+
+#define TRACY_NO_SAMPLE_BRANCH
+#define TRACY_NO_SAMPLE_RETIREMENT
+
+#include "Tools/ProfileZone.h"
+
+namespace
+{
+    // DirectXMesh and the DXMESH generator report errors as HRESULT, no device is around to report them to
+    void checkResult(HRESULT hr)
+    {
+        if (FAILED(hr))
+        {
+            printf("Error: %ld\n", static_cast<long>(hr));
+            throw std::runtime_error("meshletizer step failed, check in debugger");
+        }
+    }
+}
+
+MeshGeometry::MeshGeometry(std::vector<Vertex> const& vertices, std::vector<uint32_t> const& indices, std::vector<hlsl::float3> const& positions, std::vector<hlsl::float3> const& normals, std::vector<hlsl::float2> const& UVS, std::vector<uint32_t> const& attributes, MeshletizerType meshletizerType, int32_t maxVerts, int32_t maxPrims, VertexReorderSettings const& vertexReorder, MeshletCostWeights const& costWeights, VertexCacheOptimizer vertexCacheOptimizer)
+{
+    m_vertices = vertices;
+    m_indices = indices;
+    m_UVs = UVS;
+    m_positions = positions;
+    m_normals = normals;
+    m_attributes = attributes;
+    m_type = meshletizerType;
+    m_MeshletMaxPrims = maxPrims;
+    m_MeshletMaxVerts = maxVerts;
+    m_vertexReorder = vertexReorder;
+    m_costWeights = costWeights;
+    m_vertexCacheOptimizer = vertexCacheOptimizer;
+    m_sourceIndices = indices;
+    m_sourceVertexCount = static_cast<uint32_t>(vertices.size());
+
+    meshletize();
+}
+
+MeshGeometry::MeshGeometry(std::vector<Vertex> const& vertices, std::vector<uint32_t> const& indices,
+    std::vector<hlsl::float3> const& positions, std::vector<hlsl::float3> const& normals,
+    std::vector<hlsl::float2> const& UVS, std::vector<uint32_t> const& attributes, MeshletizerType meshletizerType,
+    int32_t maxVerts, int32_t maxPrims,
+    std::vector<Meshlet> const& meshlets, std::vector<uint32_t> const& meshletTriangles, std::vector<CullData> const& cullData,
+    std::vector<culling::MeshletBVHNode> const& bvhNodes)
+{
+    m_vertices = vertices;
+    m_indices = indices;
+    m_UVs = UVS;
+    m_positions = positions;
+    m_normals = normals;
+    m_attributes = attributes;
+    m_meshlets = meshlets;
+    m_type = meshletizerType;
+    m_meshletTriangles = meshletTriangles;
+    m_cullData = cullData;
+    m_bvhNodes = bvhNodes;
+    m_MeshletMaxPrims = maxPrims;
+    m_MeshletMaxVerts = maxVerts;
+
+    if (m_bvhNodes.empty())
+        buildBVH();
+
+    m_indexBytes = getIndexBytes(m_vertices.size());
+
+    generateSubsets();
+
+    float totalRadiuses = 0.0f;
+    float totalAngles = 0.0f;
+    float avgRadius = 0.0f;
+    float maxRadius = 0.0f;
+    float minRadius = 0.0f;
+    float avgAngle = 0.0f;
+    int degenerateConeCounter = 0;
+    for (int i = 0; i < m_cullData.size(); i++)
+    {
+        totalRadiuses += m_cullData[i].BoundingSphere.w;
+        if(m_cullData[i].NormalCone[3] == 0xff)
+        {
+            degenerateConeCounter++;
+        }
+        float angle = float((m_cullData[i].NormalCone[3] >> 24) & 0xFF);
+        totalAngles += acosf(angle);
+        if (m_cullData[i].BoundingSphere.w > maxRadius)
+        {
+            maxRadius = m_cullData[i].BoundingSphere.w;
+        }
+        if (m_cullData[i].BoundingSphere.w < minRadius)
+        {
+            minRadius = m_cullData[i].BoundingSphere.w;
+        }
+
+
+
+    }
+
+    avgRadius = totalRadiuses / m_cullData.size();
+    avgAngle = totalAngles / m_cullData.size();
+    //float vertFill = (float)totalVerts / (float)(m_MeshletMaxVerts * m_meshlets.size());
+    //float triFill = (float)totalTris / (float)(m_MeshletMaxPrims * m_meshlets.size());
+    printf("=========MESHLETIZER %i =========\n", static_cast<int>(m_type));
+    printf("Avg radius: %f \n", avgRadius);
+    printf("Avg angle: %f \n", avgAngle);
+    printf("Max radius: %f \n", maxRadius);
+    printf("Min radius: %f \n", minRadius);
+    printf("Meshlets: %i \n", m_meshlets.size());
+    printf("Degenerate cones: %i \n", degenerateConeCounter);
+
+}
+void MeshGeometry::meshletizeDXMESH()
+{
+    const uint32_t vertexCount = static_cast<uint32_t>(m_vertices.size());
+    const uint32_t triCount = m_indices.size() / 3;
+
+    std::vector<hlsl::float3> positionReorder;
+    std::vector<hlsl::float3> normalReorder;
+    std::vector<hlsl::float2> uvReorder;
+    std::vector<uint32_t> indexReorder;
+    std::vector<uint32_t> faceRemap;
+    std::vector<uint32_t> vertexRemap;
+    std::vector<uint32_t> dupVerts;
+    std::vector<Subset> indexSubsets;
+    std::vector<Subset> meshlet_subsets;
+    std::vector<uint8_t> unique_vertex_indices;
+    std::vector<PackedTriangle> primitive_indices;
+    std::vector<uint32_t> indices_mapping;
+
+
+    std::vector<hlsl::float3> tangents;
+    std::vector<hlsl::float3> bitangents;
+
+    // Cleanup below only depends on the source triangles, run it once per mesh
+    if (!m_intermediates.dxmeshIndices.empty())
+    {
+        m_indices = m_intermediates.dxmeshIndices;
+        indexSubsets = m_intermediates.dxmeshSubsets;
+    }
+    else
+    {
+        // Resize all our interim data buffers to appropriate sizes for the mesh
+        positionReorder.resize(vertexCount);
+        indexReorder.resize(m_indices.size());
+
+        faceRemap.resize(triCount);
+        vertexRemap.resize(vertexCount);
+
+        ///
+        // Use DirectXMesh to optimize our vertex buffer data
+
+        // Clean the mesh, sort faces by material, and reorder
+
+
+        checkResult(DirectX::Clean(m_indices.data(), triCount, vertexCount, nullptr, m_attributes.data(), dupVerts, true));
+        checkResult(DirectX::AttributeSort(triCount, m_attributes.data(), faceRemap.data()));
+        checkResult(DirectX::ReorderIB(m_indices.data(), triCount, faceRemap.data(), indexReorder.data()));
+
+        std::swap(m_indices, indexReorder);
+
+        //// Optimize triangle faces and reorder
+        checkResult(DirectX::OptimizeFacesLRU((m_indices.data()), triCount, faceRemap.data()));
+        checkResult(DirectX::ReorderIB((m_indices.data()), triCount, faceRemap.data(), indexReorder.data()));
+
+        std::swap(m_indices, indexReorder);
+
+        // tu sie cos jebie
+        // assimp should be doing that already, so comment out for now
+        //checkResult(DirectX::OptimizeVertices(m_indices.data(), triCount, vertexCount, vertexRemap.data()));
+
+        //// Finalize the index & vertex buffers (potential reordering)
+        //checkResult(DirectX::FinalizeIB(m_indices.data(), triCount, vertexRemap.data(), vertexCount, indexReorder.data()));
+        //checkResult(DirectX::FinalizeVB(m_vertices.data(), sizeof(Vertex), vertexCount, dupVerts.data(), dupVerts.size(), vertexRemap.data(), positionReorder.data()));
+
+        //std::swap(m_indices, indexReorder);
+        //std::swap(m_vertices, vertex);
+
+        ////if (HasAttribute(m_type, Attribute::Normal))
+        //{
+        //    normalReorder.resize(vertexCount);
+        //    checkResult(DirectX::FinalizeVB(m_normals.data(), sizeof(hlsl::float3), vertexCount, dupVerts.data(), dupVerts.size(), vertexRemap.data(), normalReorder.data()));
+
+        //    std::swap(m_normals, normalReorder);
+        //}
+
+        ////if (HasAttribute(m_type, Attribute::TexCoord))
+        //{
+        //    uvReorder.resize(vertexCount);
+        //    checkResult(DirectX::FinalizeVB(m_UVs.data(), sizeof(hlsl::float2), vertexCount, dupVerts.data(), dupVerts.size(), vertexRemap.data(), uvReorder.data()));
+
+        //    std::swap(m_UVs, uvReorder);
+        //}
+
+        // Populate material subset data
+        auto subsets = DirectX::ComputeSubsets(m_attributes.data(), m_attributes.size());
+
+        indexSubsets.resize(subsets.size());
+        for (uint32_t i = 0; i < subsets.size(); ++i)
+        {
+            indexSubsets[i].Offset = static_cast<uint32_t>(subsets[i].first) * 3;
+            indexSubsets[i].Count = static_cast<uint32_t>(subsets[i].second) * 3;
+        }
+
+        {
+            tangents.resize(vertexCount);
+            bitangents.resize(vertexCount);
+
+            checkResult(ComputeTangentFrame(
+                m_indices.data(),
+                triCount,
+                reinterpret_cast<const DirectX::XMFLOAT3*>(m_positions.data()),
+                reinterpret_cast<const DirectX::XMFLOAT3*>(m_normals.data()),
+                reinterpret_cast<const DirectX::XMFLOAT2*>(m_UVs.data()),
+                vertexCount,
+                reinterpret_cast<DirectX::XMFLOAT3*>(tangents.data()),
+                reinterpret_cast<DirectX::XMFLOAT3*>(bitangents.data())));
+        }
+
+        m_intermediates.dxmeshIndices = m_indices;
+        m_intermediates.dxmeshSubsets = indexSubsets;
+    }
+
+    // Meshletize our mesh and generate per-meshlet culling data
+
+    ResetMeshletizeTimings();
+    startPartition();
+    {
+        PROFILE_ZONE("DXMESH meshletizing");
+        checkResult(ComputeMeshlets(
+            m_MeshletMaxVerts,
+            m_MeshletMaxPrims,
+            m_indices.data(),
+            m_indices.size(),
+            indexSubsets.data(),
+            static_cast<uint32_t>(indexSubsets.size()),
+            reinterpret_cast<const DirectX::XMFLOAT3*>(m_positions.data()),
+            static_cast<uint32_t>(m_positions.size()),
+            meshlet_subsets,
+            m_meshlets,
+            unique_vertex_indices,
+            primitive_indices
+        ));
+        endPartition();
+    }
+
+    MeshletizeTimings const& timings = GetMeshletizeTimings();
+    printf("=========DXMESH TIMINGS=========\n");
+    printf("Adjacency: %f s\n", timings.Adjacency);
+    printf("Scoring: %f s\n", timings.Scoring);
+    printf("Selection: %f s\n", timings.Total - timings.Adjacency - timings.Scoring);
+    printf("Total: %f s\n", timings.Total);
+    printf("Rescored candidates: %u\n", timings.Rescored);
+
+
+
+    m_cullData.resize(m_meshlets.size());
+    checkResult(ComputeCullData(
+        reinterpret_cast<const DirectX::XMFLOAT3*>(m_positions.data()),
+        m_positions.size(),
+        m_meshlets.data(),
+        m_meshlets.size(),
+        reinterpret_cast<uint32_t*>(unique_vertex_indices.data()),
+        primitive_indices.data(),
+        DirectX::CNORM_DEFAULT,
+        m_cullData.data()
+    ));
+
+    m_meshletTriangles.resize(primitive_indices.size());
+
+    for (int i = 0; i < primitive_indices.size(); i++)
+    {
+        m_meshletTriangles[i] = olej_utils::packTriangle(static_cast<uint8_t>(primitive_indices[i].indices.i0), static_cast<uint8_t>(primitive_indices[i].indices.i1), static_cast<uint8_t>(primitive_indices[i].indices.i2));
+    }
+
+    for(int i = 0; i < unique_vertex_indices.size(); i += 4)
+    {
+        uint32_t packed =
+            static_cast<uint32_t>(unique_vertex_indices[i + 0]) << 0 |
+            static_cast<uint32_t>(unique_vertex_indices[i + 1]) << 8 |
+            static_cast<uint32_t>(unique_vertex_indices[i + 2]) << 16 |
+            static_cast<uint32_t>(unique_vertex_indices[i + 3]) << 24;
+
+        indices_mapping.push_back(packed);
+    }
+    m_indices = indices_mapping;
+
+    //m_cullData.resize(m_meshlets.size());
+
+
+}
+
+void MeshGeometry::meshletizeMeshoptimizer()
+{
+    const float cone_weight = 0.0f;
+
+    size_t max_meshlets = meshopt_buildMeshletsBound(m_indices.size(), m_MeshletMaxVerts, m_MeshletMaxPrims);
+    std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+    std::vector<uint32_t> indices_mapping;
+    // vertex index data, so every entry in that vector is a global index of a vertex
+
+    indices_mapping.resize(max_meshlets * m_MeshletMaxVerts);
+    std::vector<unsigned char> meshlet_triangles(max_meshlets * m_MeshletMaxPrims);
+
+    size_t meshlet_count;
+    {
+        PROFILE_ZONE("Meshoptimizer meshletizing");
+        startPartition();
+            meshlet_count = meshopt_buildMeshlets(
+            meshlets.data(),
+            indices_mapping.data(),
+            meshlet_triangles.data(),
+            m_indices.data(),
+            m_indices.size(),
+            &m_positions[0].x,
+            m_positions.size(),
+            sizeof(hlsl::float3),
+            m_MeshletMaxVerts,
+            m_MeshletMaxPrims,
+            cone_weight);
+
+        for(int i = 0; i < meshlets.size(); i++)
+        {
+            meshopt_optimizeMeshlet(indices_mapping.data() + meshlets[i].vertex_offset, meshlet_triangles.data() + meshlets[i].triangle_offset, meshlets[i].triangle_count, meshlets[i].vertex_count);
+        }
+        endPartition();
+    }
+    m_meshlets.clear();
+    m_meshlets.resize(meshlet_count);
+    int addedElements = 0;
+    for (int i = 0; i < meshlet_count; i++)
+    {
+        m_meshlets[i].VertCount = meshlets[i].vertex_count;
+        m_meshlets[i].PrimCount = meshlets[i].triangle_count;
+        m_meshlets[i].VertOffset = meshlets[i].vertex_offset;
+        m_meshlets[i].PrimOffset = meshlets[i].triangle_offset + addedElements;
+        if(m_meshlets[i].PrimOffset % 3 == 1)
+        {
+            meshlet_triangles.insert(meshlet_triangles.begin() + m_meshlets[i].PrimOffset, meshlet_triangles.at(m_meshlets[i].PrimOffset));
+            m_meshlets[i].PrimOffset++;
+            meshlet_triangles.insert(meshlet_triangles.begin() + m_meshlets[i].PrimOffset, meshlet_triangles.at(m_meshlets[i].PrimOffset));
+            m_meshlets[i].PrimOffset++;
+            assert(m_meshlets[i].PrimOffset % 3 == 0);
+            addedElements += 2;
+        }
+        else if (m_meshlets[i].PrimOffset % 3 == 2)
+        {
+            meshlet_triangles.insert(meshlet_triangles.begin() + m_meshlets[i].PrimOffset, meshlet_triangles.at(m_meshlets[i].PrimOffset));
+            m_meshlets[i].PrimOffset++;
+            assert(m_meshlets[i].PrimOffset % 3 == 0);
+            addedElements++;
+        }
+        m_meshlets[i].PrimOffset /= 3;
+    }
+
+    std::vector<uint32_t> final_meshlet_triangles(meshlet_triangles.size() / 3);
+
+
+    size_t triangle_count = meshlet_triangles.size() / 3;
+
+
+
+    // convert data so it can be fed into ComputeCullData()
+    std::vector<PackedTriangle> triangles(triangle_count);
+    for(int i = 0; i < triangle_count; i++)
+    {
+        triangles[i].indices.i0 = meshlet_triangles[i * 3];
+        triangles[i].indices.i1 = meshlet_triangles[i * 3 + 1];
+        triangles[i].indices.i2 = meshlet_triangles[i * 3 + 2];
+    }
+
+    m_cullData.resize(m_meshlets.size());
+    checkResult(ComputeCullData(
+        reinterpret_cast<const DirectX::XMFLOAT3*>(m_positions.data()),
+        m_positions.size(),
+        m_meshlets.data(),
+        m_meshlets.size(),
+        indices_mapping.data(),
+        triangles.data(),
+        DirectX::CNORM_DEFAULT,
+        m_cullData.data()
+    ));
+
+
+
+
+    for (size_t i = 0; i < triangle_count; ++i)
+    {
+        final_meshlet_triangles[i] = olej_utils::packTriangle(meshlet_triangles[i * 3 + 0], meshlet_triangles[i * 3 + 1], meshlet_triangles[i * 3 + 2]);
+    }
+
+    m_meshletTriangles = final_meshlet_triangles;
+    m_indices.clear();
+    m_indices = indices_mapping;
+}
+
+void MeshGeometry::meshletizeGreedy()
+{
+    optimizeVertexCache();
+    if (m_intermediates.graphOptimizer != m_vertexCacheOptimizer)
+    {
+        PROFILE_ZONE("Mesh graph build");
+        m_intermediates.graph.build(m_indices, m_vertices);
+        m_intermediates.graphOptimizer = m_vertexCacheOptimizer;
+    }
+    std::vector<uint32_t> uniqueVertexIndices;
+    std::vector<uint32_t> indicesMapping;
+    {
+        PROFILE_ZONE("Greedy meshletizing");
+        startPartition();
+        meshletizers::greedy::meshletize(m_MeshletMaxVerts, m_MeshletMaxPrims, m_intermediates.graph, m_meshlets, uniqueVertexIndices, m_meshletTriangles);
+        endPartition();
+    }
+    m_indices = uniqueVertexIndices;
+
+
+    // convert data so it can be fed into ComputeCullData()
+    std::vector<PackedTriangle> triangles(m_meshletTriangles.size());
+    for (int i = 0; i < triangles.size(); i++)
+    {
+        auto packed = m_meshletTriangles[i];
+        triangles[i].indices.i0 = static_cast<uint8_t>(packed);
+        triangles[i].indices.i1 = static_cast<uint8_t>(packed >> 8);
+        triangles[i].indices.i2 = static_cast<uint8_t>(packed >> 16); 
+    }
+
+
+    m_cullData.resize(m_meshlets.size());
+
+    checkResult(ComputeCullData(
+        reinterpret_cast<const DirectX::XMFLOAT3*>(m_positions.data()),
+        m_positions.size(),
+        m_meshlets.data(),
+        m_meshlets.size(),
+        m_indices.data(),
+        triangles.data(),
+        DirectX::CNORM_DEFAULT,
+        m_cullData.data()
+    ));
+}
+
+void MeshGeometry::meshletizeBoundingSphere()
+{
+    optimizeVertexCache();
+    if (m_intermediates.graphOptimizer != m_vertexCacheOptimizer)
+    {
+        PROFILE_ZONE("Mesh graph build");
+        m_intermediates.graph.build(m_indices, m_vertices);
+        m_intermediates.graphOptimizer = m_vertexCacheOptimizer;
+    }
+    std::vector<uint32_t> uniqueVertexIndices;
+    std::vector<uint32_t> indicesMapping;
+    startPartition();
+    {
+        PROFILE_ZONE("BS meshletizing");
+        meshletizers::boundingSphere::meshletize(m_MeshletMaxVerts, m_MeshletMaxPrims, m_intermediates.graph, m_meshlets, uniqueVertexIndices, m_meshletTriangles);
+        endPartition();
+    }
+    m_indices = uniqueVertexIndices;
+
+
+    // convert data so it can be fed into ComputeCullData()
+    std::vector<PackedTriangle> triangles(m_meshletTriangles.size());
+    for (int i = 0; i < triangles.size(); i++)
+    {
+        auto packed = m_meshletTriangles[i];
+        triangles[i].indices.i0 = static_cast<uint8_t>(packed);
+        triangles[i].indices.i1 = static_cast<uint8_t>(packed >> 8);
+        triangles[i].indices.i2 = static_cast<uint8_t>(packed >> 16);
+    }
+
+
+    m_cullData.resize(m_meshlets.size());
+
+    checkResult(ComputeCullData(
+        reinterpret_cast<const DirectX::XMFLOAT3*>(m_positions.data()),
+        m_positions.size(),
+        m_meshlets.data(),
+        m_meshlets.size(),
+        m_indices.data(),
+        triangles.data(),
+        DirectX::CNORM_DEFAULT,
+        m_cullData.data()
+    ));
+}
+
+void MeshGeometry::meshletizeNvidia()
+{
+    optimizeVertexCache();
+    std::vector<uint32_t> uniqueVertexIndices;
+    std::vector<uint32_t> indicesMapping;
+    startPartition();
+    {
+        PROFILE_ZONE("NV meshletizing");
+        meshletizers::nvidia::meshletize(m_MeshletMaxVerts, m_MeshletMaxPrims, m_indices, m_vertices, m_meshlets, uniqueVertexIndices, m_meshletTriangles);
+    }
+    endPartition();
+    m_indices = uniqueVertexIndices;
+
+
+    // convert data so it can be fed into ComputeCullData()
+    std::vector<PackedTriangle> triangles(m_meshletTriangles.size());
+    for (int i = 0; i < triangles.size(); i++)
+    {
+        auto packed = m_meshletTriangles[i];
+        triangles[i].indices.i0 = static_cast<uint8_t>(packed);
+        triangles[i].indices.i1 = static_cast<uint8_t>(packed >> 8);
+        triangles[i].indices.i2 = static_cast<uint8_t>(packed >> 16);
+    }
+
+
+    m_cullData.resize(m_meshlets.size());
+
+    checkResult(ComputeCullData(
+        reinterpret_cast<const DirectX::XMFLOAT3*>(m_positions.data()),
+        m_positions.size(),
+        m_meshlets.data(),
+        m_meshlets.size(),
+        m_indices.data(),
+        triangles.data(),
+        DirectX::CNORM_DEFAULT,
+        m_cullData.data()
+    ));
+}
+
+
+void MeshGeometry::meshletizeCost()
+{
+    if (m_intermediates.adjacency.trianglesPerVertex.empty())
+    {
+        PROFILE_ZONE("Adjacency build");
+        meshletizers::nvidia::buildAdjacency(static_cast<uint32_t>(m_vertices.size()), static_cast<uint32_t>(m_indices.size()), m_indices, m_intermediates.adjacency);
+    }
+    std::vector<uint32_t> uniqueVertexIndices;
+    startPartition();
+    {
+        PROFILE_ZONE("Cost meshletizing");
+        meshletizers::cost::meshletize(m_MeshletMaxVerts, m_MeshletMaxPrims, m_costWeights, m_intermediates.adjacency, m_indices, m_vertices, m_meshlets, uniqueVertexIndices, m_meshletTriangles);
+    }
+    endPartition();
+    m_indices = uniqueVertexIndices;
+
+
+    // convert data so it can be fed into ComputeCullData()
+    std::vector<PackedTriangle> triangles(m_meshletTriangles.size());
+    for (int i = 0; i < triangles.size(); i++)
+    {
+        auto packed = m_meshletTriangles[i];
+        triangles[i].indices.i0 = static_cast<uint8_t>(packed);
+        triangles[i].indices.i1 = static_cast<uint8_t>(packed >> 8);
+        triangles[i].indices.i2 = static_cast<uint8_t>(packed >> 16);
+    }
+
+
+    m_cullData.resize(m_meshlets.size());
+
+    checkResult(ComputeCullData(
+        reinterpret_cast<const DirectX::XMFLOAT3*>(m_positions.data()),
+        m_positions.size(),
+        m_meshlets.data(),
+        m_meshlets.size(),
+        m_indices.data(),
+        triangles.data(),
+        DirectX::CNORM_DEFAULT,
+        m_cullData.data()
+    ));
+}
+
+
+void MeshGeometry::optimizeVertexCache()
+{
+    if (m_vertexCacheOptimizer == VCACHE_NONE)
+        return;
+
+    std::vector<uint32_t>& optimizedIndices = m_intermediates.optimizedIndices[m_vertexCacheOptimizer];
+    if (optimizedIndices.empty())
+    {
+        PROFILE_ZONE("Vertex cache optimization");
+        meshletizers::vcache::optimize(m_vertexCacheOptimizer, m_indices, m_vertices.size(), optimizedIndices);
+    }
+    m_indices = optimizedIndices;
+}
+
+void MeshGeometry::remeshletize(MeshletizerType type, int32_t maxVerts, int32_t maxPrims, VertexCacheOptimizer vertexCacheOptimizer)
+{
+    PROFILE_ZONE("Remeshletize");
+    assert(canRemeshletize());
+
+    m_type = type;
+    m_MeshletMaxVerts = maxVerts;
+    m_MeshletMaxPrims = maxPrims;
+    m_vertexCacheOptimizer = vertexCacheOptimizer;
+
+    restoreSourceVertices();
+    m_indices = m_sourceIndices;
+    m_meshlets.clear();
+    m_meshletTriangles.clear();
+    m_cullData.clear();
+    m_bvhNodes.clear();
+    m_subsets.clear();
+    // Built on top of the old meshlets
+    m_clusterDAG = {};
+
+    meshletize();
+}
+
+void MeshGeometry::meshletize()
+{
+    if (m_type == MESHOPT)
+        meshletizeMeshoptimizer();
+    else if (m_type == DXMESH)
+        meshletizeDXMESH();
+    else if (m_type == GREEDY)
+        meshletizeGreedy();
+    else if (m_type == BSPHERE)
+        meshletizeBoundingSphere();
+    else if (m_type == NVIDIA)
+        meshletizeNvidia();
+    else if (m_type == COST)
+        meshletizeCost();
+
+    buildBVH();
+
+    if (m_vertexReorder.enabled)
+        reorderVertices();
+
+    m_indexBytes = getIndexBytes(m_vertices.size());
+
+    generateSubsets();
+}
+
+void MeshGeometry::buildBVH()
+{
+    PROFILE_ZONE("Meshlet BVH build");
+    culling::buildMeshletBVH(m_meshlets, m_cullData, m_bvhNodes);
+}
+
+void MeshGeometry::reorderVertices()
+{
+    PROFILE_ZONE("Vertex reorder");
+
+    const float localityBefore = meshletizers::reorder::computeFetchLocality(m_meshlets, m_indices, sizeof(Vertex));
+    const size_t verticesBefore = m_vertices.size();
+
+    std::vector<uint32_t> sourceVertices;
+    meshletizers::reorder::reorderVertices(m_meshlets, m_indices, static_cast<uint32_t>(m_vertices.size()), m_vertexReorder.duplicationThreshold, sourceVertices);
+    meshletizers::reorder::remapVertexStream(m_vertices, sourceVertices);
+    meshletizers::reorder::remapVertexStream(m_positions, sourceVertices);
+    meshletizers::reorder::remapVertexStream(m_normals, sourceVertices);
+    meshletizers::reorder::remapVertexStream(m_UVs, sourceVertices);
+    if (m_sourceVertexMap.empty())
+        m_sourceVertexMap = sourceVertices;
+    else
+        meshletizers::reorder::remapVertexStream(m_sourceVertexMap, sourceVertices);
+
+    const float localityAfter = meshletizers::reorder::computeFetchLocality(m_meshlets, m_indices, sizeof(Vertex));
+    const int64_t memoryDelta = (static_cast<int64_t>(m_vertices.size()) - static_cast<int64_t>(verticesBefore)) * static_cast<int64_t>(sizeof(Vertex));
+
+    printf("=========VERTEX REORDER=========\n");
+    printf("Fetch locality: %f -> %f \n", localityBefore, localityAfter);
+    printf("Vertices: %zu -> %zu \n", verticesBefore, m_vertices.size());
+    printf("Vertex buffer delta: %lld bytes \n", static_cast<long long>(memoryDelta));
+}
+
+void MeshGeometry::restoreSourceVertices()
+{
+    if (m_sourceVertexMap.empty())
+        return;
+
+    meshletizers::reorder::restoreVertexStream(m_vertices, m_sourceVertexMap, m_sourceVertexCount);
+    meshletizers::reorder::restoreVertexStream(m_positions, m_sourceVertexMap, m_sourceVertexCount);
+    meshletizers::reorder::restoreVertexStream(m_normals, m_sourceVertexMap, m_sourceVertexCount);
+    meshletizers::reorder::restoreVertexStream(m_UVs, m_sourceVertexMap, m_sourceVertexCount);
+    m_sourceVertexMap.clear();
+}
+
+void MeshGeometry::buildClusterDAG()
+{
+    PROFILE_ZONE("Cluster DAG build");
+    lod::buildClusterDAG(m_meshlets, m_indices, m_meshletTriangles, m_positions, m_MeshletMaxVerts, m_MeshletMaxPrims, m_clusterDAG);
+
+    printf("=========CLUSTER DAG=========\n");
+    printf("Levels: %u \n", m_clusterDAG.levelCount);
+    printf("Clusters: %zu \n", m_clusterDAG.clusters.size());
+    printf("Triangles: %zu \n", m_clusterDAG.triangles.size());
+}
+
+void MeshGeometry::generateSubsets()
+{
+    int meshletsNumber = m_meshlets.size();
+    int subsetsNumber = hlsl::divRoundUp(meshletsNumber, 65535);
+    for (int i = 0; i < subsetsNumber; i++)
+    {
+        MeshSubset subset;
+        subset.offset = i * 65535;
+        subset.size = ((subset.offset + 65535) > meshletsNumber) ? meshletsNumber - subset.offset : 65535;
+        m_subsets.push_back(subset);
+    }
+}
+
+void MeshGeometry::startPartition()
+{
+    m_partitionStart = std::chrono::high_resolution_clock::now();
+}
+
+void MeshGeometry::endPartition()
+{
+    m_partitionTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - m_partitionStart);
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <chrono>
+#include <vector>
+
+#include "DX12Wrappers/Vertex.h"
+#include "DXMeshletGenerator/MeshletTypes.h"
+#include "MeshletStructs.h"
+#include "GreedyMeshletizer/meshletizerCommon.h"
+#include "GreedyMeshletizer/nvMeshletizer.h"
+#include "Culling/MeshletBVH.h"
+#include "LOD/ClusterDAG.h"
+
+/*
+ * Meshletizer inputs that depend only on the source triangles, never on limits or the partition itself.
+ * Everything is built on first use, so changing limits or switching meshletizers only reruns the partition.
+ */
+struct MeshletizerIntermediates
+{
+    // Source triangles in the order of each vertex cache optimizer, VCACHE_NONE is m_sourceIndices itself
+    std::vector<uint32_t> optimizedIndices[VCACHE_COUNT];
+
+    // GREEDY/BSPHERE graph and vertex order, valid for optimizedIndices[graphOptimizer]
+    meshletizers::MeshGraph graph;
+    VertexCacheOptimizer graphOptimizer = VCACHE_COUNT;
+
+    // COST vertex -> triangle adjacency of the source triangles
+    meshletizers::nvidia::AdjacencyInfo adjacency;
+
+    // DXMESH cleaned, material sorted and LRU optimized triangles with their material subsets
+    std::vector<uint32_t> dxmeshIndices;
+    std::vector<Subset> dxmeshSubsets;
+};
+
+
+/*
+ * CPU half of a mesh: vertex streams, meshlets and everything built on them, never touches the device.
+ * Mesh adds GPU resources on top, headless tools like the meshlet sweep use this one directly.
+ */
+class MeshGeometry
+{
+public:
+    MeshGeometry(std::vector<Vertex> const& vertices,
+        std::vector<uint32_t> const&  indices,
+        std::vector<hlsl::float3> const& positions,
+        std::vector<hlsl::float3> const& normals,
+        std::vector<hlsl::float2> const& UVS,
+        std::vector<uint32_t> const& attributes,
+        MeshletizerType meshletizerType,
+        int32_t maxVerts,
+        int32_t maxPrims,
+        VertexReorderSettings const& vertexReorder = {},
+        MeshletCostWeights const& costWeights = {},
+        VertexCacheOptimizer vertexCacheOptimizer = VCACHE_NONE);
+
+    MeshGeometry(std::vector<Vertex> const& vertices,
+        std::vector<uint32_t> const&  indices,
+        std::vector<hlsl::float3> const& positions,
+        std::vector<hlsl::float3> const& normals,
+        std::vector<hlsl::float2> const& UVS,
+        std::vector<uint32_t> const& attributes,
+        MeshletizerType meshletizerType,
+        int32_t maxVerts,
+        int32_t maxPrims,
+        std::vector<Meshlet> const& meshlets,
+        std::vector<uint32_t> const& meshletTriangles,
+        std::vector<CullData> const&  cullData,
+        std::vector<culling::MeshletBVHNode> const& bvhNodes);
+
+    void meshletizeDXMESH();
+    void meshletizeMeshoptimizer();
+    void meshletizeGreedy();
+    void meshletizeBoundingSphere();
+    void meshletizeNvidia();
+    void meshletizeCost();
+    // Reorders m_indices triangles with m_vertexCacheOptimizer
+    void optimizeVertexCache();
+
+    // Meshes loaded from cache keep only meshlet data and have to be rebuilt from the model instead
+    bool canRemeshletize() const { return !m_sourceIndices.empty(); }
+
+    /*
+     * Throws away meshlets and everything built on them, then partitions the source triangles again.
+     * Reuses m_intermediates, GPU resources have to be released before and uploaded again after.
+     */
+    void remeshletize(MeshletizerType type, int32_t maxVerts, int32_t maxPrims, VertexCacheOptimizer vertexCacheOptimizer);
+
+    // Reorders meshlets and cull data, has to run before GPU resources are created
+    void buildBVH();
+
+    // Offline stage, slow for big meshes
+    void buildClusterDAG();
+
+    // Rewrites vertex streams in meshlet first use order, has to run after meshlets are final
+    void reorderVertices();
+
+    // Partition step of the last meshletize, without vertex cache optimization, adjacency and cull data
+    std::chrono::nanoseconds getPartitionTime() const { return m_partitionTime; }
+
+
+    std::vector<Vertex> m_vertices;
+    std::vector<uint32_t> m_indices;
+    // Triangles the mesh was built from, in source vertex numbering. Empty for meshes loaded from cache
+    std::vector<uint32_t> m_sourceIndices;
+    std::vector<CullData> m_cullData;
+
+    std::vector<Meshlet> m_meshlets;
+    std::vector<uint32_t> m_meshletTriangles;
+
+    std::vector<uint32_t> m_attributes;
+
+    std::vector<hlsl::float3> m_positions;
+    std::vector<hlsl::float3> m_normals;
+    std::vector<hlsl::float2> m_UVs;
+
+    std::vector<MeshSubset> m_subsets;
+
+    std::vector<culling::MeshletBVHNode> m_bvhNodes;
+
+    lod::ClusterDAG m_clusterDAG;
+
+    int32_t m_MeshletMaxVerts = 64;
+    int32_t m_MeshletMaxPrims = 124;
+
+    MeshletizerType m_type = MESHOPT;
+    VertexReorderSettings m_vertexReorder;
+    // Bytes per entry of the index buffer, see getIndexBytes()
+    uint32_t m_indexBytes = sizeof(uint32_t);
+    MeshletCostWeights m_costWeights;
+    // Only used by the meshletizers that consume triangles in order, see usesVertexCacheOptimizer()
+    VertexCacheOptimizer m_vertexCacheOptimizer = VCACHE_NONE;
+
+    // Object space simplification error, 0 for the source mesh
+    float m_lodError = 0.0f;
+
+private:
+    // Runs m_type meshletizer on m_indices and everything that depends on its meshlets
+    void meshletize();
+    void generateSubsets();
+    // Brings vertex streams back to source numbering after reorderVertices()
+    void restoreSourceVertices();
+    // Around the partition call of every meshletizer
+    void startPartition();
+    void endPartition();
+
+    MeshletizerIntermediates m_intermediates;
+    // Current vertex -> source vertex, empty while vertex streams are in source order
+    std::vector<uint32_t> m_sourceVertexMap;
+    uint32_t m_sourceVertexCount = 0;
+    std::chrono::high_resolution_clock::time_point m_partitionStart;
+    std::chrono::nanoseconds m_partitionTime = {};
+};
@@ -1,9 +1,90 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+
 enum MeshletizerType
 {
     MESHOPT,
     DXMESH,
     GREEDY,
     BSPHERE,
-    NVIDIA
-};
\ No newline at end of file
+    NVIDIA,
+    COST,
+    MESHLETIZER_TYPE_COUNT
+};
+
+inline const char* getMeshletizerName(MeshletizerType type)
+{
+    const char* names[] = { "MESHOPTIMIZER", "DXMESH", "GREEDY", "BoundingSphere", "NVIDIA", "COST" };
+    return type < MESHLETIZER_TYPE_COUNT ? names[type] : "UNKNOWN";
+}
+
+// Triangle reordering run before the meshletizers that consume triangles in index buffer order
+enum VertexCacheOptimizer
+{
+    VCACHE_NONE,
+    VCACHE_TIPSIFY,
+    VCACHE_FORSYTH,
+    VCACHE_MESHOPT,
+    VCACHE_COUNT
+};
+
+inline bool usesVertexCacheOptimizer(MeshletizerType type)
+{
+    return type == GREEDY || type == BSPHERE || type == NVIDIA;
+}
+
+inline VertexCacheOptimizer getDefaultVertexCacheOptimizer(MeshletizerType type)
+{
+    if (type == NVIDIA)
+        return VCACHE_TIPSIFY;
+    return usesVertexCacheOptimizer(type) ? VCACHE_MESHOPT : VCACHE_NONE;
+}
+
+struct MeshSubset
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct VertexReorderSettings
+{
+    bool enabled = false;
+    // Max fraction of a meshlet's vertices that can be duplicated to make it contiguous
+    float duplicationThreshold = 0.25f;
+};
+
+// Weights of the COST meshletizer, higher weight means the term matters more when picking the next triangle
+struct MeshletCostWeights
+{
+    float newVertices = 1.0f;  // fewer new vertices, fewer meshlets
+    float sphereGrowth = 1.0f; // tighter bounding spheres
+    float coneSpread = 1.0f;   // narrower normal cones, better backface culling
+};
+
+// Width of the uploaded meshlet vertex indices, 16 bits whenever every vertex of the mesh can be addressed with them
+inline uint32_t getIndexBytes(size_t vertexCount)
+{
+    return vertexCount <= static_cast<size_t>(UINT16_MAX) + 1 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+// meshopt_buildMeshlets asserts on more vertices and on triangle limits that aren't a multiple of 4
+static const int32_t MESHOPT_MAX_MESHLET_VERTICES = 255;
+static const int32_t MESHOPT_MESHLET_TRIANGLE_GRANULARITY = 4;
+
+inline bool fitsMeshoptimizerLimits(int32_t maxVerts, int32_t maxPrims)
+{
+    return maxVerts >= 3 && maxVerts <= MESHOPT_MAX_MESHLET_VERTICES &&
+        maxPrims >= MESHOPT_MESHLET_TRIANGLE_GRANULARITY && maxPrims % MESHOPT_MESHLET_TRIANGLE_GRANULARITY == 0;
+}
+
+// DispatchMesh accepts at most 65535 groups per dimension and 2^22 groups in total
+static const uint32_t MAX_DISPATCH_GROUPS_PER_DIMENSION = 65535;
+static const uint32_t MAX_DISPATCH_GROUPS = 1u << 22;
+
+// Instances that fit into group Y of one dispatch with groupsPerInstance groups along X
+inline uint32_t getMaxInstancesPerDispatch(uint32_t groupsPerInstance)
+{
+    uint32_t const byTotal = MAX_DISPATCH_GROUPS / (groupsPerInstance > 0 ? groupsPerInstance : 1);
+    return byTotal < MAX_DISPATCH_GROUPS_PER_DIMENSION ? byTotal : MAX_DISPATCH_GROUPS_PER_DIMENSION;
+}
@@ -1,5 +1,9 @@
 #include "Model.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
 #include <DirectXMath.h>
 #include <filesystem>
 #include <imgui.h>
@@ -19,15 +23,34 @@
 
 #include "Input.h"
 #include "Serialization/MeshSerializer.h"
+#include "Serialization/ClusterDAGSerializer.h"
+#include "LOD/DiscreteLOD.h"
 #include "utils/Utils.h"
 
 #include "DX12Wrappers/ConstantBuffer.h"
+#include "DX12Wrappers/ConstantBufferRing.h"
+#include "DX12Wrappers/FramePacer.h"
+#include "DX12Wrappers/FrameStructuredBuffer.h"
+#include "DX12Wrappers/MeshBufferPool.h"
+#include "DX12Wrappers/ParallelRecorder.h"
+#include "DX12Wrappers/UploadManager.h"
 #include "ResourceLoaders/ResourceManager.h"
+#include "Tools/PerformanceCounters.h"
 #include "Tools/GPUProfiler.h"
 #include "Tools/MeshletBenchmark.h"
 
 using namespace Microsoft::WRL;
 
+namespace
+{
+    // Visible instances are uploaded every frame through the shared ConstantBufferRing and every frame in flight
+    // keeps its copy. Half of the ring is left for the constant buffers and indirect arguments of the same frames
+    int32_t maxInstanceGridSize()
+    {
+        uint64_t const maxInstances = ConstantBufferRing::SIZE / 2 / (sizeof(InstanceTransform) * FramePacer::MAX_FRAMES_IN_FLIGHT);
+        return static_cast<int32_t>(std::sqrt(static_cast<double>(maxInstances)));
+    }
+}
 
 
 Model* Model::create(std::string const& model_path)
@@ -35,6 +58,10 @@ Model* Model::create(std::string const& model_path)
 
     Model* model = new Model();
     model->m_path = model_path;
+    for (int32_t i = 0; i < MESHLETIZER_TYPE_COUNT; i++)
+    {
+        model->m_vertexCacheOptimizers[i] = getDefaultVertexCacheOptimizer(static_cast<MeshletizerType>(i));
+    }
     if (!model->deserializeMeshes())
     {
         model->loadModel(model_path);
@@ -51,24 +78,43 @@ Model* Model::create(std::string const& model_path)
 #endif
     model->m_sceneConstantBuffer = new ConstantBuffer<SceneConstantBuffer>("InstanceData");
     model->m_cameraConstantBuffer = new ConstantBuffer<CameraConstants>("CameraData");
+    model->m_instanceBuffer = new FrameStructuredBuffer<InstanceTransform>("Instances");
     MeshletBenchmark::getInstance()->setModel(model);
     return model;
 }
 
+void Model::prepareDraw()
+{
+    auto camera = Camera::getMainCamera();
+    m_drawView.view = camera->getViewMatrix();
+    m_drawView.projection = camera->getProjectionMatrix();
+    m_drawView.entityWorld = entity->transform->get_model_matrix();
+    m_drawView.cameraPosition = camera->getCullingPosition();
+    auto const& frustum = camera->getFrustum();
+    m_drawView.planes[0] = frustum.top_plane;
+    m_drawView.planes[1] = frustum.bottom_plane;
+    m_drawView.planes[2] = frustum.right_plane;
+    m_drawView.planes[3] = frustum.left_plane;
+    m_drawView.planes[4] = frustum.far_plane;
+    m_drawView.planes[5] = frustum.near_plane;
+    m_drawView.projectionScale = lod::computeProjectionScale(camera->getFov(), camera->getHeight());
+    m_drawView.time = ImGui::GetTime();
+    m_drawView.drawFlag = Renderer::get_instance()->get_debug_mode();
+}
+
 void Model::setConstantBuffer()
 {
-    hlsl::float4x4 view = Camera::getMainCamera()->getViewMatrix();
-    hlsl::float4x4 projection = Camera::getMainCamera()->getProjectionMatrix();
-    hlsl::float4x4 world = entity->transform->get_model_matrix();
-    hlsl::float4x4 mvpMatrix = projection * view;
+    hlsl::float4x4 const& view = m_drawView.view;
+    hlsl::float4x4 const& world = m_drawView.entityWorld;
+    hlsl::float4x4 mvpMatrix = m_drawView.projection * view;
     mvpMatrix = mvpMatrix * world;
 
     m_sceneConstantBufferData.World = hlsl::transpose(world);
     m_sceneConstantBufferData.WorldView = hlsl::transpose(world * view);
     m_sceneConstantBufferData.WorldViewProj = hlsl::transpose(mvpMatrix);
-    m_sceneConstantBufferData.DrawFlag = Renderer::get_instance()->get_debug_mode();
+    m_sceneConstantBufferData.DrawFlag = m_drawView.drawFlag;
 
-    m_sceneConstantBufferData.time = ImGui::GetTime();
+    m_sceneConstantBufferData.time = m_drawView.time;
     m_sceneConstantBuffer->uploadData(m_sceneConstantBufferData);
 
     if (m_MeshletMaxVerts > 128 || m_MeshletMaxPrims > 128)
@@ -77,14 +123,11 @@ void Model::setConstantBuffer()
         m_sceneConstantBuffer->setConstantBuffer(m_smallMeshletPipelineState);
 
 
-    m_cameraConstants.CullViewPosition = Camera::getMainCamera()->getCullingPosition();
-    auto const frustum = Camera::getMainCamera()->getFrustum();
-    m_cameraConstants.Planes[0] = frustum.top_plane;
-    m_cameraConstants.Planes[1] = frustum.bottom_plane;
-    m_cameraConstants.Planes[2] = frustum.right_plane;
-    m_cameraConstants.Planes[3] = frustum.left_plane;
-    m_cameraConstants.Planes[4] = frustum.far_plane;
-    m_cameraConstants.Planes[5] = frustum.near_plane;
+    m_cameraConstants.CullViewPosition = m_drawView.cameraPosition;
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        m_cameraConstants.Planes[i] = m_drawView.planes[i];
+    }
     m_cameraConstantBuffer->uploadData(m_cameraConstants);
 
     if (m_MeshletMaxVerts > 128 || m_MeshletMaxPrims > 128)
@@ -97,73 +140,315 @@ void Model::setConstantBuffer()
 
 void Model::draw()
 {
-    auto cmd_list = Renderer::get_instance()->g_pd3dCommandList;
+    auto cmd_list = Renderer::get_instance()->get_command_list();
     auto profiler = GPUProfiler::getInstance();
 
-    if(m_MeshletMaxVerts > 128 || m_MeshletMaxPrims > 128)
+    PipelineState* const pso = m_MeshletMaxVerts > 128 || m_MeshletMaxPrims > 128 ? m_bigMeshletPipelineState : m_smallMeshletPipelineState;
+    cmd_list->SetGraphicsRootSignature(pso->dx12RootSignature());
+    cmd_list->SetPipelineState(pso->PSO());
+    setConstantBuffer();
+    hlsl::float4x4 world;
+    uint32_t const instanceCount = updateInstances(pso, world);
+    if (instanceCount == 0)
+        return;
+
+    m_currentLODs.resize(m_meshes.size());
+    bool const merged = m_mergedVertexResource != nullptr;
+    bool const indirect = merged && m_useIndirectDispatch;
+    m_mergedDispatches.clear();
+    m_indirectArguments.clear();
+    m_indirectVisibility.clear();
+
+    static const uint32_t modelDrawName = profiler->internName("Model Draw");
+    auto const entry = profiler->startEntry(cmd_list, modelDrawName);
+    {
+        for (uint32_t i = 0; i < m_meshes.size(); i++)
+        {
+            m_currentLODs[i] = selectLOD(i, world, m_drawView.cameraPosition, m_drawView.projectionScale);
+            Mesh* mesh = m_currentLODs[i] == 0 ? m_meshes[i] : m_meshLODs[i][m_currentLODs[i] - 1];
+            if (indirect)
+                collectIndirectCommands(mesh, m_mergedRanges[m_mergedRangeIndices[i][m_currentLODs[i]]], world, instanceCount);
+            else if (merged)
+                collectMergedRanges(mesh, m_mergedRanges[m_mergedRangeIndices[i][m_currentLODs[i]]], world, instanceCount);
+            else
+                mesh->dispatch(pso, world, m_drawView.planes, instanceCount);
+        }
+
+        if (indirect)
+            dispatchIndirect(pso);
+        else if (merged)
+            dispatchMerged(pso, instanceCount);
+    } profiler->endEntry(cmd_list, entry);
+}
+
+uint32_t Model::updateInstances(PipelineState* pso, hlsl::float4x4& referenceWorld)
+{
+    hlsl::float4x4 const& view = m_drawView.view;
+    hlsl::float4x4 const& projection = m_drawView.projection;
+    hlsl::float4x4 const& entityWorld = m_drawView.entityWorld;
+    hlsl::float3 const cameraPosition = m_drawView.cameraPosition;
+
+    uint32_t const instanceCount = m_instanceTransforms.empty() ? 1 : static_cast<uint32_t>(m_instanceTransforms.size());
+    m_visibleInstances.clear();
+    float nearestDistance = FLT_MAX;
+    referenceWorld = entityWorld;
+    for (uint32_t i = 0; i < instanceCount; i++)
     {
-        cmd_list->SetGraphicsRootSignature(m_bigMeshletPipelineState->dx12RootSignature());
-        cmd_list->SetPipelineState(m_bigMeshletPipelineState->PSO());
+        hlsl::float4x4 const world = m_instanceTransforms.empty() ? entityWorld : entityWorld * m_instanceTransforms[i];
+        if (m_cullInstances && m_boundingSphere.w >= 0.0f && !culling::isSphereVisible(m_boundingSphere, m_drawView.planes, world))
+            continue;
+
+        InstanceTransform instance;
+        instance.World = hlsl::transpose(world);
+        instance.WorldView = hlsl::transpose(world * view);
+        instance.WorldViewProj = hlsl::transpose(projection * view * world);
+        m_visibleInstances.push_back(instance);
+
+        // LODs are picked once for all instances, the nearest one decides so no instance gets coarser than it should
+        hlsl::float4 const center = world * hlsl::float4(m_boundingSphere.x, m_boundingSphere.y, m_boundingSphere.z, 1.0f);
+        float const distance = hlsl::length(hlsl::float3(center.x, center.y, center.z) - cameraPosition);
+        if (distance < nearestDistance)
+        {
+            nearestDistance = distance;
+            referenceWorld = world;
+        }
     }
-    else
+
+    if (m_visibleInstances.empty())
+        return 0;
+
+    m_instanceBuffer->uploadData(m_visibleInstances.data(), static_cast<uint32_t>(m_visibleInstances.size()));
+    m_instanceBuffer->setShaderResource(pso);
+    return static_cast<uint32_t>(m_visibleInstances.size());
+}
+
+void Model::generateInstanceGrid()
+{
+    m_instanceTransforms.clear();
+    if (m_instanceGridSize <= 1)
+        return;
+
+    // Centered on the entity, rows along X and columns along Z
+    float const halfExtent = 0.5f * m_instanceSpacing * (m_instanceGridSize - 1);
+    for (int32_t z = 0; z < m_instanceGridSize; z++)
     {
-        cmd_list->SetGraphicsRootSignature(m_smallMeshletPipelineState->dx12RootSignature());
-        cmd_list->SetPipelineState(m_smallMeshletPipelineState->PSO());
+        for (int32_t x = 0; x < m_instanceGridSize; x++)
+        {
+            hlsl::float3 const offset(x * m_instanceSpacing - halfExtent, 0.0f, z * m_instanceSpacing - halfExtent);
+            m_instanceTransforms.push_back(hlsl::translation(offset));
+        }
     }
-    setConstantBuffer();
-    auto const entry = profiler->startEntry(cmd_list, "Model Draw");
+}
+
+void Model::collectMergedRanges(Mesh* mesh, geometry::MergedMeshRange const& range, hlsl::float4x4 const& world, uint32_t instanceCount)
+{
+#ifdef CULLING
+    // Instances don't share a world matrix, with more than one the AS culls every meshlet of every instance
+    if (instanceCount == 1)
     {
-        for (auto& mesh : m_meshes)
+        mesh->m_visibleRanges.clear();
+        culling::cullMeshletBVH(mesh->m_bvhNodes, m_drawView.planes, world, mesh->m_visibleRanges);
+        for (auto const& visible : mesh->m_visibleRanges)
         {
-            if (m_MeshletMaxVerts > 128 || m_MeshletMaxPrims > 128)
-            {
-                mesh->dispatch(m_bigMeshletPipelineState);
-            }
-            else
-            {
-                mesh->dispatch(m_smallMeshletPipelineState);
-            }
+            m_mergedDispatches.push_back({ range.meshletOffset + visible.offset, visible.size });
         }
-    } profiler->endEntry(cmd_list, entry);
+        return;
+    }
+#endif
+    for (auto const& subset : mesh->m_subsets)
+    {
+        m_mergedDispatches.push_back({ range.meshletOffset + subset.offset, subset.size });
+    }
+}
+
+void Model::bindMergedGeometry(PipelineState* pso)
+{
+    if (!m_mergedBindingTable.isBuiltFor(pso))
+    {
+        m_mergedBindingTable.begin(pso);
+        m_mergedBindingTable.addShaderResource("Vertices", m_mergedVertexResource->getGPUVirtualAddress());
+        m_mergedBindingTable.addShaderResource("Meshlets", m_mergedMeshletResource->getGPUVirtualAddress());
+        m_mergedBindingTable.addShaderResource("IndexBuffer", m_mergedIndexResource->getGPUVirtualAddress());
+        m_mergedBindingTable.addShaderResource("LocalIndexBuffer", m_mergedTriangleResource->getGPUVirtualAddress());
+        m_mergedBindingTable.addShaderResource("meshletcullData", m_mergedCullDataResource->getGPUVirtualAddress());
+    }
+    m_mergedBindingTable.apply(Renderer::get_instance()->get_command_list());
+}
+
+void Model::dispatchMerged(PipelineState* pso, uint32_t instanceCount)
+{
+    auto cmd_list = Renderer::get_instance()->get_command_list();
+
+    // DispatchMesh accepts at most 65535 groups per dimension
+    geometry::coalesceRanges(m_mergedDispatches, Mesh::MESHLETS_PER_GROUP * MAX_DISPATCH_GROUPS_PER_DIMENSION);
+    bindMergedGeometry(pso);
+
+    if (m_mergedMeshInfoBuffer == nullptr)
+        m_mergedMeshInfoBuffer = new ConstantBuffer<MeshInfo>("MeshInfo");
+
+    static const uint32_t dispatchName = GPUProfiler::getInstance()->internName("Dispatch Merged");
+    auto profilerEntry = GPUProfiler::getInstance()->startEntry(cmd_list, dispatchName);
+    {
+        for (auto const& range : m_mergedDispatches)
+        {
+            Mesh::dispatchRange(m_mergedMeshInfoBuffer, pso, m_mergedIndexBytes, range, instanceCount);
+        }
+    } GPUProfiler::getInstance()->endEntry(cmd_list, profilerEntry);
+}
+
+void Model::collectIndirectCommands(Mesh* mesh, geometry::MergedMeshRange const& range, hlsl::float4x4 const& world, uint32_t instanceCount)
+{
+    m_mergedDispatches.clear();
+    collectMergedRanges(mesh, range, world, instanceCount);
+    indirect::appendCommands(m_mergedDispatches, m_mergedIndexBytes, Mesh::MESHLETS_PER_GROUP, instanceCount, m_indirectArguments);
+
+    // A single instance is tested per mesh, root of the meshlet hierarchy bounds the mesh.
+    // Several instances were already culled against the whole model's bounds
+    bool visible = true;
+    if (instanceCount == 1 && !mesh->m_bvhNodes.empty())
+    {
+        visible = culling::isSphereVisible(mesh->m_bvhNodes[0].boundingSphere, m_drawView.planes, world);
+    }
+    m_indirectVisibility.resize(m_indirectArguments.count(), visible ? 1 : 0);
+}
+
+void Model::dispatchIndirect(PipelineState* pso)
+{
+    auto cmd_list = Renderer::get_instance()->get_command_list();
+
+    indirect::compactCommands(m_indirectVisibility, m_indirectArguments);
+    bindMergedGeometry(pso);
+
+    static const uint32_t dispatchName = GPUProfiler::getInstance()->internName("Dispatch Indirect");
+    auto profilerEntry = GPUProfiler::getInstance()->startEntry(cmd_list, dispatchName);
+    {
+        m_indirectDispatcher.execute(pso, m_indirectArguments);
+    } GPUProfiler::getInstance()->endEntry(cmd_list, profilerEntry);
+}
+
+uint32_t Model::selectLOD(uint32_t meshIndex, hlsl::float4x4 const& world, hlsl::float3 const& cameraPosition, float projectionScale)
+{
+    Mesh const* mesh = m_meshes[meshIndex];
+    auto const& lods = m_meshLODs[meshIndex];
+    // Benchmarks compare meshletizers, every frame has to draw the same source geometry
+    if (!m_useLODs || MeshletBenchmark::getInstance()->isRunning() || lods.empty() || mesh->m_bvhNodes.empty())
+        return 0;
+
+    // Root of the meshlet hierarchy already bounds the whole mesh
+    hlsl::float4 const bounds = mesh->m_bvhNodes[0].boundingSphere;
+    hlsl::float4 const center = world * hlsl::float4(bounds.x, bounds.y, bounds.z, 1.0f);
+    hlsl::float4 const sphere = hlsl::float4(center.x, center.y, center.z, bounds.w * hlsl::maxScale(world));
+
+    m_lodErrors.clear();
+    m_lodErrors.push_back(mesh->m_lodError);
+    for (auto const& lodMesh : lods)
+    {
+        m_lodErrors.push_back(lodMesh->m_lodError);
+    }
+
+    float const projectedSize = lod::projectedSphereSize(sphere, cameraPosition, projectionScale);
+    return lod::selectLOD(projectedSize, bounds.w, m_lodErrors, m_lodErrorThreshold);
 }
 
 void Model::update()
 {
     Component::update();
 
+    prepareDraw();
+    ParallelRecorder::getInstance()->add(this);
+}
+
+void Model::record()
+{
     draw();
 }
 
+uint64_t Model::recordingCost() const
+{
+    // A dispatch per mesh at most, instance culling is a few matrix products per instance
+    uint64_t const instanceCount = m_instanceTransforms.empty() ? 1 : m_instanceTransforms.size();
+    return m_meshes.size() + instanceCount / 16 + 1;
+}
+
 void Model::drawEditor()
 {
     Component::drawEditor();
     ImGui::Text("Triangle count: %i", m_triangleCount);
     ImGui::Text("Vertex count: %i", m_vertexCount);
     ImGui::Text("Meshlet count: %i", m_meshletsCount);
+    auto const pool = MeshBufferPool::getInstance();
+    ImGui::Text("Mesh buffer pool: %.1f / %.1f MB in %u pages", pool->usedBytes() / (1024.0 * 1024.0), pool->reservedBytes() / (1024.0 * 1024.0), pool->pageCount());
+    if (ImGui::Checkbox("Merged geometry", &m_useMergedGeometry))
+    {
+        for (uint32_t i = 0; i < m_meshes.size(); i++)
+        {
+            m_meshes[i]->releaseGPUResources();
+            for (auto& lodMesh : m_meshLODs[i])
+            {
+                lodMesh->releaseGPUResources();
+            }
+        }
+        uploadGPUResources();
+    }
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Packs all meshes and LODs into shared buffers, the model then binds once and neighbouring meshes share dispatches.");
+    }
+    ImGui::BeginDisabled(!m_useMergedGeometry);
+    ImGui::Checkbox("Indirect dispatch", &m_useIndirectDispatch);
+    ImGui::EndDisabled();
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Needs merged geometry. Every mesh instance becomes an argument record, all of them submit with one ExecuteIndirect.");
+    }
 
-    const char* items[] = { "MESHOPTIMIZER", "DXMESH", "GREEDY", "BoundingSphere", "NVIDIA"};
+    const char* items[] = { "MESHOPTIMIZER", "DXMESH", "GREEDY", "BoundingSphere", "NVIDIA", "COST"};
     {
         ImGui::Separator();
         ImGui::Text("Meshletizer settings:");
 
         if (ImGui::Combo("MESHLET DEBUG MODE", &m_TypeIndex, items, IM_ARRAYSIZE(items)))
         {
-            MeshletizerType type = static_cast<MeshletizerType>(m_TypeIndex);
-            for (int j = 0; j < m_meshes.size(); j++)
-            {
-                ResourceManager::getInstance()->scheduleMeshForDeletion(m_meshes[j]);
-            }
-            m_meshes.clear();
-            m_vertexCount = 0;
-            m_triangleCount = 0;
-            m_meshletsCount = 0;
-            if (!deserializeMeshes())
-            {
-                loadModel(m_path);
-                serializeMeshes();
-            }
-            uploadGPUResources();
+            reloadMeshes();
+        }
+    }
+
+    if (m_TypeIndex == COST)
+    {
+        ImGui::DragFloat("New vertices weight", &m_costWeights.newVertices, 0.05f, 0.0f, 10.0f);
+        ImGui::DragFloat("Sphere growth weight", &m_costWeights.sphereGrowth, 0.05f, 0.0f, 10.0f);
+        ImGui::DragFloat("Cone spread weight", &m_costWeights.coneSpread, 0.05f, 0.0f, 10.0f);
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+        {
+            ImGui::SetTooltip("Higher vertex weight gives fewer meshlets, higher sphere and cone weights give better culling. Applied on next reload.");
+        }
+    }
+
+    if (usesVertexCacheOptimizer(static_cast<MeshletizerType>(m_TypeIndex)))
+    {
+        const char* optimizerItems[VCACHE_COUNT];
+        for (int32_t i = 0; i < VCACHE_COUNT; i++)
+        {
+            optimizerItems[i] = meshletizers::vcache::getName(static_cast<VertexCacheOptimizer>(i));
         }
+        int optimizerIndex = m_vertexCacheOptimizers[m_TypeIndex];
+        if (ImGui::Combo("Vertex cache optimizer", &optimizerIndex, optimizerItems, IM_ARRAYSIZE(optimizerItems)))
+        {
+            m_vertexCacheOptimizers[m_TypeIndex] = static_cast<VertexCacheOptimizer>(optimizerIndex);
+        }
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+        {
+            ImGui::SetTooltip("Triangle order fed to this meshletizer. Applied on next reload.");
+        }
+    }
+
+    if (ImGui::Button("Benchmark vertex cache optimizers"))
+    {
+        benchmarkVertexCacheOptimizers();
+    }
+    for (auto const& result : m_vertexCacheBenchmark)
+    {
+        ImGui::Text("%s: ACMR %.3f, %.2f ms", meshletizers::vcache::getName(result.optimizer), result.acmr, result.seconds * 1000.0f);
     }
 
     if(ImGui::Button("Update meshlet benchmark with this Model's metadata"))
@@ -173,37 +458,100 @@ void Model::drawEditor()
         MeshletBenchmark::getInstance()->updateModelPath(m_path);
     }
 
-    ImGui::InputInt("Max meshlet vertices", &m_MeshletMaxVerts);
-    ImGui::InputInt("Max meshlet primitives", &m_MeshletMaxPrims);
-    if (ImGui::Button("RELOAD"))
+    ImGui::Separator();
+    ImGui::Text("Instancing:");
+    static const int32_t maxGridSize = maxInstanceGridSize();
+    ImGui::InputInt("Instance grid size", &m_instanceGridSize);
+    m_instanceGridSize = std::clamp(m_instanceGridSize, 1, maxGridSize);
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("At most %i, instance transforms share the upload ring with every other per frame buffer.", maxGridSize);
+    }
+    ImGui::DragFloat("Instance spacing", &m_instanceSpacing, 0.5f, 0.0f, 1000.0f);
+    if (ImGui::Button("Generate instances"))
+    {
+        generateInstanceGrid();
+    }
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Size x size copies of the model around the entity, all drawn from the same meshlet data.");
+    }
+    ImGui::Checkbox("Cull instances", &m_cullInstances);
+    ImGui::Text("Visible instances: %u / %u", static_cast<uint32_t>(m_visibleInstances.size()), std::max(static_cast<uint32_t>(m_instanceTransforms.size()), 1u));
+
+    ImGui::Separator();
+    ImGui::Text("LOD:");
+    ImGui::Checkbox("Use discrete LODs", &m_useLODs);
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("LOD0 is always drawn while a benchmark runs.");
+    }
+    ImGui::InputInt("LOD count", &m_lodCount);
+    m_lodCount = std::max(m_lodCount, 1);
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Applied on next reload.");
+    }
+    ImGui::SliderFloat("LOD error threshold (px)", &m_lodErrorThreshold, 0.1f, 16.0f);
+    for (uint32_t i = 0; i < m_meshes.size() && i < m_currentLODs.size(); i++)
+    {
+        ImGui::Text("Mesh %u: LOD %u/%u", i, m_currentLODs[i], static_cast<uint32_t>(m_meshLODs[i].size()));
+    }
+
+    ImGui::Text("Cluster DAG:");
+    if (ImGui::Button("Build cluster DAG"))
     {
+        buildClusterDAGs();
+    }
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Loads cluster LOD hierarchy from disk. If not found, builds it from current meshlets.");
+    }
+
+    if (!m_meshes.empty() && !m_meshes[0]->m_clusterDAG.empty())
+    {
+        auto camera = Camera::getMainCamera();
+        float const projectionScale = lod::computeProjectionScale(camera->getFov(), camera->getHeight());
+        hlsl::float4x4 const world = entity->transform->get_model_matrix();
+        std::vector<uint32_t> selectedClusters;
+        uint32_t cutClusters = 0;
+        uint32_t cutTriangles = 0;
         for (auto& mesh : m_meshes)
         {
-            ResourceManager::getInstance()->scheduleMeshForDeletion(mesh);
-        }
-        m_meshes.clear();
-        m_vertexCount = 0;
-        m_triangleCount = 0;
-        m_meshletsCount = 0;
-        if (!deserializeMeshes())
-        {
-            loadModel(m_path);
-            serializeMeshes();
+            cutTriangles += lod::selectCut(mesh->m_clusterDAG, world, camera->getCullingPosition(), projectionScale, m_lodErrorThreshold, selectedClusters);
+            cutClusters += selectedClusters.size();
         }
-        uploadGPUResources();
+        ImGui::Text("DAG levels: %u", m_meshes[0]->m_clusterDAG.levelCount);
+        ImGui::Text("Cut clusters: %u", cutClusters);
+        ImGui::Text("Cut triangles: %u", cutTriangles);
+    }
+    ImGui::Separator();
+
+    ImGui::Checkbox("Reorder vertices by meshlet", &m_vertexReorder.enabled);
+    if (m_vertexReorder.enabled)
+    {
+        ImGui::SliderFloat("Max duplicated vertices", &m_vertexReorder.duplicationThreshold, 0.0f, 1.0f);
     }
     if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
     {
-        ImGui::SetTooltip("Tries to reload meshletized model from disk. If not found, loads model and meshletizes it.");
+        ImGui::SetTooltip("Fraction of a meshlet's vertices that may be duplicated to make it contiguous. Applied on next reload.");
+    }
+
+    ImGui::InputInt("Max meshlet vertices", &m_MeshletMaxVerts);
+    ImGui::InputInt("Max meshlet primitives", &m_MeshletMaxPrims);
+    if (ImGui::Button("RELOAD"))
+    {
+        reloadMeshes();
+    }
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Tries to reload meshletized model from disk. If not found, re-meshletizes loaded meshes, reusing their adjacency and triangle orders.");
     }
 
     ImGui::SameLine();
     if(ImGui::Button("FORCE RELOAD"))
     {
-        m_meshes.clear();
-        m_vertexCount = 0;
-        m_triangleCount = 0;
-        m_meshletsCount = 0;
+        releaseMeshes();
         loadModel(m_path);
         serializeMeshes();
         uploadGPUResources();
@@ -214,82 +562,213 @@ void Model::drawEditor()
     }
 }
 
-void Model::serializeMeshes() const
+void Model::reloadMeshes()
 {
-    int index = 0;
+    if (!std::filesystem::exists(getMeshCachePath(0)) && remeshletizeMeshes())
+    {
+        serializeMeshes();
+    }
+    else
+    {
+        releaseMeshes();
+        if (!deserializeMeshes())
+        {
+            loadModel(m_path);
+            serializeMeshes();
+        }
+    }
+    uploadGPUResources();
+}
 
-    u32 hash = olej_utils::murmurHash(reinterpret_cast<u8 const*>(m_path.data()), m_path.size(), 69);
-    for (auto& mesh : m_meshes)
+bool Model::remeshletizeMeshes()
+{
+    // LOD chains are generated on import
+    if (m_meshes.empty() || m_loadedLODCount != m_lodCount)
+        return false;
+
+    for (uint32_t i = 0; i < m_meshes.size(); i++)
     {
-        serializers::serializeMesh(
-            mesh->m_vertices,
-            mesh->m_indices,
-            mesh->m_meshlets,
-            mesh->m_meshletTriangles,
-            mesh->m_attributes,
-            mesh->m_positions,
-            mesh->m_normals,
-            mesh->m_UVs,
-            mesh->m_cullData,
-            mesh->m_MeshletMaxVerts,
-            mesh->m_MeshletMaxPrims,
-            mesh->m_type,
-            "../../cache/mesh/" + std::to_string(hash) + "_" + std::to_string(m_TypeIndex) + "_" + std::to_string(mesh->m_MeshletMaxVerts) + "_" + std::to_string(mesh->m_MeshletMaxPrims) + "_" + std::to_string(index) +  ".mesh");
-        index++;
+        if (!m_meshes[i]->canRemeshletize())
+            return false;
+        for (auto const& lodMesh : m_meshLODs[i])
+        {
+            if (!lodMesh->canRemeshletize())
+                return false;
+        }
+    }
+
+    auto const type = static_cast<MeshletizerType>(m_TypeIndex);
+    auto remeshletize = [&](Mesh* mesh)
+    {
+        mesh->releaseGPUResources();
+        mesh->m_vertexReorder = m_vertexReorder;
+        mesh->m_costWeights = m_costWeights;
+        mesh->remeshletize(type, m_MeshletMaxVerts, m_MeshletMaxPrims, m_vertexCacheOptimizers[m_TypeIndex]);
+    };
+
+    m_meshletsCount = 0;
+    for (uint32_t i = 0; i < m_meshes.size(); i++)
+    {
+        remeshletize(m_meshes[i]);
+        m_meshletsCount += m_meshes[i]->m_meshlets.size();
+        for (auto& lodMesh : m_meshLODs[i])
+        {
+            remeshletize(lodMesh);
+        }
+    }
+    return true;
+}
+
+void Model::serializeMeshes() const
+{
+    for (int32_t i = 0; i < m_meshes.size(); i++)
+    {
+        serializeMesh(m_meshes[i], getMeshCachePath(i));
+        for (int32_t lod = 0; lod < m_meshLODs[i].size(); lod++)
+        {
+            serializeMesh(m_meshLODs[i][lod], getMeshCachePath(i, lod + 1));
+        }
     }
 }
 
+void Model::serializeMesh(Mesh const* mesh, std::string const& path) const
+{
+    serializers::serializeMesh(
+        mesh->m_vertices,
+        mesh->m_indices,
+        mesh->m_meshlets,
+        mesh->m_meshletTriangles,
+        mesh->m_attributes,
+        mesh->m_positions,
+        mesh->m_normals,
+        mesh->m_UVs,
+        mesh->m_cullData,
+        mesh->m_bvhNodes,
+        mesh->m_MeshletMaxVerts,
+        mesh->m_MeshletMaxPrims,
+        mesh->m_type,
+        mesh->m_lodError,
+        path);
+}
+
 bool Model::deserializeMeshes()
 {
-    u32 hash = olej_utils::murmurHash(reinterpret_cast<u8 const*>(m_path.data()), m_path.size(), 69);
     int index = 0;
     for(;;)
     {
-        std::string path = "../../cache/mesh/" + std::to_string(hash) + "_" + std::to_string(m_TypeIndex) + "_" + std::to_string(m_MeshletMaxVerts) + "_" + std::to_string(m_MeshletMaxPrims) + "_" +  std::to_string(index) + ".mesh";
+        std::string path = getMeshCachePath(index);
         if (!std::filesystem::exists(path))
         {
             break;
         }
-        std::vector<Vertex> vertices;
-        std::vector<u32> indices;
-        std::vector<Meshlet> meshlets;
-        std::vector<u32> meshletTriangles;
-        std::vector<u32> attributes;
-        std::vector<hlsl::float3> positions;
-        std::vector<hlsl::float3> normals;
-        std::vector<hlsl::float2> UVs;
-        std::vector<CullData> cullData;
-        int32_t MeshletMaxVerts = 1;
-        int32_t MeshletMaxPrims = 1;
-        MeshletizerType type;
-        serializers::deserializeMesh(
-            vertices,
-            indices,
-            meshlets,
-            meshletTriangles,
-            attributes,
-            positions,
-            normals,
-            UVs,
-            cullData,
-            MeshletMaxVerts,
-            MeshletMaxPrims,
-            type,
-            path);
-
-        m_MeshletMaxPrims = MeshletMaxPrims;
-        m_MeshletMaxVerts = MeshletMaxVerts;
-        m_meshes.push_back(new Mesh(vertices, indices, {}, positions, normals, UVs, attributes, type, MeshletMaxVerts, MeshletMaxPrims, meshlets, meshletTriangles, cullData));
-        m_vertexCount += vertices.size();
-        m_triangleCount += indices.size() / 3;
-        m_meshletsCount += meshlets.size();
+
+        Mesh* mesh = deserializeMesh(path);
+
+        // Stale or broken cache file, drop what was loaded so far and let the caller meshletize from scratch
+        if (mesh == nullptr)
+        {
+            releaseMeshes();
+            counters::add(counters::MESH_CACHE_MISSES);
+            return false;
+        }
+        counters::add(counters::MESH_CACHE_HITS);
+
+        m_meshes.push_back(mesh);
+        m_meshLODs.emplace_back();
+        m_vertexCount += mesh->m_vertices.size();
+        m_triangleCount += mesh->m_indices.size() / 3;
+        m_meshletsCount += mesh->m_meshlets.size();
+
+        // DAG is built on request only, pick it up if it was built before
+        serializers::deserializeClusterDAG(mesh->m_clusterDAG, getClusterDAGCachePath(index));
+
+        // A chain can end early when simplification stalls, so missing levels are fine
+        for (int32_t lod = 1; lod < m_lodCount; lod++)
+        {
+            std::string const lodPath = getMeshCachePath(index, lod);
+            if (!std::filesystem::exists(lodPath))
+                break;
+
+            Mesh* lodMesh = deserializeMesh(lodPath);
+            if (lodMesh == nullptr)
+                break;
+            counters::add(counters::MESH_CACHE_HITS);
+            m_meshLODs.back().push_back(lodMesh);
+        }
         index++;
     }
     if (m_meshes.empty())
+    {
+        counters::add(counters::MESH_CACHE_MISSES);
         return false;
+    }
     return true;
 }
 
+Mesh* Model::deserializeMesh(std::string const& path)
+{
+    std::vector<Vertex> vertices;
+    std::vector<u32> indices;
+    std::vector<Meshlet> meshlets;
+    std::vector<u32> meshletTriangles;
+    std::vector<u32> attributes;
+    std::vector<hlsl::float3> positions;
+    std::vector<hlsl::float3> normals;
+    std::vector<hlsl::float2> UVs;
+    std::vector<CullData> cullData;
+    std::vector<culling::MeshletBVHNode> bvhNodes;
+    int32_t MeshletMaxVerts = 1;
+    int32_t MeshletMaxPrims = 1;
+    MeshletizerType type;
+    float lodError = 0.0f;
+    bool const loaded = serializers::deserializeMesh(
+        vertices,
+        indices,
+        meshlets,
+        meshletTriangles,
+        attributes,
+        positions,
+        normals,
+        UVs,
+        cullData,
+        bvhNodes,
+        MeshletMaxVerts,
+        MeshletMaxPrims,
+        type,
+        lodError,
+        path);
+
+    if (!loaded)
+        return nullptr;
+
+    m_MeshletMaxPrims = MeshletMaxPrims;
+    m_MeshletMaxVerts = MeshletMaxVerts;
+    Mesh* mesh = new Mesh(vertices, indices, {}, positions, normals, UVs, attributes, type, MeshletMaxVerts, MeshletMaxPrims, meshlets, meshletTriangles, cullData, bvhNodes);
+    mesh->m_lodError = lodError;
+    return mesh;
+}
+
+void Model::releaseMeshes()
+{
+    for (auto& mesh : m_meshes)
+    {
+        ResourceManager::getInstance()->scheduleMeshForDeletion(mesh);
+    }
+    for (auto& lods : m_meshLODs)
+    {
+        for (auto& mesh : lods)
+        {
+            ResourceManager::getInstance()->scheduleMeshForDeletion(mesh);
+        }
+    }
+    m_meshes.clear();
+    m_meshLODs.clear();
+    m_loadedLODCount = 0;
+    m_vertexCount = 0;
+    m_triangleCount = 0;
+    m_meshletsCount = 0;
+}
+
 void Model::sendDataToBenchmark()
 {
     MeshletBenchmark::getInstance()->updateMeshletizerType(static_cast<MeshletizerType>(m_TypeIndex));
@@ -319,6 +798,7 @@ void Model::loadModel(std::string const& path)
     m_directory = filesystem_path.parent_path().string();
 
     processNode(scene->mRootNode, scene);
+    m_loadedLODCount = m_lodCount;
 }
 
 void Model::processNode(aiNode const* node, aiScene const* scene)
@@ -395,42 +875,257 @@ Mesh* Model::processMesh(aiMesh const* mesh, aiScene const* scene)
     m_vertexCount += vertices.size();
     m_triangleCount += indices.size() / 3;
     ///////////////////////////////////////
-    return new Mesh(vertices, indices, textures, positions, normals, UVs, attributes, static_cast<MeshletizerType>(m_TypeIndex), m_MeshletMaxVerts, m_MeshletMaxPrims);
+
+    m_meshLODs.emplace_back();
+    std::vector<lod::LODLevel> levels;
+    lod::generateLODChain(indices, positions, m_lodCount, levels);
+    for (uint32_t i = 1; i < levels.size(); i++)
+    {
+        std::vector<u32>& lodIndices = levels[i].indices;
+        std::vector<u32> sourceVertices;
+        lod::compactVertices(lodIndices, static_cast<u32>(vertices.size()), sourceVertices);
+
+        std::vector<Vertex> lodVertices(sourceVertices.size());
+        std::vector<hlsl::float3> lodPositions(sourceVertices.size());
+        std::vector<hlsl::float3> lodNormals(sourceVertices.size());
+        std::vector<hlsl::float2> lodUVs(sourceVertices.size());
+        for (u32 v = 0; v < sourceVertices.size(); v++)
+        {
+            lodVertices[v] = vertices[sourceVertices[v]];
+            lodPositions[v] = positions[sourceVertices[v]];
+            lodNormals[v] = normals[sourceVertices[v]];
+            lodUVs[v] = UVs[sourceVertices[v]];
+        }
+        std::vector<u32> lodAttributes(lodIndices.size() / 3, mesh->mMaterialIndex);
+
+        // Textures stay owned by LOD0
+        Mesh* lodMesh = new Mesh(lodVertices, lodIndices, {}, lodPositions, lodNormals, lodUVs, lodAttributes, static_cast<MeshletizerType>(m_TypeIndex), m_MeshletMaxVerts, m_MeshletMaxPrims, m_vertexReorder, m_costWeights, m_vertexCacheOptimizers[m_TypeIndex]);
+        lodMesh->m_lodError = levels[i].error;
+        m_meshLODs.back().push_back(lodMesh);
+    }
+
+    return new Mesh(vertices, indices, textures, positions, normals, UVs, attributes, static_cast<MeshletizerType>(m_TypeIndex), m_MeshletMaxVerts, m_MeshletMaxPrims, m_vertexReorder, m_costWeights, m_vertexCacheOptimizers[m_TypeIndex]);
 }
 
 void Model::uploadGPUResources()
 {
-    for (uint32_t i = 0; i < m_meshes.size(); ++i)
+    // Instances are culled as a whole against the union of the base meshes' hierarchy roots
+    m_boundingSphere = hlsl::float4(0.0f, 0.0f, 0.0f, -1.0f);
+    for (uint32_t i = 0; i < m_meshes.size(); i++)
+    {
+        if (m_meshes[i]->m_bvhNodes.empty())
+        {
+            m_boundingSphere.w = -1.0f;
+            break;
+        }
+        hlsl::float4 const& root = m_meshes[i]->m_bvhNodes[0].boundingSphere;
+        m_boundingSphere = i == 0 ? root : culling::mergeSpheres(m_boundingSphere, root);
+    }
+
+    releaseMergedGeometry();
+    if (m_useMergedGeometry)
+    {
+        uploadMergedGeometry();
+    }
+    else
     {
-        auto& m = m_meshes[i];
-        if (m->m_indices.size() != 0)
+        for (uint32_t i = 0; i < m_meshes.size(); ++i)
         {
-            m->IndexResource = new Resource();
-            m->IndexResource->create(m->m_indices.size() * sizeof(u32), m->m_indices.data());
+            uploadMeshResources(m_meshes[i]);
+            for (auto& lodMesh : m_meshLODs[i])
+            {
+                uploadMeshResources(lodMesh);
+            }
         }
+    }
+    // Copies start now, the CPU doesn't wait for them
+    UploadManager::getInstance()->flush();
+}
 
-        if (m->m_meshlets.size() != 0)
+namespace
+{
+    Resource* createIndexResource(std::vector<u32>& indices, uint32_t indexBytes)
+    {
+        Resource* resource = new Resource();
+        if (indexBytes == sizeof(u16))
         {
-            m->MeshletResource = new Resource();
-            m->MeshletResource->create(m->m_meshlets.size() * sizeof(m->m_meshlets[0]), m->m_meshlets.data());
+            // Padded to a whole uint, the mesh shader reads two indices per load
+            std::vector<u16> narrowIndices(indices.size() + (indices.size() & 1), 0);
+            std::ranges::transform(indices, narrowIndices.begin(), [](u32 index) { return static_cast<u16>(index); });
+            resource->createPooled(narrowIndices.size() * sizeof(u16), narrowIndices.data());
         }
-        if (m->m_meshletTriangles.size() != 0)
+        else
         {
-            m->MeshletTriangleIndicesResource = new Resource();
-            m->MeshletTriangleIndicesResource->create(m->m_meshletTriangles.size() * sizeof(m->m_meshletTriangles[0]), m->m_meshletTriangles.data());
+            resource->createPooled(indices.size() * sizeof(u32), indices.data());
         }
+        return resource;
+    }
+}
+
+void Model::uploadMeshResources(Mesh* m)
+{
+    if (m->m_indices.size() != 0)
+    {
+        m->IndexResource = createIndexResource(m->m_indices, m->m_indexBytes);
+    }
+
+    if (m->m_meshlets.size() != 0)
+    {
+        m->MeshletResource = new Resource();
+        m->MeshletResource->createPooled(m->m_meshlets.size() * sizeof(m->m_meshlets[0]), m->m_meshlets.data());
+    }
+    if (m->m_meshletTriangles.size() != 0)
+    {
+        m->MeshletTriangleIndicesResource = new Resource();
+        m->MeshletTriangleIndicesResource->createPooled(m->m_meshletTriangles.size() * sizeof(m->m_meshletTriangles[0]), m->m_meshletTriangles.data());
+    }
+
+    if (m->m_vertices.size() != 0)
+    {
+        m->VertexResource = new Resource();
+        m->VertexResource->createPooled(m->m_vertices.size() * sizeof(Vertex), m->m_vertices.data());
+    }
+
+    if (m->m_cullData.size() != 0)
+    {
+        m->CullDataResource = new Resource();
+        m->CullDataResource->createPooled(m->m_cullData.size() * sizeof(CullData), m->m_cullData.data());
+    }
+}
+
+void Model::uploadMergedGeometry()
+{
+    std::vector<geometry::MeshGeometryView> views;
+    auto view = [](Mesh const* mesh)
+    {
+        return geometry::MeshGeometryView{ &mesh->m_vertices, &mesh->m_indices, &mesh->m_meshlets, &mesh->m_meshletTriangles, &mesh->m_cullData };
+    };
 
-        if (m->m_vertices.size() != 0)
+    // Base meshes first, so with LODs off the whole model is one contiguous meshlet range
+    m_mergedRangeIndices.assign(m_meshes.size(), {});
+    for (uint32_t i = 0; i < m_meshes.size(); i++)
+    {
+        m_mergedRangeIndices[i].push_back(static_cast<uint32_t>(views.size()));
+        views.push_back(view(m_meshes[i]));
+    }
+    for (uint32_t i = 0; i < m_meshes.size(); i++)
+    {
+        for (auto const& lodMesh : m_meshLODs[i])
         {
-            m->VertexResource = new Resource();
-            m->VertexResource->create(m->m_vertices.size() * sizeof(Vertex), m->m_vertices.data());
+            m_mergedRangeIndices[i].push_back(static_cast<uint32_t>(views.size()));
+            views.push_back(view(lodMesh));
         }
+    }
 
-        if (m->m_cullData.size() != 0)
+    geometry::MergedGeometry merged;
+    geometry::packMergedGeometry(views, merged);
+    assert(geometry::verifyMergedGeometry(views, merged));
+    if (merged.meshlets.empty())
+        return;
+
+    m_mergedIndexResource = createIndexResource(merged.indices, merged.indexBytes);
+    m_mergedMeshletResource = new Resource();
+    m_mergedMeshletResource->createPooled(merged.meshlets.size() * sizeof(Meshlet), merged.meshlets.data());
+    m_mergedTriangleResource = new Resource();
+    m_mergedTriangleResource->createPooled(merged.meshletTriangles.size() * sizeof(u32), merged.meshletTriangles.data());
+    m_mergedVertexResource = new Resource();
+    m_mergedVertexResource->createPooled(merged.vertices.size() * sizeof(Vertex), merged.vertices.data());
+    m_mergedCullDataResource = new Resource();
+    m_mergedCullDataResource->createPooled(merged.cullData.size() * sizeof(CullData), merged.cullData.data());
+
+    m_mergedIndexBytes = merged.indexBytes;
+    m_mergedRanges = std::move(merged.ranges);
+}
+
+void Model::releaseMergedGeometry()
+{
+    Resource** resources[] = { &m_mergedVertexResource, &m_mergedIndexResource, &m_mergedMeshletResource, &m_mergedTriangleResource, &m_mergedCullDataResource };
+    for (Resource** resource : resources)
+    {
+        if (*resource != nullptr)
+            ResourceManager::getInstance()->scheduleResourceForDeletion(*resource);
+        *resource = nullptr;
+    }
+    m_mergedBindingTable.reset();
+    m_mergedRanges.clear();
+    m_mergedRangeIndices.clear();
+}
+
+std::string Model::getMeshCachePath(int32_t meshIndex, int32_t lod) const
+{
+    u32 hash = olej_utils::murmurHash(reinterpret_cast<u8 const*>(m_path.data()), m_path.size(), 69);
+    std::string const lodSuffix = lod > 0 ? "_lod" + std::to_string(lod) : "";
+    std::string const reorderSuffix = m_vertexReorder.enabled ? "_r" + std::to_string(static_cast<int>(m_vertexReorder.duplicationThreshold * 100.0f)) : "";
+    std::string const weightsSuffix = m_TypeIndex == COST ? "_w" + std::to_string(olej_utils::murmurHash(reinterpret_cast<u8 const*>(&m_costWeights), sizeof(m_costWeights), 69)) : "";
+    std::string const optimizerSuffix = usesVertexCacheOptimizer(static_cast<MeshletizerType>(m_TypeIndex)) ? "_v" + std::to_string(m_vertexCacheOptimizers[m_TypeIndex]) : "";
+    return "../../cache/mesh/" + std::to_string(hash) + "_" + std::to_string(m_TypeIndex) + "_" + std::to_string(m_MeshletMaxVerts) + "_" + std::to_string(m_MeshletMaxPrims) + reorderSuffix + weightsSuffix + optimizerSuffix + "_" + std::to_string(meshIndex) + lodSuffix + ".mesh";
+}
+
+void Model::benchmarkVertexCacheOptimizers()
+{
+    // Meshes only keep meshlet data, so the source index buffers are imported again
+    Assimp::Importer importer;
+    aiScene const* scene = importer.ReadFile(m_path, aiProcess_FlipUVs | aiProcess_ForceGenNormals | aiProcess_JoinIdenticalVertices);
+    if (scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)
+    {
+        std::cout << "Error. Failed loading a model: " << importer.GetErrorString() << "\n";
+        return;
+    }
+
+    m_vertexCacheBenchmark.clear();
+    u32 totalTriangles = 0;
+    for (u32 i = 0; i < scene->mNumMeshes; ++i)
+    {
+        aiMesh const* mesh = scene->mMeshes[i];
+        std::vector<u32> indices;
+        for (u32 j = 0; j < mesh->mNumFaces; ++j)
         {
-            m->CullDataResource = new Resource();
-            m->CullDataResource->create(m->m_cullData.size() * sizeof(CullData), m->m_cullData.data());
+            for (u32 k = 0; k < mesh->mFaces[j].mNumIndices; k++)
+            {
+                indices.push_back(mesh->mFaces[j].mIndices[k]);
+            }
+        }
+
+        u32 const triangles = static_cast<u32>(indices.size() / 3);
+        auto const results = meshletizers::vcache::benchmark(indices, mesh->mNumVertices);
+        if (m_vertexCacheBenchmark.empty())
+        {
+            m_vertexCacheBenchmark.resize(results.size(), {});
         }
+
+        // ACMR is averaged over all triangles of the model
+        for (u32 j = 0; j < results.size(); j++)
+        {
+            m_vertexCacheBenchmark[j].optimizer = results[j].optimizer;
+            m_vertexCacheBenchmark[j].seconds += results[j].seconds;
+            m_vertexCacheBenchmark[j].acmr += results[j].acmr * triangles;
+        }
+        totalTriangles += triangles;
+    }
+
+    printf("=========VERTEX CACHE OPTIMIZERS=========\n");
+    for (auto& result : m_vertexCacheBenchmark)
+    {
+        result.acmr /= std::max(totalTriangles, 1u);
+        printf("%s: ACMR %f, time %f s\n", meshletizers::vcache::getName(result.optimizer), result.acmr, result.seconds);
+    }
+}
+
+std::string Model::getClusterDAGCachePath(int32_t meshIndex) const
+{
+    return std::filesystem::path(getMeshCachePath(meshIndex)).replace_extension(".dag").string();
+}
+
+void Model::buildClusterDAGs()
+{
+    for (int32_t i = 0; i < m_meshes.size(); i++)
+    {
+        std::string const path = getClusterDAGCachePath(i);
+        if (serializers::deserializeClusterDAG(m_meshes[i]->m_clusterDAG, path))
+            continue;
+
+        m_meshes[i]->buildClusterDAG();
+        serializers::serializeClusterDAG(m_meshes[i]->m_clusterDAG, path);
     }
 }
 
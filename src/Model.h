@@ -5,26 +5,42 @@
 #include "Component.h"
 #include "PipelineState.h"
 #include "utils/maths.h"
+#include "GreedyMeshletizer/vertexCacheOptimizer.h"
+#include "Geometry/MergedGeometry.h"
+#include "DX12Wrappers/BindingTable.h"
+#include "DX12Wrappers/IndirectDispatcher.h"
+#include "DX12Wrappers/ParallelRecorder.h"
 #include "../res/shaders/shared/shared_cb.h"
 
 class Mesh;
+class Resource;
 
 template <typename T>
 class ConstantBuffer;
+template <typename T>
+class FrameStructuredBuffer;
 
-class Model : public Component
+class Model : public Component, public IRecordable
 {
 public:
     Model() = default;
     static Model* create(std::string const& model_path);
     ~Model() = default;
 
+    // Reads camera and transform state for draw(), on the main thread
+    void prepareDraw();
     void setConstantBuffer();
+    // Uses state of the last prepareDraw() only, so it can run on a recording worker
     void draw();
+    // Draws are queued to ParallelRecorder, the forward pass records them
     void update() override;
+    void record() override;
+    uint64_t recordingCost() const override;
     void drawEditor() override;
     void serializeMeshes() const;
     bool deserializeMeshes();
+    // Schedules all meshes and their LODs for deletion
+    void releaseMeshes();
 
     void sendDataToBenchmark();
 
@@ -34,12 +50,62 @@ private:
     void processNode(aiNode const* node, aiScene const* scene);
     Mesh* processMesh(aiMesh const* mesh, aiScene const* scene);
 
+    /*
+     * Applies current meshletizer settings: loads them from cache when they were used before,
+     * otherwise re-meshletizes loaded meshes in place, importing the model again only as a last resort.
+     */
+    void reloadMeshes();
+    // Returns false when meshes can't be re-meshletized in place, see Mesh::canRemeshletize()
+    bool remeshletizeMeshes();
     void uploadGPUResources();
+    void uploadMeshResources(Mesh* mesh);
+    // Packs every mesh and LOD into shared buffers instead, meshes then keep no GPU resources of their own
+    void uploadMergedGeometry();
+    void releaseMergedGeometry();
+    /*
+     * Culls instances against the model's bounds, uploads the visible ones and binds them as Instances.
+     * Returns the visible count, referenceWorld is the nearest visible instance's world matrix.
+     */
+    uint32_t updateInstances(PipelineState* pso, hlsl::float4x4& referenceWorld);
+    void generateInstanceGrid();
+    // Meshlet ranges of one mesh in the merged buffers, culled when CULLING is on and there is a single instance
+    void collectMergedRanges(Mesh* mesh, geometry::MergedMeshRange const& range, hlsl::float4x4 const& world, uint32_t instanceCount);
+    void bindMergedGeometry(PipelineState* pso);
+    void dispatchMerged(PipelineState* pso, uint32_t instanceCount);
+    // Records of one mesh for ExecuteIndirect, a single instance is dropped later when it's outside the frustum
+    void collectIndirectCommands(Mesh* mesh, geometry::MergedMeshRange const& range, hlsl::float4x4 const& world, uint32_t instanceCount);
+    void dispatchIndirect(PipelineState* pso);
+    void serializeMesh(Mesh const* mesh, std::string const& path) const;
+    Mesh* deserializeMesh(std::string const& path);
+    uint32_t selectLOD(uint32_t meshIndex, hlsl::float4x4 const& world, hlsl::float3 const& cameraPosition, float projectionScale);
+    std::string getMeshCachePath(int32_t meshIndex, int32_t lod = 0) const;
+    std::string getClusterDAGCachePath(int32_t meshIndex) const;
+    void buildClusterDAGs();
+    // Runs every vertex cache optimizer on the source index buffers and prints ACMR and runtime
+    void benchmarkVertexCacheOptimizers();
     std::vector<Texture*> loadMaterialTextures(aiMaterial const* material, aiTextureType type, TextureType type_name);
 
     std::vector<Mesh*> m_meshes;
+    // Coarser levels of every mesh, m_meshLODs[mesh][lod - 1]
+    std::vector<std::vector<Mesh*>> m_meshLODs;
+    std::vector<uint32_t> m_currentLODs;
+    std::vector<float> m_lodErrors;
     std::string m_directory;
 
+    struct DrawView
+    {
+        hlsl::float4x4 view;
+        hlsl::float4x4 projection;
+        hlsl::float4x4 entityWorld;
+        hlsl::float3 cameraPosition;
+        hlsl::float4 planes[6]; // top, bottom, right, left, far, near
+        float projectionScale = 1.0f;
+        float time = 0.0f;
+        uint32_t drawFlag = 0;
+    };
+    // Camera getters and transforms update lazily, workers must not touch them
+    DrawView m_drawView;
+
 
     ConstantBuffer<SceneConstantBuffer>* m_sceneConstantBuffer;
     SceneConstantBuffer m_sceneConstantBufferData;
@@ -47,12 +113,56 @@ private:
     ConstantBuffer<CameraConstants>* m_cameraConstantBuffer;
     CameraConstants m_cameraConstants;
 
+    // Relative to the entity, empty draws the model once at the entity transform
+    std::vector<hlsl::float4x4> m_instanceTransforms;
+    int32_t m_instanceGridSize = 1;
+    float m_instanceSpacing = 10.0f;
+    bool m_cullInstances = true;
+    // Compacted every frame, only visible instances reach the GPU
+    std::vector<InstanceTransform> m_visibleInstances;
+    FrameStructuredBuffer<InstanceTransform>* m_instanceBuffer = nullptr;
+    // Object space bounds of all base meshes, w < 0 when some mesh has no meshlet hierarchy to take them from
+    hlsl::float4 m_boundingSphere = hlsl::float4(0.0f, 0.0f, 0.0f, -1.0f);
+
+    // Whole model in one set of buffers, drawn with one binding set and as few dispatches as ranges allow
+    bool m_useMergedGeometry = false;
+    Resource* m_mergedVertexResource = nullptr;
+    Resource* m_mergedIndexResource = nullptr;
+    Resource* m_mergedMeshletResource = nullptr;
+    Resource* m_mergedTriangleResource = nullptr;
+    Resource* m_mergedCullDataResource = nullptr;
+    uint32_t m_mergedIndexBytes = sizeof(uint32_t);
+    std::vector<geometry::MergedMeshRange> m_mergedRanges;
+    // m_mergedRangeIndices[mesh][lod] -> m_mergedRanges, base meshes are packed first so they stay contiguous
+    std::vector<std::vector<uint32_t>> m_mergedRangeIndices;
+    std::vector<MeshSubset> m_mergedDispatches;
+    BindingTable m_mergedBindingTable;
+    ConstantBuffer<MeshInfo>* m_mergedMeshInfoBuffer = nullptr;
+
+    // Merged geometry only, every mesh instance becomes argument records of a single ExecuteIndirect
+    bool m_useIndirectDispatch = false;
+    indirect::IndirectArguments m_indirectArguments;
+    std::vector<uint8_t> m_indirectVisibility;
+    IndirectDispatcher m_indirectDispatcher;
+
 
     // STATS FOR EDITOR
     int m_vertexCount = 0;
     int m_triangleCount = 0;
     int m_meshletsCount = 0;
 
+    float m_lodErrorThreshold = 1.0f;
+    int32_t m_lodCount = 4;
+    // LOD count the current LOD chains were generated with, 0 when meshes came from cache
+    int32_t m_loadedLODCount = 0;
+    bool m_useLODs = false;
+
+    VertexReorderSettings m_vertexReorder;
+    MeshletCostWeights m_costWeights;
+    // Selected per meshletizer type
+    VertexCacheOptimizer m_vertexCacheOptimizers[MESHLETIZER_TYPE_COUNT] = {};
+    std::vector<meshletizers::vcache::OptimizerBenchmark> m_vertexCacheBenchmark;
+
     int m_TypeIndex = 2;
 
     std::string m_path;
@@ -156,11 +156,12 @@ ID3D12PipelineState* PipelineState::PSO() const
     return m_pipelineState;
 }
 
-int32_t PipelineState::getRootParameterIndex(std::string name) const
+int32_t PipelineState::getRootParameterIndex(std::string_view name) const
 {
     PSOParser::NameHash hash = olej_utils::murmurHash(reinterpret_cast<const u8*>(name.data()), name.size(), 69);
-    if(m_rootParameterMap.find(hash) != m_rootParameterMap.end())
-        return m_rootParameterMap.at(hash);
+    auto const it = m_rootParameterMap.find(hash);
+    if (it != m_rootParameterMap.end())
+        return it->second;
 
     return -1;
 }
@@ -189,5 +190,10 @@ void PipelineState::createRootSignature()
         usedShaders.push_back(m_amplificationShader);
 
 
+    // Names that left the shaders on reload must not keep resolving
+    m_rootParameterMap.clear();
     m_rootSignature = PSOParser::parseRootSignature(usedShaders, m_rootParameterMap);
+
+    static uint32_t nextRootSignatureVersion = 1;
+    m_rootSignatureVersion = nextRootSignatureVersion++;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <d3dx12.h>
+#include <string_view>
 
 #include "PSOParser.h"
 
@@ -58,7 +59,11 @@ public:
     ID3D12PipelineState* PSO() const;
 
 
-    int32_t getRootParameterIndex(std::string name) const;
+    // Hashes the name, bind through a BindingTable or a cached index in per draw code
+    int32_t getRootParameterIndex(std::string_view name) const;
+    // Changes whenever the root signature is rebuilt, so cached root parameter indices can tell they went stale.
+    // Unique across all pipeline states, a new PSO at the address of a deleted one never matches old caches
+    uint32_t getRootSignatureVersion() const { return m_rootSignatureVersion; }
 
     void reload() { compilePSO(); }
 
@@ -69,6 +74,7 @@ private:
     ID3D12PipelineState* m_pipelineState;
 
     std::unordered_map<PSOParser::NameHash, PSOParser::RootParameterIndex> m_rootParameterMap;
+    uint32_t m_rootSignatureVersion = 0;
     std::wstring m_asName = L"";
     std::wstring m_vsName = L"";
     std::wstring m_msName = L"";
@@ -7,6 +7,7 @@
 #include "Tasks/FXAATask.h"
 #include "Tasks/SimpleForwardRenderTask.h"
 #include "Tasks/IRenderTask.h"
+#include "Tools/TimelineRecorder.h"
 
 void RenderTaskList::prepareMainList()
 {
@@ -60,6 +61,7 @@ void RenderTaskList::prepareMainList()
 
 void RenderTaskList::renderMainList()
 {
+    TIMELINE_ZONE("RenderTaskList::renderMainList");
     for (auto task : m_renderTasks)
     {
         task->render();
@@ -11,10 +11,23 @@
 #include "Input.h"
 #include "Keyboard.h"
 #include "Tools/GPUProfiler.h"
+#include "Tools/PerformanceCounters.h"
+#include "Tools/TimelineRecorder.h"
 #include "DX12Resource/RenderTarget.h"
+#include "DX12Wrappers/ConstantBufferRing.h"
+#include "DX12Wrappers/FramePacer.h"
+#include "DX12Wrappers/MeshBufferPool.h"
+#include "DX12Wrappers/UploadManager.h"
+#include "DX12Wrappers/ParallelRecorder.h"
+#include "ResourceLoaders/ResourceManager.h"
 #include "RenderTaskList.h"
 Renderer* Renderer::m_instance;
 
+namespace
+{
+    thread_local ID3D12GraphicsCommandList6* t_command_list = nullptr;
+}
+
 Renderer::Renderer()
 {
     create_device_d3d(Window::get_hwnd());
@@ -23,6 +36,11 @@ Renderer::Renderer()
 void Renderer::create()
 {
     m_instance = new Renderer();
+    FramePacer::create();
+    UploadManager::create();
+    MeshBufferPool::create();
+    ConstantBufferRing::create();
+    ParallelRecorder::create();
     m_instance->m_render_resources_manager = new RenderResourcesManager();
     m_instance->m_render_resources_manager->createResources();
 
@@ -59,6 +77,11 @@ void Renderer::start_frame()
     }
 
 
+    // Blocks only while the GPU is framesInFlight frames behind
+    FramePacer::getInstance()->beginFrame();
+    ConstantBufferRing::getInstance()->reclaim();
+    ResourceManager::getInstance()->releaseFinished(get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->get_completed_fence_value());
+
     auto index = g_pSwapChain->GetCurrentBackBufferIndex();
     frame_index = index;
     auto cmdqueue = get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT);
@@ -76,14 +99,18 @@ void Renderer::render()
     auto profiler = GPUProfiler::getInstance();
     profiler->startFrame();
 
-    ProfilerEntry* const profilerEntry = profiler->startEntry(cmd_list, "Frame");
+    static const uint32_t frameName = profiler->internName("Frame");
+    static const uint32_t drawDebugName = profiler->internName("Draw debug geometry");
+
+    ProfilerEntry* const profilerEntry = profiler->startEntry(cmd_list, frameName);
     {
-        cmd_list->RSSetViewports(1, &m_Viewport);
-        cmd_list->RSSetScissorRects(1, &m_ScissorRect);
+        setup_command_list(cmd_list);
 
         m_render_task_list->renderMainList();
 
-        ProfilerEntry* const profilerEntryDrawDebug = profiler->startEntry(cmd_list, "Draw debug geometry");
+        // Parallel recording may have moved the rest of the frame to another list
+        cmd_list = g_pd3dCommandList;
+        ProfilerEntry* const profilerEntryDrawDebug = profiler->startEntry(cmd_list, drawDebugName);
         {
             m_debugDrawer->draw();
         } profiler->endEntry(cmd_list, profilerEntryDrawDebug);
@@ -92,6 +119,31 @@ void Renderer::render()
 
 }
 
+ID3D12GraphicsCommandList6* Renderer::get_command_list() const
+{
+    return t_command_list != nullptr ? t_command_list : g_pd3dCommandList;
+}
+
+void Renderer::set_thread_command_list(ID3D12GraphicsCommandList6* command_list)
+{
+    t_command_list = command_list;
+}
+
+void Renderer::setup_command_list(ID3D12GraphicsCommandList6* command_list) const
+{
+    command_list->RSSetViewports(1, &m_Viewport);
+    command_list->RSSetScissorRects(1, &m_ScissorRect);
+}
+
+void Renderer::insert_command_lists(ID3D12GraphicsCommandList6* const* command_lists, uint32_t count)
+{
+    m_frame_command_lists.push_back(g_pd3dCommandList);
+    m_frame_command_lists.insert(m_frame_command_lists.end(), command_lists, command_lists + count);
+
+    g_pd3dCommandList = m_DirectCommandQueue->get_command_list();
+    setup_command_list(g_pd3dCommandList);
+}
+
 void Renderer::initDebugDrawings()
 {
     m_debugDrawer->createCamera();
@@ -107,9 +159,17 @@ void Renderer::end_frame()
 
 
     profiler->endRecording(command_list);
-    auto index = g_pSwapChain->GetCurrentBackBufferIndex();
-    g_fencevalues[g_pSwapChain->GetCurrentBackBufferIndex()] = m_DirectCommandQueue->execute_command_list(command_list);
-    m_DirectCommandQueue->wait_for_fence_value(g_fencevalues[index]);
+    // Buffers created during the frame are copied before the frame that uses them
+    UploadManager::getInstance()->flush();
+    UploadManager::getInstance()->reclaim();
+    m_frame_command_lists.push_back(command_list);
+    uint64_t const fenceValue = m_DirectCommandQueue->execute_command_lists(m_frame_command_lists.data(), static_cast<uint32_t>(m_frame_command_lists.size()));
+    m_frame_command_lists.clear();
+    profiler->frameSubmitted(fenceValue);
+    ConstantBufferRing::getInstance()->endFrame(fenceValue);
+    // No wait, the next start_frame() waits for an older frame if the GPU is too far behind
+    FramePacer::getInstance()->endFrame(fenceValue);
+    ResourceManager::getInstance()->submitScheduled(fenceValue);
 
     HRESULT hr = g_pSwapChain->Present(m_vsync, 0); // Present without vsync (set first parameter to 1 to enable
     AssertFailed(hr);
@@ -117,6 +177,12 @@ void Renderer::end_frame()
 
 void Renderer::cleanup()
 {
+    FramePacer::getInstance()->waitForIdle();
+    ResourceManager::getInstance()->releaseAll();
+    ParallelRecorder::getInstance()->cleanup();
+    UploadManager::getInstance()->cleanup();
+    MeshBufferPool::getInstance()->cleanup();
+    ConstantBufferRing::getInstance()->cleanup();
     cleanup_device_d3d();
 }
 
@@ -134,7 +200,8 @@ void Renderer::on_window_resize()
         height = rect.bottom - rect.top;
     }
 
-	m_DirectCommandQueue->flush();
+    FramePacer::getInstance()->waitForIdle();
+    ResourceManager::getInstance()->releaseAll();
     m_render_resources_manager->releaseResources();
 
 
@@ -291,8 +358,10 @@ void Renderer::update_buffer_resource(ID3D12GraphicsCommandList2* commandList,
     size_t numElements, size_t elementSize, const void* bufferData,
     D3D12_RESOURCE_FLAGS flags)
 {
+    TIMELINE_ZONE("Buffer upload");
 
     size_t bufferSize = numElements * elementSize;
+    counters::add(counters::BYTES_UPLOADED, bufferSize);
 
     // Create a committed resource for the GPU resource in a default heap.
     auto heap_properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
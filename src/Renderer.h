@@ -45,6 +45,16 @@ public:
     static constexpr int NUM_FRAMES_IN_FLIGHT = 3;
 
     ID3D12GraphicsCommandList6* g_pd3dCommandList = nullptr;
+    // List the calling thread records into, a recording worker's own list while ParallelRecorder runs it
+    ID3D12GraphicsCommandList6* get_command_list() const;
+    static void set_thread_command_list(ID3D12GraphicsCommandList6* command_list);
+    // Viewport and scissor of the frame, every list recording frame draws needs them
+    void setup_command_list(ID3D12GraphicsCommandList6* command_list) const;
+    /*
+     * Queues the frame list and then the given lists for end_frame() to submit in that order,
+     * recording continues in a fresh frame list. Lists must come from the direct queue.
+     */
+    void insert_command_lists(ID3D12GraphicsCommandList6* const* command_lists, uint32_t count);
     void create_depth_stencil();
     void on_window_resize();
 
@@ -79,7 +89,6 @@ private:
     IDXGISwapChain3* g_pSwapChain = nullptr;
     D3D12_VIEWPORT m_Viewport = {};
     D3D12_RECT m_ScissorRect;
-    uint64_t* g_fencevalues = new uint64_t[NUM_FRAMES_IN_FLIGHT];
 
     // Resources
 
@@ -102,6 +111,8 @@ private:
     ID3D12InfoQueue* pInfoQueue = nullptr;
 
     std::vector<PipelineState*> mRegisteredPipelineStates;
+    // Closed parts of the frame, submitted before g_pd3dCommandList
+    std::vector<ID3D12GraphicsCommandList6*> m_frame_command_lists;
 
     DebugDrawer* m_debugDrawer;
 
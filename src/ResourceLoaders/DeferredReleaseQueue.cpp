@@ -0,0 +1,77 @@
+#include "DeferredReleaseQueue.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace release
+{
+    int64_t steadyNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void DeferredReleaseQueue::push(uint64_t fenceValue, Release release)
+    {
+        // Fences mostly arrive in order, anything older is inserted after the last entry with the same or older fence
+        if (m_entries.empty() || m_entries.back().fenceValue <= fenceValue)
+        {
+            m_entries.push_back({ fenceValue, release });
+            return;
+        }
+
+        auto const position = std::upper_bound(m_entries.begin(), m_entries.end(), fenceValue,
+            [](uint64_t value, Entry const& entry) { return value < entry.fenceValue; });
+        m_entries.insert(position, { fenceValue, release });
+    }
+
+    uint32_t DeferredReleaseQueue::drain(uint64_t completedFenceValue, int64_t budgetNanoseconds, int64_t (*now)())
+    {
+        int64_t const start = now();
+        uint32_t released = 0;
+        while (!m_entries.empty() && m_entries.front().fenceValue <= completedFenceValue)
+        {
+            if (released > 0 && now() - start >= budgetNanoseconds)
+                break;
+
+            // Popped first, the release may push
+            Release const release = m_entries.front().release;
+            m_entries.pop_front();
+            release.function(release.object);
+            released++;
+        }
+        return released;
+    }
+
+    uint32_t DeferredReleaseQueue::drainAll()
+    {
+        uint32_t released = 0;
+        while (!m_entries.empty())
+        {
+            Release const release = m_entries.front().release;
+            m_entries.pop_front();
+            release.function(release.object);
+            released++;
+        }
+        return released;
+    }
+
+    uint32_t DeferredReleaseQueue::drainAll(std::function<void(std::vector<Release>&)> const& takeScheduled)
+    {
+        uint32_t released = 0;
+        std::vector<Release> scheduled;
+        while (true)
+        {
+            released += drainAll();
+
+            scheduled.clear();
+            takeScheduled(scheduled);
+            if (scheduled.empty())
+                return released;
+
+            for (auto const& release : scheduled)
+            {
+                push(0, release);
+            }
+        }
+    }
+}
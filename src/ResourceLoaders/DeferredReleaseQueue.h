@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// No D3D12 dependencies, completed fence values and the clock are passed in, so it can be driven by a fake fence
+namespace release
+{
+    // Deferred action, a plain function pointer and its argument so queuing doesn't allocate per release
+    struct Release
+    {
+        void (*function)(void*) = nullptr;
+        void* object = nullptr;
+    };
+
+    // Steady clock in nanoseconds, the default for drain()
+    int64_t steadyNanoseconds();
+
+    /*
+     * Releases keyed by the fence value after which the GPU no longer uses their object, run in fence order.
+     * drain() stops once its time budget is spent, so unloading a big model is spread over several frames
+     * instead of freeing thousands of objects at once. Not thread safe, a release may push new releases.
+     */
+    class DeferredReleaseQueue
+    {
+    public:
+        void push(uint64_t fenceValue, Release release);
+
+        // Runs releases whose fence is at most completedFenceValue until budgetNanoseconds pass. At least one ready
+        // release runs per call, so the queue always makes progress. Returns the number of releases run
+        uint32_t drain(uint64_t completedFenceValue, int64_t budgetNanoseconds, int64_t (*now)() = steadyNanoseconds);
+        // Runs everything, including releases pushed by the ones it runs. Only when the GPU is idle
+        uint32_t drainAll();
+        // drainAll() until takeScheduled hands over no more releases. For releases scheduling new ones outside
+        // the queue, like deleted meshes scheduling their buffers. The GPU is idle, so those run right away
+        uint32_t drainAll(std::function<void(std::vector<Release>&)> const& takeScheduled);
+
+        uint64_t size() const { return m_entries.size(); }
+        bool empty() const { return m_entries.empty(); }
+        // Fence of the next release to run, 0 when empty
+        uint64_t oldestFenceValue() const { return m_entries.empty() ? 0 : m_entries.front().fenceValue; }
+
+    private:
+        struct Entry
+        {
+            uint64_t fenceValue;
+            Release release;
+        };
+
+        // Sorted by fence value, equal fences keep push order
+        std::deque<Entry> m_entries;
+    };
+}
@@ -1,5 +1,9 @@
 #include "ResourceManager.h"
 
+#include <imgui.h>
+
+#include "Tools/TimelineRecorder.h"
+
 
 ResourceManager* ResourceManager::m_instance;
 
@@ -15,17 +19,62 @@ ResourceManager* ResourceManager::getInstance()
 
 void ResourceManager::scheduleMeshForDeletion(Mesh* meshToDelete)
 {
-    m_meshesToDelete.push_back(meshToDelete);
+    scheduleForDeletion(meshToDelete);
+}
+
+void ResourceManager::scheduleResourceForDeletion(Resource* resourceToDelete)
+{
+    scheduleForDeletion(resourceToDelete);
+}
+
+void ResourceManager::scheduleTextureForDeletion(Texture* textureToDelete)
+{
+    scheduleForDeletion(textureToDelete);
+}
+
+void ResourceManager::scheduleRelease(IUnknown* object)
+{
+    if (object != nullptr)
+        scheduleRelease({ [](void* pointer) { static_cast<IUnknown*>(pointer)->Release(); }, object });
 }
 
-void ResourceManager::deleteScheduled()
+void ResourceManager::scheduleRelease(release::Release release)
 {
-    for (Mesh* mesh : m_meshesToDelete)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scheduled.push_back(release);
+}
+
+void ResourceManager::submitScheduled(uint64_t fenceValue)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto const& release : m_scheduled)
     {
-        delete mesh;
+        m_queue.push(fenceValue, release);
     }
+    m_scheduled.clear();
+}
 
-    m_meshesToDelete.clear();
+void ResourceManager::releaseFinished(uint64_t completedFenceValue)
+{
+    TIMELINE_ZONE("ResourceManager::releaseFinished");
+    m_lastReleased = m_queue.drain(completedFenceValue, static_cast<int64_t>(m_budgetMs * 1000000.0f));
 }
 
+void ResourceManager::releaseAll()
+{
+    // Deleted meshes schedule their buffers
+    m_queue.drainAll([this](std::vector<release::Release>& scheduled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        scheduled.swap(m_scheduled);
+    });
+}
 
+void ResourceManager::drawEditor()
+{
+    ImGui::SliderFloat("Release budget (ms)", &m_budgetMs, 0.1f, 8.0f, "%.1f");
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+        ImGui::SetTooltip("CPU time per frame spent freeing objects of finished frames. At least one object is freed per frame.");
+
+    ImGui::Text("Pending releases: %llu, released last frame: %u", static_cast<unsigned long long>(m_queue.size()), m_lastReleased);
+}
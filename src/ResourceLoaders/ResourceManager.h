@@ -1,9 +1,17 @@
-
-
+#pragma once
+#include <mutex>
 #include <string>
+#include <unknwn.h>
+#include <vector>
 
+#include "DeferredReleaseQueue.h"
 #include "Mesh.h"
 
+/*
+ * Owns everything the GPU may still read after its owner let go of it: resources, constant buffers, textures,
+ * whole meshes and raw D3D12 objects. Releases scheduled while a frame is recorded are keyed by that frame's fence
+ * in submitScheduled() and run by releaseFinished() once the fence completes, a limited amount of CPU time per frame.
+ */
 class ResourceManager final
 {
 public:
@@ -13,14 +21,38 @@ public:
     static void create();
 
     static ResourceManager* getInstance();
+
+    // Safe from recording workers
+    template <typename T>
+    void scheduleForDeletion(T* object)
+    {
+        if (object != nullptr)
+            scheduleRelease({ [](void* pointer) { delete static_cast<T*>(pointer); }, object });
+    }
     void scheduleMeshForDeletion(Mesh* meshToDelete);
+    void scheduleResourceForDeletion(Resource* resourceToDelete);
+    void scheduleTextureForDeletion(Texture* textureToDelete);
+    void scheduleRelease(IUnknown* object);
+    void scheduleRelease(release::Release release);
 
-    void deleteScheduled();
+    // Keys everything scheduled so far with the fence of the frame just submitted
+    void submitScheduled(uint64_t fenceValue);
+    // Runs finished releases until the frame budget is spent, the rest waits for the next frame
+    void releaseFinished(uint64_t completedFenceValue);
+    // Runs everything, including what the releases schedule themselves. Only when the GPU is idle
+    void releaseAll();
+
+    void drawEditor();
 
 private:
     static ResourceManager* m_instance;
 
-    std::vector<Mesh*> m_meshesToDelete;
-
+    // Only touched on the main thread, releases run unlocked since meshes schedule their buffers when deleted
+    release::DeferredReleaseQueue m_queue;
+    // Scheduled during the frame being recorded, no fence yet
+    std::vector<release::Release> m_scheduled;
+    std::mutex m_mutex;
 
+    float m_budgetMs = 1.0f;
+    uint32_t m_lastReleased = 0;
 };
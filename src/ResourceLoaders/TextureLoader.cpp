@@ -7,6 +7,8 @@
 
 #include "DirectXHelpers.h"
 #include "Renderer.h"
+#include "ResourceManager.h"
+#include "Tools/PerformanceCounters.h"
 #include "utils/ErrorHandler.h"
 #include "utils/Types.h"
 #include "utils/Utils.h"
@@ -83,6 +85,7 @@ Texture* TextureLoader::texture_from_file(std::string const& path)
 	AssertFailed(hr);
 
 	UpdateSubresources(cmdlist, texture->resource->getDx12Resource(), intermediate_resource, 0, 0, subresources.size(), subresources.data());
+	counters::add(counters::BYTES_UPLOADED, requiredSize);
 	// TODO: Add some transition logic to Resource
 	texture->resource->transitionResource(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
@@ -104,10 +107,9 @@ Texture* TextureLoader::texture_from_file(std::string const& path)
 	texture->SRV_GPU = texture->heap->GetGPUDescriptorHandleForHeapStart();
 
 	device->CreateShaderResourceView(texture->resource->getDx12Resource(), &srv_desc, texture->SRV_CPU);
-	auto fenceValue = cmdqueue->execute_command_list(cmdlist);
-	cmdqueue->wait_for_fence_value(fenceValue);
-
-	intermediate_resource->Release();
+	cmdqueue->execute_command_list(cmdlist);
+	// Submitted before the current frame, so the frame's fence covers the copy as well
+	ResourceManager::getInstance()->scheduleRelease(intermediate_resource);
 	scratchImage.Release();
 
 	return texture;
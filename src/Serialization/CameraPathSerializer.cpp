@@ -0,0 +1,62 @@
+#include "CameraPathSerializer.h"
+
+bool serializers::serializeCameraPath(const paths::CameraPath& path, const std::string& fileName)
+{
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    serializeObject(out, CAMERA_PATH_MAGIC);
+    serializeObject(out, CAMERA_PATH_VERSION);
+
+    // Settings are kept so the path can be regenerated and compared, positions so it doesn't have to be
+    serializeObject(out, path.settings);
+    serializeVector(out, path.positions);
+    serializeVector(out, path.lookAts);
+    out.close();
+    return true;
+}
+
+bool serializers::deserializeCameraPath(paths::CameraPath& path, const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in.is_open())
+    {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    deserializeObject(in, magic);
+    deserializeObject(in, version);
+    if (magic == CAMERA_PATH_MAGIC)
+    {
+        if (version != CAMERA_PATH_VERSION)
+        {
+            return false;
+        }
+        deserializeObject(in, path.settings);
+    }
+    else
+    {
+        in.clear();
+        in.seekg(0);
+        path.settings = {};
+        path.settings.type = paths::PATH_RANDOM;
+        path.settings.seed = 0;
+    }
+
+    deserializeVector(in, path.positions);
+    deserializeVector(in, path.lookAts);
+    path.settings.frameCount = static_cast<uint32_t>(path.positions.size());
+
+    bool const valid = !in.fail() && path.positions.size() == path.lookAts.size();
+    in.close();
+    if (!valid)
+    {
+        path = paths::CameraPath();
+    }
+    return valid;
+}
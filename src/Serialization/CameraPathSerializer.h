@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Tools/CameraPath.h"
+#include "types/VectorSerializer.h"
+
+
+namespace serializers
+{
+    static const uint32_t CAMERA_PATH_MAGIC = 0x504D4143; // "CAMP"
+    static const uint32_t CAMERA_PATH_VERSION = 1;
+
+    bool serializeCameraPath(const paths::CameraPath& path, const std::string& fileName);
+
+    // Also reads the unversioned sequences written before, those come back as PATH_RANDOM with unknown seed
+    bool deserializeCameraPath(paths::CameraPath& path, const std::string& fileName);
+}
@@ -0,0 +1,51 @@
+#include "ClusterDAGSerializer.h"
+
+bool serializers::serializeClusterDAG(const lod::ClusterDAG& dag, const std::string& fileName)
+{
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    serializeObject(out, CLUSTER_DAG_CACHE_MAGIC);
+    serializeObject(out, CLUSTER_DAG_CACHE_VERSION);
+
+    serializeVector(out, dag.clusters);
+    serializeVector(out, dag.vertexIndices);
+    serializeVector(out, dag.triangles);
+    serializeObject(out, dag.levelCount);
+    out.close();
+    return true;
+}
+
+bool serializers::deserializeClusterDAG(lod::ClusterDAG& dag, const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in.is_open())
+    {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    deserializeObject(in, magic);
+    deserializeObject(in, version);
+    if (magic != CLUSTER_DAG_CACHE_MAGIC || version != CLUSTER_DAG_CACHE_VERSION)
+    {
+        return false;
+    }
+
+    deserializeVector(in, dag.clusters);
+    deserializeVector(in, dag.vertexIndices);
+    deserializeVector(in, dag.triangles);
+    deserializeObject(in, dag.levelCount);
+
+    bool const valid = !in.fail();
+    in.close();
+    if (!valid)
+    {
+        dag = lod::ClusterDAG();
+    }
+    return valid;
+}
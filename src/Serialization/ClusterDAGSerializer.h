@@ -0,0 +1,15 @@
+#pragma once
+
+#include "LOD/ClusterDAG.h"
+#include "types/VectorSerializer.h"
+
+
+namespace serializers
+{
+    static const uint32_t CLUSTER_DAG_CACHE_MAGIC = 0x20474144; // "DAG "
+    static const uint32_t CLUSTER_DAG_CACHE_VERSION = 1;
+
+    bool serializeClusterDAG(const lod::ClusterDAG& dag, const std::string& fileName);
+
+    bool deserializeClusterDAG(lod::ClusterDAG& dag, const std::string& fileName);
+}
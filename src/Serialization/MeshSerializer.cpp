@@ -1,5 +1,7 @@
 #include "MeshSerializer.h"
 
+#include <algorithm>
+
 bool serializers::serializeMesh(
     const std::vector<Vertex>& vertices,
     const std::vector<uint32_t>& indices,
@@ -10,9 +12,11 @@ bool serializers::serializeMesh(
     const std::vector<hlsl::float3>& normals,
     const std::vector<hlsl::float2>& UVs,
     const std::vector<CullData>& cullData,
+    const std::vector<culling::MeshletBVHNode>& bvhNodes,
     int32_t MeshletMaxVerts,
     int32_t MeshletMaxPrims,
     MeshletizerType type,
+    float lodError,
     const std::string& fileName)
 {
     std::ofstream out(fileName, std::ios::binary);
@@ -21,8 +25,24 @@ bool serializers::serializeMesh(
         return false;
     }
 
+    serializeObject(out, MESH_CACHE_MAGIC);
+    serializeObject(out, MESH_CACHE_VERSION);
+
     serializeVector(out, vertices);
-    serializeVector(out, indices);
+
+    // Meshes small enough for 16-bit indices store them that way, halving the largest array of the file
+    uint32_t const indexBytes = getIndexBytes(vertices.size());
+    serializeObject(out, indexBytes);
+    if (indexBytes == sizeof(uint16_t))
+    {
+        std::vector<uint16_t> narrowIndices(indices.size());
+        std::ranges::transform(indices, narrowIndices.begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
+        serializeVector(out, narrowIndices);
+    }
+    else
+    {
+        serializeVector(out, indices);
+    }
     serializeVector(out, meshlets);
     serializeVector(out, meshletTriangles);
     serializeVector(out, attributes);
@@ -30,15 +50,17 @@ bool serializers::serializeMesh(
     serializeVector(out, normals);
     serializeVector(out, UVs);
     serializeVector(out, cullData);
+    serializeVector(out, bvhNodes);
 
     serializeObject(out, MeshletMaxVerts);
     serializeObject(out, MeshletMaxPrims);
     serializeObject(out, static_cast<int>(type));
+    serializeObject(out, lodError);
     out.close();
     return true;
 }
 
-void serializers::deserializeMesh(
+bool serializers::deserializeMesh(
     std::vector<Vertex>& vertices,
     std::vector<uint32_t>& indices,
     std::vector<Meshlet>& meshlets,
@@ -48,19 +70,42 @@ void serializers::deserializeMesh(
     std::vector<hlsl::float3>& normals,
     std::vector<hlsl::float2>& UVs,
     std::vector<CullData>& cullData,
+    std::vector<culling::MeshletBVHNode>& bvhNodes,
     int32_t& MeshletMaxVerts,
     int32_t& MeshletMaxPrims,
     MeshletizerType& type,
+    float& lodError,
     const std::string& fileName)
 {
     std::ifstream in(fileName, std::ios::binary);
     if (!in.is_open())
     {
-        return;
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    deserializeObject(in, magic);
+    deserializeObject(in, version);
+    if (magic != MESH_CACHE_MAGIC || version != MESH_CACHE_VERSION)
+    {
+        return false;
     }
 
     deserializeVector(in, vertices);
-    deserializeVector(in, indices);
+
+    uint32_t indexBytes = 0;
+    deserializeObject(in, indexBytes);
+    if (indexBytes == sizeof(uint16_t))
+    {
+        std::vector<uint16_t> narrowIndices;
+        deserializeVector(in, narrowIndices);
+        indices.assign(narrowIndices.begin(), narrowIndices.end());
+    }
+    else
+    {
+        deserializeVector(in, indices);
+    }
     deserializeVector(in, meshlets);
     deserializeVector(in, meshletTriangles);
     deserializeVector(in, attributes);
@@ -68,6 +113,7 @@ void serializers::deserializeMesh(
     deserializeVector(in, normals);
     deserializeVector(in, UVs);
     deserializeVector(in, cullData);
+    deserializeVector(in, bvhNodes);
 
     deserializeObject(in, MeshletMaxVerts);
     deserializeObject(in, MeshletMaxPrims);
@@ -75,7 +121,10 @@ void serializers::deserializeMesh(
     int typeInt;
     deserializeObject(in, typeInt);
     type = static_cast<MeshletizerType>(typeInt);
+    deserializeObject(in, lodError);
+    bool const valid = !in.fail();
     in.close();
+    return valid;
 }
 
 
@@ -2,14 +2,19 @@
 
 
 #include "MeshletStructs.h"
+#include "Culling/MeshletBVH.h"
 #include "DX12Wrappers/Vertex.h"
-#include "DXMeshletGenerator/D3D12MeshletGenerator.h"
+#include "DXMeshletGenerator/MeshletTypes.h"
 #include "types/VectorSerializer.h"
 #include "utils/maths.h"
 
 
 namespace serializers
 {
+    // Bump whenever the layout of a .mesh file changes, older files are then treated as missing
+    static const uint32_t MESH_CACHE_MAGIC = 0x4853454D; // "MESH"
+    static const uint32_t MESH_CACHE_VERSION = 3;
+
     bool serializeMesh(
         const std::vector<Vertex>& vertices,
         const std::vector<uint32_t>& indices,
@@ -20,12 +25,14 @@ namespace serializers
         const std::vector<hlsl::float3>& normals,
         const std::vector<hlsl::float2>& UVs,
         const std::vector<CullData>& cullData,
+        const std::vector<culling::MeshletBVHNode>& bvhNodes,
         int32_t MeshletMaxVerts,
         int32_t MeshletMaxPrims,
         MeshletizerType type,
+        float lodError,
         const std::string& fileName);
 
-    void deserializeMesh(
+    bool deserializeMesh(
          std::vector<Vertex>& vertices,
          std::vector<uint32_t>& indices,
          std::vector<Meshlet>& meshlets,
@@ -35,9 +42,11 @@ namespace serializers
          std::vector<hlsl::float3>& normals,
          std::vector<hlsl::float2>& UVs,
          std::vector<CullData>& cullData,
+         std::vector<culling::MeshletBVHNode>& bvhNodes,
          int32_t & MeshletMaxVerts,
          int32_t & MeshletMaxPrims,
          MeshletizerType& type,
+         float& lodError,
          const std::string& fileName);
 
 }
@@ -5,7 +5,7 @@
 
 void FXAATask::render()
 {
-    auto cmd_list = Renderer::get_instance()->g_pd3dCommandList;
+    auto cmd_list = Renderer::get_instance()->get_command_list();
 
     cmd_list->SetPipelineState(m_pipelineState->PSO());
     cmd_list->SetGraphicsRootSignature(m_pipelineState->dx12RootSignature());
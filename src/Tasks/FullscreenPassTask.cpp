@@ -4,7 +4,7 @@
 #include "DX12Resource/RenderTarget.h"
 void FullscreenPassTask::render()
 {
-    auto cmd_list = Renderer::get_instance()->g_pd3dCommandList;
+    auto cmd_list = Renderer::get_instance()->get_command_list();
 
     cmd_list->SetPipelineState(m_pipelineState->PSO());
     cmd_list->SetGraphicsRootSignature(m_pipelineState->dx12RootSignature());
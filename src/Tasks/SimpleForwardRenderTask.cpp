@@ -3,6 +3,7 @@
 #include "MainScene.h"
 #include "Renderer.h"
 #include "DX12Resource/RenderTarget.h"
+#include "DX12Wrappers/ParallelRecorder.h"
 #include "IRenderTask.h"
 
 
@@ -16,7 +17,7 @@ SimpleForwardRenderTask::~SimpleForwardRenderTask()
 
 void SimpleForwardRenderTask::render()
 {
-    auto cmd_list = Renderer::get_instance()->g_pd3dCommandList;
+    auto cmd_list = Renderer::get_instance()->get_command_list();
 
     cmd_list->SetPipelineState(m_pipelineState->PSO());
     auto dsv = m_depthStencil->heap()->GetCPUDescriptorHandleForHeapStart();
@@ -24,6 +25,13 @@ void SimpleForwardRenderTask::render()
 
 
     MainScene::get_instance()->runFrame();
+
+    // Models queued themselves during runFrame, worker lists need the pass' targets too
+    ParallelRecorder::getInstance()->recordAll([this, dsv](ID3D12GraphicsCommandList6* commandList)
+    {
+        commandList->SetPipelineState(m_pipelineState->PSO());
+        commandList->OMSetRenderTargets(1, m_renderTarget->getHandle(), FALSE, &dsv);
+    });
 }
 
 void SimpleForwardRenderTask::prepare()
@@ -0,0 +1,77 @@
+#include "BenchmarkStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace stats
+{
+    void SampleRing::reset(uint32_t capacity)
+    {
+        m_samples.assign(std::max(capacity, 1u), 0.0f);
+        m_head = 0;
+        m_size = 0;
+    }
+
+    void SampleRing::push(float sample)
+    {
+        if (m_samples.empty())
+            reset(1);
+
+        m_samples[m_head] = sample;
+        m_head = (m_head + 1) % capacity();
+        m_size = std::min(m_size + 1, capacity());
+    }
+
+    float SampleRing::at(uint32_t index) const
+    {
+        uint32_t const oldest = (m_head + capacity() - m_size) % capacity();
+        return m_samples[(oldest + index) % capacity()];
+    }
+
+    void SampleRing::copySamples(std::vector<float>& samples) const
+    {
+        samples.resize(m_size);
+        for (uint32_t i = 0; i < m_size; i++)
+        {
+            samples[i] = at(i);
+        }
+    }
+
+    float percentile(std::vector<float> const& sortedSamples, float fraction)
+    {
+        if (sortedSamples.empty())
+            return 0.0f;
+
+        size_t const rank = static_cast<size_t>(std::ceil(fraction * sortedSamples.size()));
+        return sortedSamples[std::clamp<size_t>(rank, 1, sortedSamples.size()) - 1];
+    }
+
+    BenchmarkStatistics computeStatistics(std::vector<float> samples)
+    {
+        BenchmarkStatistics statistics;
+        if (samples.empty())
+            return statistics;
+
+        // Welford, stays accurate for long runs of nearly equal frame times
+        double mean = 0.0;
+        double squaredDeviations = 0.0;
+        for (uint32_t i = 0; i < samples.size(); i++)
+        {
+            double const delta = samples[i] - mean;
+            mean += delta / (i + 1);
+            squaredDeviations += delta * (samples[i] - mean);
+        }
+
+        std::sort(samples.begin(), samples.end());
+        statistics.count = static_cast<uint32_t>(samples.size());
+        statistics.min = samples.front();
+        statistics.max = samples.back();
+        statistics.mean = static_cast<float>(mean);
+        statistics.median = percentile(samples, 0.5f);
+        statistics.p95 = percentile(samples, 0.95f);
+        statistics.p99 = percentile(samples, 0.99f);
+        if (samples.size() > 1)
+            statistics.stddev = static_cast<float>(std::sqrt(squaredDeviations / (samples.size() - 1)));
+        return statistics;
+    }
+}
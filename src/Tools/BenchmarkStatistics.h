@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// No engine dependencies, so it can be fed synthetic sample streams outside of the renderer
+namespace stats
+{
+    struct BenchmarkStatistics
+    {
+        uint32_t count = 0;
+        float min = 0.0f;
+        float max = 0.0f;
+        float mean = 0.0f;
+        float median = 0.0f;
+        float p95 = 0.0f;
+        float p99 = 0.0f;
+        float stddev = 0.0f; // sample standard deviation, 0 for less than two samples
+    };
+
+    /*
+     * Fixed capacity sample storage, memory is allocated in reset() only so pushing never allocates mid benchmark.
+     * When full, the oldest sample is overwritten.
+     */
+    class SampleRing
+    {
+    public:
+        void reset(uint32_t capacity);
+        void push(float sample);
+
+        uint32_t size() const { return m_size; }
+        uint32_t capacity() const { return static_cast<uint32_t>(m_samples.size()); }
+        // i-th oldest sample
+        float at(uint32_t index) const;
+        // Samples oldest first
+        void copySamples(std::vector<float>& samples) const;
+
+    private:
+        std::vector<float> m_samples;
+        uint32_t m_head = 0;
+        uint32_t m_size = 0;
+    };
+
+    // Nearest rank percentile of sorted samples, fraction in [0, 1]
+    float percentile(std::vector<float> const& sortedSamples, float fraction);
+
+    BenchmarkStatistics computeStatistics(std::vector<float> samples);
+}
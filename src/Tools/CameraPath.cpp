@@ -0,0 +1,174 @@
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace paths
+{
+    namespace
+    {
+        const float PI = 3.14159265358979f;
+        // Arc length samples per spline segment, enough for constant speed to within a few percent
+        const uint32_t SPLINE_SAMPLES_PER_SEGMENT = 32;
+
+        // [0, 1) from the top 24 bits, identical everywhere unlike std::uniform_real_distribution
+        float random01(std::mt19937& random)
+        {
+            return static_cast<float>(random() >> 8) * (1.0f / 16777216.0f);
+        }
+
+        float randomRange(std::mt19937& random, float min, float max)
+        {
+            return min + (max - min) * random01(random);
+        }
+
+        hlsl::float3 randomDirection(std::mt19937& random)
+        {
+            const float z = randomRange(random, -1.0f, 1.0f);
+            const float phi = randomRange(random, 0.0f, 2.0f * PI);
+            const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+            return hlsl::float3(r * std::cos(phi), r * std::sin(phi), z);
+        }
+
+        hlsl::float3 randomPointInShell(std::mt19937& random, float innerRadius, float outerRadius)
+        {
+            return randomDirection(random) * randomRange(random, innerRadius, outerRadius);
+        }
+
+        void generateRandom(const CameraPathSettings& settings, std::mt19937& random, CameraPath& path)
+        {
+            for (uint32_t i = 0; i < settings.frameCount; i++)
+            {
+                path.positions.push_back(randomPointInShell(random, settings.innerRadius, settings.outerRadius));
+                path.lookAts.push_back(randomPointInShell(random, 0.0f, settings.innerRadius));
+            }
+        }
+
+        void generateOrbit(const CameraPathSettings& settings, std::mt19937& random, CameraPath& path)
+        {
+            const float startAngle = randomRange(random, 0.0f, 2.0f * PI);
+            const float tilt = randomRange(random, -0.25f * PI, 0.25f * PI);
+            const float baseRadius = 0.5f * (settings.innerRadius + settings.outerRadius);
+            const float radiusDrift = 0.25f * (settings.outerRadius - settings.innerRadius);
+
+            for (uint32_t i = 0; i < settings.frameCount; i++)
+            {
+                const float t = static_cast<float>(i) / std::max(settings.frameCount, 1u);
+                const float angle = startAngle + 2.0f * PI * t;
+                // Two slow radius cycles per orbit, so LOD and culling see both near and far views
+                const float radius = baseRadius + radiusDrift * std::sin(4.0f * PI * t);
+                const float height = radius * std::sin(tilt) * std::sin(angle);
+                const float planar = std::sqrt(std::max(0.0f, radius * radius - height * height));
+                path.positions.push_back(hlsl::float3(planar * std::cos(angle), height, planar * std::sin(angle)));
+                path.lookAts.push_back(hlsl::float3(0.0f, 0.0f, 0.0f));
+            }
+        }
+
+        void generateFlythrough(const CameraPathSettings& settings, std::mt19937& random, CameraPath& path)
+        {
+            const hlsl::float3 direction = randomDirection(random);
+            const hlsl::float3 through = randomPointInShell(random, 0.0f, settings.innerRadius);
+            const hlsl::float3 start = through - direction * settings.outerRadius;
+            const hlsl::float3 end = through + direction * settings.outerRadius;
+
+            for (uint32_t i = 0; i < settings.frameCount; i++)
+            {
+                const float t = static_cast<float>(i) / std::max(settings.frameCount - 1, 1u);
+                const hlsl::float3 position = start + (end - start) * t;
+                path.positions.push_back(position);
+                path.lookAts.push_back(position + direction * settings.innerRadius);
+            }
+        }
+
+        void generateSpline(const CameraPathSettings& settings, std::mt19937& random, CameraPath& path)
+        {
+            const uint32_t keyCount = std::max(settings.keyPointCount, 4u);
+            std::vector<hlsl::float3> keyPositions(keyCount);
+            std::vector<hlsl::float3> keyLookAts(keyCount);
+            for (uint32_t i = 0; i < keyCount; i++)
+            {
+                keyPositions[i] = randomPointInShell(random, settings.innerRadius, settings.outerRadius);
+                keyLookAts[i] = randomPointInShell(random, 0.0f, settings.innerRadius);
+            }
+
+            auto evaluate = [&](const std::vector<hlsl::float3>& keys, float u)
+            {
+                const uint32_t segment = std::min(static_cast<uint32_t>(u), keyCount - 1);
+                const float t = u - static_cast<float>(segment);
+                return catmullRom(
+                    keys[(segment + keyCount - 1) % keyCount],
+                    keys[segment],
+                    keys[(segment + 1) % keyCount],
+                    keys[(segment + 2) % keyCount],
+                    t);
+            };
+
+            // Cumulative arc length table, frames are then spread evenly along the curve instead of the parameter
+            const uint32_t sampleCount = keyCount * SPLINE_SAMPLES_PER_SEGMENT;
+            std::vector<float> arcLength(sampleCount + 1, 0.0f);
+            hlsl::float3 previous = evaluate(keyPositions, 0.0f);
+            for (uint32_t i = 1; i <= sampleCount; i++)
+            {
+                const hlsl::float3 current = evaluate(keyPositions, static_cast<float>(i) / SPLINE_SAMPLES_PER_SEGMENT);
+                arcLength[i] = arcLength[i - 1] + hlsl::length(current - previous);
+                previous = current;
+            }
+
+            uint32_t sample = 0;
+            for (uint32_t i = 0; i < settings.frameCount; i++)
+            {
+                const float distance = arcLength.back() * static_cast<float>(i) / std::max(settings.frameCount, 1u);
+                while (sample + 1 < sampleCount && arcLength[sample + 1] < distance)
+                    sample++;
+
+                const float sampleLength = arcLength[sample + 1] - arcLength[sample];
+                const float fraction = sampleLength > 0.0f ? (distance - arcLength[sample]) / sampleLength : 0.0f;
+                const float u = (static_cast<float>(sample) + std::clamp(fraction, 0.0f, 1.0f)) / SPLINE_SAMPLES_PER_SEGMENT;
+                path.positions.push_back(evaluate(keyPositions, u));
+                path.lookAts.push_back(evaluate(keyLookAts, u));
+            }
+        }
+    }
+
+    void generateCameraPath(const CameraPathSettings& settings, CameraPath& path)
+    {
+        path.settings = settings;
+        path.positions.clear();
+        path.lookAts.clear();
+        path.positions.reserve(settings.frameCount);
+        path.lookAts.reserve(settings.frameCount);
+
+        std::mt19937 random(settings.seed);
+        if (settings.type == PATH_RANDOM)
+            generateRandom(settings, random, path);
+        else if (settings.type == PATH_ORBIT)
+            generateOrbit(settings, random, path);
+        else if (settings.type == PATH_FLYTHROUGH)
+            generateFlythrough(settings, random, path);
+        else if (settings.type == PATH_SPLINE)
+            generateSpline(settings, random, path);
+    }
+
+    hlsl::float3 catmullRom(const hlsl::float3& p0, const hlsl::float3& p1, const hlsl::float3& p2, const hlsl::float3& p3, float t)
+    {
+        const float t2 = t * t;
+        const float t3 = t2 * t;
+        return (p1 * 2.0f +
+            (p2 - p0) * t +
+            (p0 * 2.0f - p1 * 5.0f + p2 * 4.0f - p3) * t2 +
+            (p1 * 3.0f - p0 - p2 * 3.0f + p3) * t3) * 0.5f;
+    }
+
+    const char* getName(CameraPathType type)
+    {
+        switch (type)
+        {
+        case PATH_RANDOM: return "Random";
+        case PATH_ORBIT: return "Orbit";
+        case PATH_FLYTHROUGH: return "Fly-through";
+        case PATH_SPLINE: return "Spline";
+        default: return "Unknown";
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "utils/maths.h"
+
+namespace paths
+{
+    enum CameraPathType : uint32_t
+    {
+        PATH_RANDOM,     // independent random position every frame, no frame-to-frame coherence
+        PATH_ORBIT,      // circles the model, radius and height drift slowly
+        PATH_FLYTHROUGH, // straight pass through the model
+        PATH_SPLINE,     // closed Catmull-Rom loop through random key points, constant speed
+        PATH_TYPE_COUNT
+    };
+
+    struct CameraPathSettings
+    {
+        CameraPathType type = PATH_SPLINE;
+        uint32_t seed = 1;
+        uint32_t frameCount = 1000;
+        float innerRadius = 12.0f; // look-at targets are picked inside
+        float outerRadius = 40.0f; // positions stay inside
+        uint32_t keyPointCount = 8;
+    };
+
+    struct CameraPath
+    {
+        CameraPathSettings settings;
+        std::vector<hlsl::float3> positions;
+        std::vector<hlsl::float3> lookAts;
+    };
+
+    /*
+     * Same settings give the same path on every machine and build. Random numbers come straight from std::mt19937,
+     * standard distributions are implementation defined and would differ between compilers.
+     */
+    void generateCameraPath(const CameraPathSettings& settings, CameraPath& path);
+
+    // Uniform Catmull-Rom segment between p1 and p2, t in [0, 1]
+    hlsl::float3 catmullRom(const hlsl::float3& p0, const hlsl::float3& p1, const hlsl::float3& p2, const hlsl::float3& p3, float t);
+
+    const char* getName(CameraPathType type);
+}
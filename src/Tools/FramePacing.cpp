@@ -0,0 +1,45 @@
+#include "FramePacing.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace pacing
+{
+    void FrameTracker::setFramesInFlight(uint32_t count)
+    {
+        m_framesInFlight = std::max(count, 1u);
+    }
+
+    uint64_t FrameTracker::fenceToWaitFor() const
+    {
+        if (m_submittedFences.size() < m_framesInFlight)
+            return 0;
+
+        // Once it completes, framesInFlight - 1 frames stay in flight and the new one makes it framesInFlight
+        return m_submittedFences[m_submittedFences.size() - m_framesInFlight];
+    }
+
+    void FrameTracker::beginFrame()
+    {
+        assert(!m_inFrame && "beginFrame() called twice without endFrame()");
+        m_inFrame = true;
+        m_frameNumber++;
+    }
+
+    void FrameTracker::endFrame(uint64_t fenceValue)
+    {
+        assert(m_inFrame && "endFrame() called without beginFrame()");
+        assert(fenceValue > m_lastFenceValue && "Frame fence values have to increase");
+        m_inFrame = false;
+        m_lastFenceValue = fenceValue;
+        m_submittedFences.push_back(fenceValue);
+    }
+
+    void FrameTracker::retire(uint64_t completedFenceValue)
+    {
+        while (!m_submittedFences.empty() && m_submittedFences.front() <= completedFenceValue)
+        {
+            m_submittedFences.pop_front();
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+
+// No D3D12 dependencies, completed fence values are passed in, so the bookkeeping can be driven by a fake fence
+namespace pacing
+{
+    /*
+     * Fences of frames in flight. A frame is recorded between beginFrame() and endFrame(), which takes the fence its
+     * command lists were signalled with. At most framesInFlight frames are submitted and not yet complete: before
+     * recording, the CPU waits for the fence of the frame framesInFlight frames back, never for the newest one.
+     */
+    class FrameTracker
+    {
+    public:
+        // Frames already in flight are kept, so it can change at any time
+        void setFramesInFlight(uint32_t count);
+        uint32_t framesInFlight() const { return m_framesInFlight; }
+
+        // Fence that has to complete before the next frame may start recording, 0 when there is none
+        uint64_t fenceToWaitFor() const;
+
+        void beginFrame();
+        void endFrame(uint64_t fenceValue);
+        // Forgets frames whose fence is at most completedFenceValue
+        void retire(uint64_t completedFenceValue);
+
+        bool isInFrame() const { return m_inFrame; }
+        // Frames started so far
+        uint64_t frameNumber() const { return m_frameNumber; }
+        // Submitted frames not known to be complete
+        uint32_t pendingFrames() const { return static_cast<uint32_t>(m_submittedFences.size()); }
+
+    private:
+        uint32_t m_framesInFlight = 2;
+        bool m_inFrame = false;
+        uint64_t m_frameNumber = 0;
+        uint64_t m_lastFenceValue = 0;
+        std::deque<uint64_t> m_submittedFences;
+    };
+}
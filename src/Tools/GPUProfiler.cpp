@@ -1,5 +1,6 @@
 #include "GPUProfiler.h"
 
+#include <cstring>
 #include <imgui.h>
 #include <Renderer.h>
 #include <iostream>
@@ -7,6 +8,8 @@
 
 #include "Editor.h"
 #include "MeshletBenchmark.h"
+#include "PerformanceCounters.h"
+#include "TimelineRecorder.h"
 
 GPUProfiler* GPUProfiler::m_instance;
 
@@ -20,43 +23,18 @@ GPUProfiler* GPUProfiler::getInstance()
     return m_instance;
 }
 
-ProfilerEntry* GPUProfiler::startEntry(ID3D12GraphicsCommandList6* cmdList, const std::string name)
+void D3D12TimestampSource::create(ID3D12Device2* device, ID3D12CommandQueue* queue, uint32_t queryCount)
 {
-    cmdList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, currentStampIndex);
-    ProfilerEntry* entry = new ProfilerEntry();
-    entry->name = name;
-    entry->start_index = currentStampIndex;
-    entry->end_index = NAN;
-    entry->nesting = m_currentNesting;
-    currentStampIndex++;
-    m_currentNesting++;
-    entries.push_back(entry);
-    return entry;
-}
-
-void GPUProfiler::endEntry(ID3D12GraphicsCommandList6* cmdList, ProfilerEntry* entry)
-{
-    cmdList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, currentStampIndex);
-    entry->end_index = currentStampIndex;
-    currentStampIndex++;
-    m_currentNesting--;
-}
-
-void GPUProfiler::startRecording()
-{
-
-    auto device = Renderer::get_instance()->get_device();
     D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
-    queryHeapDesc.Count = 1000; // At least two timestamps: one at the start and one at the end of the frame
+    queryHeapDesc.Count = queryCount;
     queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
     queryHeapDesc.NodeMask = 0;
 
-    AssertFailed(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap)));
+    AssertFailed(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&m_queryHeap)));
 
     D3D12_RESOURCE_DESC bufferDesc = {};
     bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    // allocate memory for a 1000 timestamps
-    bufferDesc.Width = sizeof(UINT64) * 1000; // Space for 1000 timestamps
+    bufferDesc.Width = sizeof(UINT64) * queryCount;
     bufferDesc.Height = 1;
     bufferDesc.DepthOrArraySize = 1;
     bufferDesc.MipLevels = 1;
@@ -73,42 +51,137 @@ void GPUProfiler::startRecording()
         &bufferDesc,
         D3D12_RESOURCE_STATE_COPY_DEST,
         nullptr,
-        IID_PPV_ARGS(&readbackBuffer)));
+        IID_PPV_ARGS(&m_readbackBuffer)));
+
+    AssertFailed(queue->GetTimestampFrequency(&m_frequency));
 }
 
-void GPUProfiler::endRecording(ID3D12GraphicsCommandList6* cmdList)
+void D3D12TimestampSource::writeTimestamp(uint32_t queryIndex)
 {
+    m_cmdList->EndQuery(m_queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, queryIndex);
+}
 
-    cmdList->ResolveQueryData(
-        queryHeap,
+void D3D12TimestampSource::resolve(uint32_t firstQuery, uint32_t queryCount)
+{
+    m_cmdList->ResolveQueryData(
+        m_queryHeap,
         D3D12_QUERY_TYPE_TIMESTAMP,
-        0, // Start index
-        currentStampIndex, // Number of queries
-        readbackBuffer,
-        0 // Destination buffer offset
+        firstQuery,
+        queryCount,
+        m_readbackBuffer,
+        sizeof(UINT64) * firstQuery
     );
-    for (auto& entry : entries)
-        delete entry;
-    entries.clear();
 }
 
-float GPUProfiler::collectData()
+bool D3D12TimestampSource::isComplete(uint64_t fenceValue)
+{
+    return Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->is_fence_complete(fenceValue);
+}
+
+void D3D12TimestampSource::readTimestamps(uint32_t firstQuery, uint32_t queryCount, uint64_t* timestamps)
+{
+    D3D12_RANGE readRange = { sizeof(UINT64) * firstQuery, sizeof(UINT64) * (firstQuery + queryCount) };
+    UINT64* data = nullptr;
+    AssertFailed(m_readbackBuffer->Map(0, &readRange, reinterpret_cast<void**>(&data)));
+    memcpy(timestamps, data + firstQuery, sizeof(UINT64) * queryCount);
+    D3D12_RANGE writeRange = { 0, 0 };
+    m_readbackBuffer->Unmap(0, &writeRange);
+}
+
+void D3D12TimestampSource::calibrate(ID3D12CommandQueue* queue)
+{
+    UINT64 cpuTimestamp;
+    AssertFailed(queue->GetClockCalibration(&m_calibrationTicks, &cpuTimestamp));
+    // Sampled right after instead of converting the QPC value, so the pair lands on the timeline clock
+    m_calibrationNanoseconds = TimelineRecorder::now();
+}
+
+int64_t D3D12TimestampSource::toTimelineNanoseconds(uint64_t ticks) const
+{
+    double const deltaTicks = static_cast<double>(static_cast<int64_t>(ticks - m_calibrationTicks));
+    return m_calibrationNanoseconds + static_cast<int64_t>(deltaTicks * 1e9 / static_cast<double>(m_frequency));
+}
+
+uint32_t GPUProfiler::internName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_namesMutex);
+    return m_frames.internName(name);
+}
+
+ProfilerEntry* GPUProfiler::startEntry(ID3D12GraphicsCommandList6* cmdList, uint32_t nameId)
 {
-    D3D12_RANGE readRange = { 0, sizeof(uint64_t) * currentStampIndex };
-    readbackBuffer->Map(0, &readRange, reinterpret_cast<void**>(&timestampData));
-    
-    Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->get_d_3d12_command_queue()->GetTimestampFrequency(&m_gpuFrequency);
+    if (std::this_thread::get_id() != m_recordingThread)
+        return nullptr;
 
-    return -1.0f;
+    m_timestampSource.setCommandList(cmdList);
+    return m_frames.startEntry(nameId);
+}
+
+void GPUProfiler::endEntry(ID3D12GraphicsCommandList6* cmdList, ProfilerEntry* entry)
+{
+    if (entry == nullptr)
+        return;
+
+    m_timestampSource.setCommandList(cmdList);
+    m_frames.endEntry(entry);
+}
+
+void GPUProfiler::startRecording()
+{
+    auto renderer = Renderer::get_instance();
+    auto queue = renderer->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->get_d_3d12_command_queue();
+    // Two timestamps per entry, separate range for every frame in the ring
+    m_timestampSource.create(renderer->get_device(), queue, READBACK_FRAMES * MAX_ENTRIES_PER_FRAME * 2);
+    m_frames.initialize(&m_timestampSource, READBACK_FRAMES, MAX_ENTRIES_PER_FRAME);
+    // One per draw path of Model::draw: per mesh, merged geometry and ExecuteIndirect
+    m_benchmarkNames = { internName("Dispatch Mesh"), internName("Dispatch Merged"), internName("Dispatch Indirect") };
+    m_recordingThread = std::this_thread::get_id();
+}
+
+void GPUProfiler::endRecording(ID3D12GraphicsCommandList6* cmdList)
+{
+    m_timestampSource.setCommandList(cmdList);
+    m_frames.endFrame();
+}
+
+void GPUProfiler::processFinishedFrames()
+{
+    auto timeline = TimelineRecorder::getInstance();
+    bool const toTimeline = timeline->acceptsGpuZones();
+    if (toTimeline && !m_timelineCalibrated)
+    {
+        m_timestampSource.calibrate(Renderer::get_instance()->get_cmd_queue(D3D12_COMMAND_LIST_TYPE_DIRECT)->get_d_3d12_command_queue());
+    }
+    m_timelineCalibrated = toTimeline;
+
+    // Every finished frame goes to the benchmark exactly once, the editor shows the newest one
+    while (collectData())
+    {
+        for (int i = 0; i < numEntries(); i++)
+        {
+            auto const resolvedEntry = getEntryTime(i);
+            if (toTimeline)
+            {
+                timeline->recordGpuZone(resolvedEntry.name,
+                    m_timestampSource.toTimelineNanoseconds(resolvedEntry.startTicks),
+                    m_timestampSource.toTimelineNanoseconds(resolvedEntry.endTicks));
+            }
+        }
+
+        // Every mesh records its own dispatch and the benchmark gets their sum, the merged and indirect paths record a single one
+        float dispatchTime = 0.0f;
+        if (m_frames.sumResolved(m_benchmarkNames, dispatchTime))
+        {
+            MeshletBenchmark::getInstance()->update(m_useMicroSeconds ? dispatchTime * 1000.0f : dispatchTime);
+        }
+    }
 }
 
 ResolvedProfilerEntry GPUProfiler::getEntryTime(uint32_t index) const
 {
-    double time = (static_cast<double>(timestampData[entries[index]->end_index]) - static_cast<double>(timestampData[entries[index]->start_index])) / m_gpuFrequency * 1000.0f * (m_useMicroSeconds ? 1000.0f : 1.0f);
-    ResolvedProfilerEntry entry;
-    entry.name = entries[index]->name;
-    entry.time = static_cast<float>(time);
-    entry.nesting = entries[index]->nesting;
+    ResolvedProfilerEntry entry = m_frames.getResolved(index);
+    if (m_useMicroSeconds)
+        entry.time *= 1000.0f;
     return entry;
 }
 
@@ -117,7 +190,6 @@ void GPUProfiler::drawEditor(EditorWindow* const& window)
     bool is_still_open = true;
     auto profiler = GPUProfiler::getInstance();
     ImGui::Begin(window->get_name().c_str(), &is_still_open, window->flags);
-    profiler->collectData();
     bool useMicroSeconds = profiler->useMicroSeconds();
     if (ImGui::Checkbox("Use Microseconds", &useMicroSeconds))
     {
@@ -131,17 +203,11 @@ void GPUProfiler::drawEditor(EditorWindow* const& window)
         {
             ImGui::Indent();
         }
-        if (resolvedEntry.name.compare("Dispatch Mesh"))
-        {
-            MeshletBenchmark::getInstance()->update(resolvedEntry.time);
-        }
-
-
 
         if (useMicroSeconds)
-            ImGui::Text("* %s: %.3f us", resolvedEntry.name.c_str(), resolvedEntry.time);
+            ImGui::Text("* %s: %.3f us", resolvedEntry.name, resolvedEntry.time);
         else
-            ImGui::Text("* %s: %.3f ms", resolvedEntry.name.c_str(), resolvedEntry.time);
+            ImGui::Text("* %s: %.3f ms", resolvedEntry.name, resolvedEntry.time);
 
         for (uint32_t j = 0; j < resolvedEntry.nesting; j++)
         {
@@ -149,8 +215,17 @@ void GPUProfiler::drawEditor(EditorWindow* const& window)
         }
     }
 
+    if (m_frames.droppedEntries() > 0)
+    {
+        ImGui::Text("%u entries over the per frame limit were dropped", m_frames.droppedEntries());
+    }
+    if (m_frames.lostFrames() > 0)
+    {
+        ImGui::Text("%llu frames were overwritten before readback", static_cast<unsigned long long>(m_frames.lostFrames()));
+    }
 
+    TimelineRecorder::getInstance()->drawEditor();
+    counters::drawEditor();
 
-    profiler->unmap();
     ImGui::End();
 }
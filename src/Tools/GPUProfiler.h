@@ -2,48 +2,74 @@
 // Author: Hubert Olejnik
 #pragma once
 #include <d3d12.h>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Editor.h"
+#include "ITimestampSource.h"
+#include "ProfilerFrameRing.h"
 
 
-struct ProfilerEntry
+class D3D12TimestampSource : public ITimestampSource
 {
-    std::string name;
-	uint32_t start_index;
-    uint32_t end_index;
-	uint32_t nesting;
-};
+public:
+    void create(ID3D12Device2* device, ID3D12CommandQueue* queue, uint32_t queryCount);
+    void setCommandList(ID3D12GraphicsCommandList6* cmdList) { m_cmdList = cmdList; }
 
-struct ResolvedProfilerEntry
-{
-    std::string name;
-    float time;
-    uint32_t nesting;
+    void writeTimestamp(uint32_t queryIndex) override;
+    void resolve(uint32_t firstQuery, uint32_t queryCount) override;
+    bool isComplete(uint64_t fenceValue) override;
+    void readTimestamps(uint32_t firstQuery, uint32_t queryCount, uint64_t* timestamps) override;
+    uint64_t getFrequency() override { return m_frequency; }
+
+    // Pairs a GPU timestamp with TimelineRecorder::now(), needed before toTimelineNanoseconds
+    void calibrate(ID3D12CommandQueue* queue);
+    int64_t toTimelineNanoseconds(uint64_t ticks) const;
+
+private:
+    ID3D12GraphicsCommandList6* m_cmdList = nullptr;
+    ID3D12QueryHeap* m_queryHeap = nullptr;
+    ID3D12Resource* m_readbackBuffer = nullptr;
+    UINT64 m_frequency = 1;
+    UINT64 m_calibrationTicks = 0;
+    int64_t m_calibrationNanoseconds = 0;
 };
 
-// This is bug-prone, as it assumes there is only one command list, change later.
+/*
+ * Entries are recorded from the thread that called startRecording() only, entries started on other threads are
+ * nullptr and endEntry() ignores them, see ParallelRecorder. Names can be interned from any thread.
+ */
 class GPUProfiler
 {
 public:
 	GPUProfiler() = default;
 	~GPUProfiler() = default;
 
+	// Frames that can be recorded before the oldest one has to be read back
+	static constexpr uint32_t READBACK_FRAMES = 4;
+	static constexpr uint32_t MAX_ENTRIES_PER_FRAME = 1024;
+
 	static void create();
 	static GPUProfiler* getInstance();
 
-    ProfilerEntry* startEntry(ID3D12GraphicsCommandList6* cmdList, const std::string name);
+	// Call once per call site and keep the id, e.g. static const uint32_t name = profiler->internName("Frame");
+	uint32_t internName(const std::string& name);
+
+    ProfilerEntry* startEntry(ID3D12GraphicsCommandList6* cmdList, uint32_t nameId);
     void endEntry(ID3D12GraphicsCommandList6* cmdList, ProfilerEntry* entry);
 
-	void startFrame() { currentStampIndex = 0; }
+	void startFrame() { m_frames.beginFrame(); }
 	void startRecording();
 	void endRecording(ID3D12GraphicsCommandList6* cmdList);
-	float collectData();
-	float frameTime() { return lastFrameTime; }
-    int numEntries() { return entries.size(); }
+	void frameSubmitted(uint64_t fenceValue) { m_frames.frameSubmitted(fenceValue); }
+	// Reads back the oldest finished frame, false when there is none yet
+	bool collectData() { return m_frames.collect(); }
+	// Hands every finished frame to the meshlet benchmark and the timeline, once per frame after submit
+	void processFinishedFrames();
+    int numEntries() { return m_frames.numResolved(); }
 	ResolvedProfilerEntry getEntryTime(uint32_t index) const;
-	void unmap() {readbackBuffer->Unmap(0, nullptr); }
 
     void setDisplayMode(bool useMicroSeconds) { m_useMicroSeconds = useMicroSeconds; }
 	bool useMicroSeconds() { return m_useMicroSeconds; }
@@ -53,19 +79,13 @@ public:
 private:
     static GPUProfiler* m_instance;
 
-
-	uint32_t m_currentNesting = 0;
-	uint64_t currentStampIndex = 0;
-	float lastFrameTime = 0.0f;
-	UINT64 m_gpuFrequency;
-
-	UINT64* timestampData;
-
-	ID3D12QueryHeap* queryHeap;
-	ID3D12Resource* readbackBuffer;
+	D3D12TimestampSource m_timestampSource;
+	ProfilerFrameRing m_frames;
+	// Dispatch entries of every draw path, each finished frame with any of them is a benchmark sample
+	std::vector<uint32_t> m_benchmarkNames;
+	bool m_timelineCalibrated = false;
+	std::thread::id m_recordingThread;
+	std::mutex m_namesMutex;
 
 	bool m_useMicroSeconds = false;
-
-    std::vector<ProfilerEntry*> entries;
 };
-
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+/*
+ * Where the profiler gets its timestamps from. The D3D12 implementation lives next to GPUProfiler,
+ * anything else (e.g. a fake clock) can be plugged into ProfilerFrameRing to drive it without a device.
+ */
+class ITimestampSource
+{
+public:
+    virtual ~ITimestampSource() = default;
+
+    // Records a timestamp into query slot queryIndex
+    virtual void writeTimestamp(uint32_t queryIndex) = 0;
+    // Makes queries [firstQuery, firstQuery + queryCount) readable once the frame completes
+    virtual void resolve(uint32_t firstQuery, uint32_t queryCount) = 0;
+    // True when the submission signalled with fenceValue finished on the GPU
+    virtual bool isComplete(uint64_t fenceValue) = 0;
+    virtual void readTimestamps(uint32_t firstQuery, uint32_t queryCount, uint64_t* timestamps) = 0;
+    // Ticks per second
+    virtual uint64_t getFrequency() = 0;
+};
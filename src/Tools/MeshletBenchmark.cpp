@@ -1,17 +1,18 @@
 #include "MeshletBenchmark.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <imgui.h>
-#include <random>
 
 #include "Camera.h"
 #include "GPUProfiler.h"
 #include "Mesh.h"
+#include "PerformanceCounters.h"
 #include "Renderer.h"
 #include "debugGeometry/DebugDrawer.h"
 #include "debugGeometry/VisualiserGeometry.h"
-#include "Serialization/MeshSerializer.h"
+#include "Serialization/CameraPathSerializer.h"
 
 
 MeshletBenchmark* MeshletBenchmark::m_instance;
@@ -39,7 +40,22 @@ void MeshletBenchmark::run(uint32_t numberOfFrames)
 {
     m_framesLeft = numberOfFrames;
     m_scheduledFrames = numberOfFrames;
+    m_warmupFramesLeft = static_cast<uint32_t>(std::max(m_warmupFrames, 0));
+    m_samples.reset(numberOfFrames);
+    m_statistics = {};
     m_running = true;
+    setCameraToFrame(0);
+}
+
+void MeshletBenchmark::setCameraToFrame(uint32_t frame)
+{
+    auto const& positions = m_cameraPath.positions;
+    if (positions.empty())
+        return;
+
+    frame = std::min(frame, static_cast<uint32_t>(positions.size() - 1));
+    Camera::getMainCamera()->entity->transform->set_position(positions[frame]);
+    Camera::getMainCamera()->setLookAt(m_cameraPath.lookAts[frame]);
 }
 
 bool MeshletBenchmark::saveLogToFile()
@@ -51,12 +67,23 @@ bool MeshletBenchmark::saveLogToFile()
 
     // Extract the substring after the last slash
     std::string meshName = m_modelFileName.substr(lastSlashPos + 1);
-    const char* items[] = { "MESHOPTIMIZER","DXMESH", "GREEDY", "BoundingSphere", "NVIDIA" };
+    const char* items[] = { "MESHOPTIMIZER","DXMESH", "GREEDY", "BoundingSphere", "NVIDIA", "COST" };
     std::string path = m_path + meshName + "_" + (m_isBig ? "BIG" : "SMALL") + "_" + (m_culling ? "CULL" : "NOCULL") + "_" + items[m_meshletizerType] + ".log";
+    saveTraceToFile(std::filesystem::path(path).replace_extension(".trace.csv").string());
     std::ofstream file(path);
     if (file.is_open())
     {
-        file << m_accumulatedTime / m_scheduledFrames;
+        // First line stays the mean so older logs remain comparable
+        file << m_statistics.mean << "\n";
+        file << "frames: " << m_statistics.count << "\n";
+        file << "min: " << m_statistics.min << "\n";
+        file << "median: " << m_statistics.median << "\n";
+        file << "mean: " << m_statistics.mean << "\n";
+        file << "p95: " << m_statistics.p95 << "\n";
+        file << "p99: " << m_statistics.p99 << "\n";
+        file << "max: " << m_statistics.max << "\n";
+        file << "stddev: " << m_statistics.stddev << "\n";
+        file << "unit: " << (GPUProfiler::getInstance()->useMicroSeconds() ? "us" : "ms") << "\n";
         //file << "Meshletizer type: " << items[m_meshletizerType] << "\n";
         //file << "Max vertices: " << m_maxVertices << "\n";
         //file << "Max primitives: " << m_maxPrimitives << "\n";
@@ -73,58 +100,72 @@ bool MeshletBenchmark::saveLogToFile()
     return false;
 }
 
-bool MeshletBenchmark::savePositionSequenceToFile()
+bool MeshletBenchmark::saveTraceToFile(std::string const& path) const
 {
-    std::ofstream file(m_sequencesPath
-        + m_positionsFilename, std::ios::binary);
-    if(file.is_open())
+    std::ofstream file(path);
+    if (!file.is_open())
     {
-        serializers::serializeVector(file, m_positions);
-        serializers::serializeVector(file, m_lookAts);
-        file.close();
-        return true;
+        printf("Could not open file %s\n", path.c_str());
+        return false;
     }
-    return false;
+
+    file << "frame,time\n";
+    for (uint32_t i = 0; i < m_samples.size(); i++)
+    {
+        file << i << ',' << m_samples.at(i) << '\n';
+    }
+    return true;
+}
+
+bool MeshletBenchmark::savePositionSequenceToFile()
+{
+    return serializers::serializeCameraPath(m_cameraPath, m_sequencesPath + m_positionsFilename);
 }
 
 bool MeshletBenchmark::loadPositionSequenceFromFile()
 {
-    std::ifstream file(m_sequencesPath + m_positionsFilename, std::ios::binary);
-    if (file.is_open())
-    {
-        serializers::deserializeVector(file, m_positions);
-        serializers::deserializeVector(file, m_lookAts);
-        file.close();
-        return true;
-    }
-    return false;
+    if (!serializers::deserializeCameraPath(m_cameraPath, m_sequencesPath + m_positionsFilename))
+        return false;
+
+    m_pathType = m_cameraPath.settings.type;
+    m_pathSeed = static_cast<int32_t>(m_cameraPath.settings.seed);
+    m_pathKeyPoints = static_cast<int32_t>(m_cameraPath.settings.keyPointCount);
+    m_noOfFrames = static_cast<int32_t>(m_cameraPath.positions.size());
+    return true;
 }
 
 void MeshletBenchmark::update(float time)
 {
     if (m_running)
     {
-        m_accumulatedTime += time;
-        m_framesLeft--;
-        if (m_framesLeft == 0)
+        if (m_warmupFramesLeft > 0)
         {
-            m_running = false;
-            m_saveNow = true;
+            m_warmupFramesLeft--;
         }
-        Camera::getMainCamera()->entity->transform->set_position(m_positions[m_framesLeft]);
-        Camera::getMainCamera()->setLookAt(m_lookAts[m_framesLeft]);
+        else
+        {
+            m_samples.push(time);
+            m_framesLeft--;
+            if (m_framesLeft == 0)
+            {
+                std::vector<float> samples;
+                m_samples.copySamples(samples);
+                m_statistics = stats::computeStatistics(samples);
+                m_running = false;
+                m_saveNow = true;
+            }
+        }
+        // Path is walked forward, warm-up stays at its first position
+        if (m_running)
+            setCameraToFrame(m_scheduledFrames - m_framesLeft);
     }
 }
 
-void MeshletBenchmark::startMeshletizing()
+void MeshletBenchmark::recordMeshletizing(std::chrono::nanoseconds duration)
 {
-    m_meshletizingStart = std::chrono::high_resolution_clock::now();
-}
-
-void MeshletBenchmark::endMeshletizing()
-{
-    auto end = std::chrono::high_resolution_clock::now();
-    m_meshletizingTime = std::chrono::duration<float>(end - m_meshletizingStart).count();
+    m_meshletizingTime = std::chrono::duration<float>(duration).count();
+    counters::add(counters::MESHLETIZER_INVOCATIONS);
+    counters::add(counters::MESHLETIZER_NANOSECONDS, duration.count());
 }
 
 
@@ -144,7 +185,7 @@ void MeshletBenchmark::drawEditor()
     ImGui::Text("Max meshlet primitives: %i", m_maxPrimitives);
     ImGui::Text("Max meshlet vertices: %i", m_maxVertices);
     static int current_item = 0; // Index of the selected item
-    const char* items[] = { "MESHOPTIMIZER","DXMESH", "GREEDY", "BoundingSphere", "NVIDIA" }; // Items in the combo box
+    const char* items[] = { "MESHOPTIMIZER","DXMESH", "GREEDY", "BoundingSphere", "NVIDIA", "COST" }; // Items in the combo box
     ImGui::Text("Meshletizer type: %s", items[static_cast<int>(m_meshletizerType)]);
 
 
@@ -187,11 +228,32 @@ void MeshletBenchmark::drawEditor()
         ImGui::EndListBox();
     }
 
-    if (ImGui::Button("Randomize positions"))
+    const char* pathItems[paths::PATH_TYPE_COUNT];
+    for (uint32_t i = 0; i < paths::PATH_TYPE_COUNT; i++)
+    {
+        pathItems[i] = paths::getName(static_cast<paths::CameraPathType>(i));
+    }
+    int pathIndex = m_pathType;
+    if (ImGui::Combo("Camera path", &pathIndex, pathItems, IM_ARRAYSIZE(pathItems)))
+    {
+        m_pathType = static_cast<paths::CameraPathType>(pathIndex);
+    }
+    ImGui::InputInt("Path seed", &m_pathSeed);
+    if (m_pathType == paths::PATH_SPLINE)
+    {
+        ImGui::InputInt("Key points", &m_pathKeyPoints);
+        m_pathKeyPoints = std::max(m_pathKeyPoints, 4);
+    }
+
+    if (ImGui::Button("Generate path"))
     {
         isLoaded = false;
         generateBenchmarkPositions();
     }
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Same type, seed, radii and frame count give the same path on every machine. Saved under File Name.");
+    }
     if (ImGui::Button("Load positions"))
     {
         loadPositionSequenceFromFile();
@@ -200,21 +262,31 @@ void MeshletBenchmark::drawEditor()
     ImGui::Separator();
 
     ImGui::InputInt("Number of frames to schedule:", &m_noOfFrames);
+    ImGui::InputInt("Warm-up frames:", &m_warmupFrames);
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Rendered before recording starts and not included in the results.");
+    }
     if (ImGui::Button("Start Recording"))
     {
+        if (m_cameraPath.positions.size() < static_cast<size_t>(m_noOfFrames))
+            generateBenchmarkPositions();
         m_model->sendDataToBenchmark();
-        m_accumulatedTime = 0;
         run(m_noOfFrames);
     }
 
     if(m_running)
     {
-        ImGui::Text("Running... \%i frames left", m_framesLeft);
+        if (m_warmupFramesLeft > 0)
+            ImGui::Text("Warming up... %i frames left", m_warmupFramesLeft);
+        else
+            ImGui::Text("Running... \%i frames left", m_framesLeft);
     }
     else
     {
-        float averageTime = m_accumulatedTime / m_scheduledFrames;
-        ImGui::Text("Average model render time: %f\n", averageTime);
+        ImGui::Text("Average model render time: %f\n", m_statistics.mean);
+        ImGui::Text("Min: %f, median: %f, max: %f", m_statistics.min, m_statistics.median, m_statistics.max);
+        ImGui::Text("p95: %f, p99: %f, stddev: %f", m_statistics.p95, m_statistics.p99, m_statistics.stddev);
         ImGui::Text("Not running...");
     }
     
@@ -284,25 +356,13 @@ void MeshletBenchmark::updateModelPath(std::string path)
 
 void MeshletBenchmark::generateBenchmarkPositions()
 {
-    m_positions.clear();
-    m_lookAts.clear();
-    std::random_device rd;
-    std::mt19937 randomEngine(rd()); // Mersenne Twister engine
-
-    std::uniform_real_distribution<> positionDistribution(-m_outerRadius, m_outerRadius);
-    std::uniform_real_distribution<> lookAtDistribution(-m_innerRadius, m_innerRadius);
-    for (int i = 0; i < m_noOfFrames; i++)
-    {
-        hlsl::float3 position = hlsl::float3(
-            positionDistribution(randomEngine),
-            positionDistribution(randomEngine),
-            positionDistribution(randomEngine));
-        position = hlsl::normalizeSafe(position)* positionDistribution(randomEngine);
-
-
-        hlsl::float3 lookAt = hlsl::float3(lookAtDistribution(randomEngine), lookAtDistribution(randomEngine), lookAtDistribution(randomEngine));
-        m_lookAts.push_back(lookAt);
-        m_positions.push_back(position);
-    }
+    paths::CameraPathSettings settings;
+    settings.type = m_pathType;
+    settings.seed = static_cast<uint32_t>(m_pathSeed);
+    settings.frameCount = static_cast<uint32_t>(std::max(m_noOfFrames, 1));
+    settings.innerRadius = m_innerRadius;
+    settings.outerRadius = m_outerRadius;
+    settings.keyPointCount = static_cast<uint32_t>(m_pathKeyPoints);
+    paths::generateCameraPath(settings, m_cameraPath);
     savePositionSequenceToFile();
 }
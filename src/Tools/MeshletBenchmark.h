@@ -2,6 +2,8 @@
 #include <chrono>
 #include <string>
 
+#include "BenchmarkStatistics.h"
+#include "CameraPath.h"
 #include "MeshletStructs.h"
 #include "Model.h"
 #include "utils/maths.h"
@@ -16,8 +18,10 @@ public:
 
     void update(float time);
 
-    void startMeshletizing();
-    void endMeshletizing();
+    // Partition time of the mesh that was meshletized last, see MeshGeometry::getPartitionTime()
+    void recordMeshletizing(std::chrono::nanoseconds duration);
+    // Seconds spent in the last partition step
+    float getMeshletizingTime() const { return m_meshletizingTime; }
 
     static MeshletBenchmark* getInstance();
 
@@ -29,16 +33,21 @@ public:
     void updateModelPath(std::string path);
     void updateCulling(bool culling) { m_culling = culling; }
 
+    // Generates m_noOfFrames camera positions from the path settings and saves them
     void generateBenchmarkPositions();
 
     void setModel(Model* model) { m_model = model; }
+    bool isRunning() const { return m_running; }
 
 
     void saveMeshletizingTimeToFile(std::string filename);
 
 private:
     void run(uint32_t numberOfFrames);
+    void setCameraToFrame(uint32_t frame);
     bool saveLogToFile();
+    // Per frame samples of the last run, frame index and time
+    bool saveTraceToFile(std::string const& path) const;
 
     bool savePositionSequenceToFile();
     bool loadPositionSequenceFromFile();
@@ -67,16 +76,22 @@ private:
     bool m_saveNow = false;
     uint32_t m_framesLeft = 0;
     uint32_t m_scheduledFrames = 0;
-    float m_accumulatedTime = 0;
+
+    // Frames rendered at the first position and thrown away, absorbs shader compiles and residency changes
+    int32_t m_warmupFrames = 60;
+    uint32_t m_warmupFramesLeft = 0;
+    stats::SampleRing m_samples;
+    stats::BenchmarkStatistics m_statistics;
 
 
     uint32_t m_maxVertices = 64;
     uint32_t m_maxPrimitives = 126;
     float m_meshletizingTime = 0.0f;
-    std::chrono::high_resolution_clock::time_point m_meshletizingStart;
 
-    std::vector<hlsl::float3> m_positions;
-    std::vector<hlsl::float3> m_lookAts;
+    paths::CameraPath m_cameraPath;
+    paths::CameraPathType m_pathType = paths::PATH_SPLINE;
+    int32_t m_pathSeed = 1;
+    int32_t m_pathKeyPoints = 8;
 
     int32_t m_noOfFrames = 100000;
 
@@ -0,0 +1,308 @@
+#include "MeshletSweep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#endif
+
+#include "assimp/Importer.hpp"
+#include "assimp/postprocess.h"
+#include "assimp/scene.h"
+#include "BenchmarkStatistics.h"
+#include "MeshGeometry.h"
+
+namespace sweep
+{
+    namespace
+    {
+        struct SourceMesh
+        {
+            std::vector<Vertex> vertices;
+            std::vector<hlsl::float3> positions;
+            std::vector<hlsl::float3> normals;
+            std::vector<hlsl::float2> UVs;
+            std::vector<uint32_t> indices;
+            std::vector<uint32_t> attributes;
+        };
+
+        void printUsage()
+        {
+            printf("Usage: %s <output.csv> [--repeats N] [--vertices 32,64,...] [--primitives 32,64,...] <model> [<model> ...]\n", ARGUMENT);
+        }
+
+        bool parseLimits(char const* text, std::vector<int32_t>& limits)
+        {
+            limits.clear();
+            std::stringstream stream(text);
+            std::string item;
+            while (std::getline(stream, item, ','))
+            {
+                int32_t const limit = std::atoi(item.c_str());
+                if (limit < 3 || limit > 256)
+                    return false;
+                limits.push_back(limit);
+            }
+            return !limits.empty();
+        }
+
+        // Same import as Model::loadModel, without textures and LODs
+        bool importModel(std::string const& path, std::vector<SourceMesh>& meshes)
+        {
+            Assimp::Importer importer;
+            aiScene const* scene = importer.ReadFile(path, aiProcess_FlipUVs | aiProcess_ForceGenNormals | aiProcess_JoinIdenticalVertices);
+            if (scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)
+            {
+                std::cout << "Error. Failed loading a model: " << importer.GetErrorString() << "\n";
+                return false;
+            }
+
+            meshes.resize(scene->mNumMeshes);
+            for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+            {
+                aiMesh const* mesh = scene->mMeshes[i];
+                SourceMesh& source = meshes[i];
+                for (uint32_t v = 0; v < mesh->mNumVertices; v++)
+                {
+                    Vertex vertex = {};
+                    vertex.position = hlsl::float3(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
+                    if (mesh->HasNormals())
+                        vertex.normal = hlsl::float3(mesh->mNormals[v].x, mesh->mNormals[v].y, mesh->mNormals[v].z);
+                    if (mesh->mTextureCoords[0] != nullptr)
+                        vertex.UV = hlsl::float2(mesh->mTextureCoords[0][v].x, mesh->mTextureCoords[0][v].y);
+
+                    source.vertices.push_back(vertex);
+                    source.positions.push_back(vertex.position);
+                    source.normals.push_back(vertex.normal);
+                    source.UVs.push_back(vertex.UV);
+                }
+
+                for (uint32_t f = 0; f < mesh->mNumFaces; f++)
+                {
+                    source.attributes.push_back(mesh->mMaterialIndex);
+                    for (uint32_t k = 0; k < mesh->mFaces[f].mNumIndices; k++)
+                    {
+                        source.indices.push_back(mesh->mFaces[f].mIndices[k]);
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Lets every configuration report its own high-water mark, not supported on Windows
+        void resetPeakMemory()
+        {
+#ifndef _WIN32
+            std::ofstream clearRefs("/proc/self/clear_refs");
+            clearRefs << "5";
+#endif
+        }
+
+        uint64_t getPeakMemory()
+        {
+#ifdef _WIN32
+            PROCESS_MEMORY_COUNTERS counters = {};
+            if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+                return counters.PeakWorkingSetSize;
+            return 0;
+#else
+            std::ifstream status("/proc/self/status");
+            std::string line;
+            while (std::getline(status, line))
+            {
+                if (line.rfind("VmHWM:", 0) == 0)
+                    return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+            }
+            return 0;
+#endif
+        }
+    }
+
+    bool parseArguments(int argc, char** argv, SweepSettings& settings)
+    {
+        int i = 1;
+        if (i < argc && std::strcmp(argv[i], ARGUMENT) == 0)
+            i++;
+
+        if (i >= argc)
+        {
+            printUsage();
+            return false;
+        }
+        settings.outputPath = argv[i++];
+
+        for (; i < argc; i++)
+        {
+            bool const hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--repeats") == 0 && hasValue)
+            {
+                settings.repeats = std::max(std::atoi(argv[++i]), 1);
+            }
+            else if (std::strcmp(argv[i], "--vertices") == 0 && hasValue)
+            {
+                if (!parseLimits(argv[++i], settings.vertexLimits))
+                {
+                    printUsage();
+                    return false;
+                }
+            }
+            else if (std::strcmp(argv[i], "--primitives") == 0 && hasValue)
+            {
+                if (!parseLimits(argv[++i], settings.primitiveLimits))
+                {
+                    printUsage();
+                    return false;
+                }
+            }
+            else
+            {
+                settings.models.push_back(argv[i]);
+            }
+        }
+
+        if (settings.models.empty())
+        {
+            printUsage();
+            return false;
+        }
+        return true;
+    }
+
+    bool isSupported(MeshletizerType type, int32_t maxVerts, int32_t maxPrims)
+    {
+        // Local triangle indices are packed into 8 bits
+        if (maxVerts > 256 || maxPrims > 256)
+            return false;
+        if (type == MESHOPT)
+            return fitsMeshoptimizerLimits(maxVerts, maxPrims);
+        return true;
+    }
+
+    bool run(SweepSettings const& settings, std::vector<SweepResult>& results)
+    {
+        printf("=========MESHLET SWEEP=========\n");
+        for (auto const& model : settings.models)
+        {
+            std::vector<SourceMesh> meshes;
+            if (!importModel(model, meshes))
+                return false;
+
+            for (int32_t typeIndex = 0; typeIndex < MESHLETIZER_TYPE_COUNT; typeIndex++)
+            {
+                auto const type = static_cast<MeshletizerType>(typeIndex);
+                for (int32_t maxVerts : settings.vertexLimits)
+                {
+                    for (int32_t maxPrims : settings.primitiveLimits)
+                    {
+                        if (!isSupported(type, maxVerts, maxPrims))
+                        {
+                            printf("%s %i/%i: skipped\n", getMeshletizerName(type), maxVerts, maxPrims);
+                            continue;
+                        }
+
+                        SweepResult result = {};
+                        result.model = model;
+                        result.type = type;
+                        result.maxVerts = maxVerts;
+                        result.maxPrims = maxPrims;
+
+                        std::vector<float> partitionTimes;
+                        std::vector<float> totalTimes;
+                        uint64_t usedVertices = 0;
+                        uint64_t usedPrimitives = 0;
+                        resetPeakMemory();
+                        for (uint32_t repeat = 0; repeat < settings.repeats; repeat++)
+                        {
+                            double partitionSeconds = 0.0;
+                            double totalSeconds = 0.0;
+                            result.meshletCount = 0;
+                            usedVertices = 0;
+                            usedPrimitives = 0;
+                            for (auto const& source : meshes)
+                            {
+                                auto const start = std::chrono::high_resolution_clock::now();
+                                MeshGeometry const geometry(source.vertices, source.indices, source.positions, source.normals, source.UVs, source.attributes,
+                                    type, maxVerts, maxPrims, {}, {}, getDefaultVertexCacheOptimizer(type));
+                                totalSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                                partitionSeconds += std::chrono::duration<double>(geometry.getPartitionTime()).count();
+
+                                result.meshletCount += static_cast<uint32_t>(geometry.m_meshlets.size());
+                                for (auto const& meshlet : geometry.m_meshlets)
+                                {
+                                    usedVertices += meshlet.VertCount;
+                                    usedPrimitives += meshlet.PrimCount;
+                                }
+                            }
+                            partitionTimes.push_back(static_cast<float>(partitionSeconds));
+                            totalTimes.push_back(static_cast<float>(totalSeconds));
+                        }
+
+                        result.peakMemoryBytes = getPeakMemory();
+                        stats::BenchmarkStatistics const partitionStatistics = stats::computeStatistics(partitionTimes);
+                        stats::BenchmarkStatistics const totalStatistics = stats::computeStatistics(totalTimes);
+                        result.medianSeconds = partitionStatistics.median;
+                        result.p95Seconds = partitionStatistics.p95;
+                        result.medianTotalSeconds = totalStatistics.median;
+                        result.p95TotalSeconds = totalStatistics.p95;
+                        if (result.meshletCount > 0)
+                        {
+                            result.vertexFill = static_cast<float>(usedVertices) / (static_cast<float>(result.meshletCount) * maxVerts);
+                            result.primitiveFill = static_cast<float>(usedPrimitives) / (static_cast<float>(result.meshletCount) * maxPrims);
+                        }
+
+                        printf("%s %i/%i: %f s (p95 %f s), %u meshlets\n", getMeshletizerName(type), maxVerts, maxPrims, result.medianSeconds, result.p95Seconds, result.meshletCount);
+                        results.push_back(result);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool writeCSV(std::string const& path, std::vector<SweepResult> const& results)
+    {
+        std::ofstream file(path);
+        if (!file.is_open())
+        {
+            printf("Could not open file %s\n", path.c_str());
+            return false;
+        }
+
+        file << "model,meshletizer,max_vertices,max_primitives,median_ms,p95_ms,median_total_ms,p95_total_ms,peak_memory_mb,meshlets,vertex_fill,primitive_fill\n";
+        for (auto const& result : results)
+        {
+            file << '"' << result.model << "\","
+                << getMeshletizerName(result.type) << ','
+                << result.maxVerts << ','
+                << result.maxPrims << ','
+                << result.medianSeconds * 1000.0 << ','
+                << result.p95Seconds * 1000.0 << ','
+                << result.medianTotalSeconds * 1000.0 << ','
+                << result.p95TotalSeconds * 1000.0 << ','
+                << result.peakMemoryBytes / (1024.0 * 1024.0) << ','
+                << result.meshletCount << ','
+                << result.vertexFill << ','
+                << result.primitiveFill << '\n';
+        }
+        return true;
+    }
+
+    int runFromCommandLine(int argc, char** argv)
+    {
+        SweepSettings settings;
+        if (!parseArguments(argc, argv, settings))
+            return 1;
+
+        std::vector<SweepResult> results;
+        if (!run(settings, results))
+            return 1;
+        return writeCSV(settings.outputPath, results) ? 0 : 1;
+    }
+}
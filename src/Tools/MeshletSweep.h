@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MeshletStructs.h"
+
+/*
+ * Headless meshletizer benchmark, never touches the device:
+ *   --meshlet-sweep <output.csv> [--repeats N] [--vertices 32,64,...] [--primitives 32,64,...] <model> [<model> ...]
+ * Every model is meshletized with every meshletizer for every vertex/primitive limit pair, N times each,
+ * and one CSV row per configuration is written.
+ */
+namespace sweep
+{
+    static const char* const ARGUMENT = "--meshlet-sweep";
+
+    struct SweepSettings
+    {
+        std::string outputPath;
+        std::vector<std::string> models;
+        std::vector<int32_t> vertexLimits = { 32, 64, 128, 256 };
+        std::vector<int32_t> primitiveLimits = { 32, 64, 128, 256 };
+        uint32_t repeats = 5;
+    };
+
+    struct SweepResult
+    {
+        std::string model;
+        MeshletizerType type;
+        int32_t maxVerts;
+        int32_t maxPrims;
+        double medianSeconds;      // partition step only, summed over the model's meshes
+        double p95Seconds;
+        double medianTotalSeconds; // whole MeshGeometry build, including vertex cache optimization, adjacency and cull data
+        double p95TotalSeconds;
+        uint64_t peakMemoryBytes;
+        uint32_t meshletCount;
+        float vertexFill;          // used vertex slots / (meshlets * maxVerts)
+        float primitiveFill;       // used primitive slots / (meshlets * maxPrims)
+    };
+
+    // Returns false and prints usage when arguments are malformed
+    bool parseArguments(int argc, char** argv, SweepSettings& settings);
+
+    // Some meshletizers can't handle every limit pair, those configurations are skipped
+    bool isSupported(MeshletizerType type, int32_t maxVerts, int32_t maxPrims);
+
+    bool run(SweepSettings const& settings, std::vector<SweepResult>& results);
+
+    bool writeCSV(std::string const& path, std::vector<SweepResult> const& results);
+
+    // Entry point for main(), returns process exit code
+    int runFromCommandLine(int argc, char** argv);
+}
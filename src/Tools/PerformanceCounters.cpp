@@ -0,0 +1,191 @@
+#include "PerformanceCounters.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <imgui.h>
+
+namespace counters
+{
+    namespace
+    {
+        // Threads share shards when there are more of them, still correct, just contended
+        const uint32_t SHARD_COUNT = 16;
+
+        // Own cache line per shard, neighbouring threads don't invalidate each other
+        struct alignas(64) Shard
+        {
+            std::atomic<uint64_t> values[COUNTER_COUNT];
+        };
+
+        Shard g_shards[SHARD_COUNT];
+        std::atomic<uint32_t> g_nextShard = 0;
+        thread_local uint32_t t_shard = g_nextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+
+        // Main thread only
+        Snapshot g_previousFrame;
+        Snapshot g_lastFrameDelta;
+        uint64_t g_frameCount = 0;
+
+        FILE* g_logFile = nullptr;
+        std::string g_logPath;
+        float g_logInterval = 1.0f;
+        Snapshot g_lastLogged;
+        uint64_t g_lastLoggedFrame = 0;
+        std::chrono::steady_clock::time_point g_lastLogTime;
+
+        char g_editorLogPath[256] = "../../cache/logs/counters.jsonl";
+
+        void writeLogLine(Snapshot const& current, double elapsedSeconds)
+        {
+            auto const since = std::chrono::system_clock::now().time_since_epoch();
+            fprintf(g_logFile, "{\"time\":%lld,\"interval\":%.3f,\"frames\":%llu",
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(since).count()),
+                elapsedSeconds,
+                static_cast<unsigned long long>(g_frameCount - g_lastLoggedFrame));
+            for (uint32_t i = 0; i < COUNTER_COUNT; i++)
+            {
+                fprintf(g_logFile, ",\"%s\":%llu", getName(static_cast<Counter>(i)),
+                    static_cast<unsigned long long>(current.values[i] - g_lastLogged.values[i]));
+            }
+            fprintf(g_logFile, "}\n");
+            // A crashed session keeps everything up to the last interval
+            fflush(g_logFile);
+        }
+    }
+
+    void add(Counter counter, uint64_t value)
+    {
+        g_shards[t_shard].values[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t read(Counter counter)
+    {
+        uint64_t sum = 0;
+        for (auto const& shard : g_shards)
+        {
+            sum += shard.values[counter].load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    void snapshot(Snapshot& snapshot)
+    {
+        for (uint32_t i = 0; i < COUNTER_COUNT; i++)
+        {
+            snapshot.values[i] = read(static_cast<Counter>(i));
+        }
+    }
+
+    const char* getName(Counter counter)
+    {
+        switch (counter)
+        {
+        case MESHLETS_DISPATCHED: return "meshlets_dispatched";
+        case AMPLIFICATION_GROUPS: return "amplification_groups";
+        case DISPATCH_CALLS: return "dispatch_calls";
+        case INDIRECT_COMMANDS: return "indirect_commands";
+        case BYTES_UPLOADED: return "bytes_uploaded";
+        case CONSTANT_BYTES_UPLOADED: return "constant_bytes_uploaded";
+        case CONSTANT_BUFFER_ALLOCATIONS: return "constant_buffer_allocations";
+        case MESH_CACHE_HITS: return "mesh_cache_hits";
+        case MESH_CACHE_MISSES: return "mesh_cache_misses";
+        case MESHLETIZER_INVOCATIONS: return "meshletizer_invocations";
+        case MESHLETIZER_NANOSECONDS: return "meshletizer_ns";
+        default: return "unknown";
+        }
+    }
+
+    bool startLog(std::string const& path, float intervalSeconds)
+    {
+        stopLog();
+        std::filesystem::path const directory = std::filesystem::path(path).parent_path();
+        if (!directory.empty())
+            std::filesystem::create_directories(directory);
+
+        g_logFile = fopen(path.c_str(), "a");
+        if (g_logFile == nullptr)
+            return false;
+
+        g_logPath = path;
+        g_logInterval = intervalSeconds > 0.0f ? intervalSeconds : 1.0f;
+        snapshot(g_lastLogged);
+        g_lastLoggedFrame = g_frameCount;
+        g_lastLogTime = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void stopLog()
+    {
+        if (g_logFile == nullptr)
+            return;
+
+        fclose(g_logFile);
+        g_logFile = nullptr;
+        g_logPath.clear();
+    }
+
+    void endFrame()
+    {
+        Snapshot current;
+        snapshot(current);
+        for (uint32_t i = 0; i < COUNTER_COUNT; i++)
+        {
+            g_lastFrameDelta.values[i] = current.values[i] - g_previousFrame.values[i];
+        }
+        g_previousFrame = current;
+        g_frameCount++;
+
+        if (g_logFile == nullptr)
+            return;
+
+        auto const now = std::chrono::steady_clock::now();
+        double const elapsed = std::chrono::duration<double>(now - g_lastLogTime).count();
+        if (elapsed < g_logInterval)
+            return;
+
+        writeLogLine(current, elapsed);
+        g_lastLogged = current;
+        g_lastLoggedFrame = g_frameCount;
+        g_lastLogTime = now;
+    }
+
+    void drawEditor()
+    {
+        ImGui::SeparatorText("Counters");
+        for (uint32_t i = 0; i < COUNTER_COUNT; i++)
+        {
+            auto const counter = static_cast<Counter>(i);
+            if (counter == MESHLETIZER_NANOSECONDS)
+            {
+                ImGui::Text("%s: %.3f s total", getName(counter), g_previousFrame.values[i] / 1e9);
+                continue;
+            }
+            ImGui::Text("%s: %llu last frame, %llu total", getName(counter),
+                static_cast<unsigned long long>(g_lastFrameDelta.values[i]),
+                static_cast<unsigned long long>(g_previousFrame.values[i]));
+        }
+
+        if (g_logFile == nullptr)
+        {
+            ImGui::InputText("Counters log", g_editorLogPath, IM_ARRAYSIZE(g_editorLogPath));
+            if (ImGui::Button("Start counters log"))
+            {
+                startLog(g_editorLogPath);
+            }
+            if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+            {
+                ImGui::SetTooltip("Appends one JSON line per second with the counter increments, also enabled with --counters-log <path>");
+            }
+        }
+        else
+        {
+            ImGui::Text("Logging to %s", g_logPath.c_str());
+            if (ImGui::Button("Stop counters log"))
+            {
+                stopLog();
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/*
+ * Always-on counters, cheap enough to leave in release sessions. Every thread adds to its own shard
+ * with a relaxed atomic, readers sum the shards. Values only grow, per frame numbers are differences
+ * of two snapshots.
+ */
+namespace counters
+{
+    enum Counter : uint32_t
+    {
+        MESHLETS_DISPATCHED,        // meshlets handed to DispatchMesh, before any GPU culling
+        AMPLIFICATION_GROUPS,       // AS thread groups launched, culling path only
+        DISPATCH_CALLS,             // DispatchMesh and ExecuteIndirect calls
+        INDIRECT_COMMANDS,          // commands executed through ExecuteIndirect
+        BYTES_UPLOADED,             // buffers and textures copied to default heaps
+        CONSTANT_BYTES_UPLOADED,    // writes into mapped constant buffers
+        CONSTANT_BUFFER_ALLOCATIONS, // slices handed out by ConstantBufferRing
+        MESH_CACHE_HITS,            // meshes and LOD levels read from the cache
+        MESH_CACHE_MISSES,          // models that had to be meshletized from source
+        MESHLETIZER_INVOCATIONS,
+        MESHLETIZER_NANOSECONDS,    // partition step only
+        COUNTER_COUNT
+    };
+
+    struct Snapshot
+    {
+        uint64_t values[COUNTER_COUNT] = {};
+    };
+
+    void add(Counter counter, uint64_t value = 1);
+    uint64_t read(Counter counter);
+    void snapshot(Snapshot& snapshot);
+
+    const char* getName(Counter counter);
+
+    // Appends one JSON object per interval to path, until stopLog. Returns false if the file can't be opened
+    bool startLog(std::string const& path, float intervalSeconds = 1.0f);
+    void stopLog();
+
+    // Once per frame on the main thread, updates the per frame values and writes the log
+    void endFrame();
+
+    void drawEditor();
+}
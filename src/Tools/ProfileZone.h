@@ -0,0 +1,8 @@
+#pragma once
+
+// PROFILE_ZONE for the CPU modules the headless tools share with the renderer, they link neither Tracy nor the timeline recorder
+#ifdef DX12FRAMEWORK_HEADLESS
+#define PROFILE_ZONE(name)
+#else
+#include "Tools/TimelineRecorder.h"
+#endif
@@ -0,0 +1,159 @@
+#include "ProfilerFrameRing.h"
+
+#include <algorithm>
+
+#include "ITimestampSource.h"
+
+void ProfilerFrameRing::initialize(ITimestampSource* source, uint32_t frameCount, uint32_t maxEntriesPerFrame)
+{
+    m_source = source;
+    m_maxEntries = std::max(maxEntriesPerFrame, 1u);
+    m_slots.clear();
+    m_slots.resize(std::max(frameCount, 1u));
+    for (auto& slot : m_slots)
+    {
+        slot.entries.resize(m_maxEntries);
+    }
+    m_timestamps.resize(m_maxEntries * 2);
+    m_resolved.resize(m_maxEntries);
+    m_resolvedCount = 0;
+    m_resolvedDropped = 0;
+    m_currentSlot = 0;
+    m_frameNumber = 0;
+    m_currentNesting = 0;
+    m_lostFrames = 0;
+}
+
+uint32_t ProfilerFrameRing::internName(std::string const& name)
+{
+    for (uint32_t i = 0; i < m_names.size(); i++)
+    {
+        if (m_names[i] == name)
+            return i;
+    }
+    m_names.push_back(name);
+    return static_cast<uint32_t>(m_names.size() - 1);
+}
+
+void ProfilerFrameRing::beginFrame()
+{
+    m_frameNumber++;
+    m_currentSlot = static_cast<uint32_t>(m_frameNumber % m_slots.size());
+    m_currentNesting = 0;
+
+    FrameSlot& slot = currentSlot();
+    // Nobody collected it for a whole ring, results are overwritten
+    if (slot.pending)
+        m_lostFrames++;
+    slot.pending = false;
+    slot.entryCount = 0;
+    slot.dropped = 0;
+    slot.frameNumber = m_frameNumber;
+}
+
+ProfilerEntry* ProfilerFrameRing::startEntry(uint32_t nameId)
+{
+    FrameSlot& slot = currentSlot();
+    if (slot.entryCount == m_maxEntries)
+    {
+        slot.dropped++;
+        return nullptr;
+    }
+
+    uint32_t const index = slot.entryCount++;
+    ProfilerEntry* entry = &slot.entries[index];
+    entry->nameId = nameId;
+    entry->startIndex = firstQuery(m_currentSlot) + index * 2;
+    entry->endIndex = INVALID_QUERY;
+    entry->nesting = m_currentNesting;
+    m_source->writeTimestamp(entry->startIndex);
+    m_currentNesting++;
+    return entry;
+}
+
+void ProfilerFrameRing::endEntry(ProfilerEntry* entry)
+{
+    if (entry == nullptr || entry->endIndex != INVALID_QUERY)
+        return;
+
+    entry->endIndex = entry->startIndex + 1;
+    m_source->writeTimestamp(entry->endIndex);
+    m_currentNesting--;
+}
+
+void ProfilerFrameRing::endFrame()
+{
+    FrameSlot& slot = currentSlot();
+    // Resolving a query that was never written is invalid, unbalanced entries end with the frame
+    for (uint32_t i = 0; i < slot.entryCount; i++)
+    {
+        endEntry(&slot.entries[i]);
+    }
+    if (slot.entryCount > 0)
+        m_source->resolve(firstQuery(m_currentSlot), slot.entryCount * 2);
+}
+
+void ProfilerFrameRing::frameSubmitted(uint64_t fenceValue)
+{
+    FrameSlot& slot = currentSlot();
+    slot.fenceValue = fenceValue;
+    slot.pending = true;
+}
+
+bool ProfilerFrameRing::collect()
+{
+    FrameSlot* oldest = nullptr;
+    uint32_t oldestIndex = 0;
+    for (uint32_t i = 0; i < m_slots.size(); i++)
+    {
+        FrameSlot& slot = m_slots[i];
+        if (slot.pending && (oldest == nullptr || slot.frameNumber < oldest->frameNumber))
+        {
+            oldest = &slot;
+            oldestIndex = i;
+        }
+    }
+    // Frames finish in order, if the oldest one is still running so are the rest
+    if (oldest == nullptr || !m_source->isComplete(oldest->fenceValue))
+        return false;
+
+    oldest->pending = false;
+    m_resolvedCount = oldest->entryCount;
+    m_resolvedDropped = oldest->dropped;
+    if (m_resolvedCount == 0)
+        return true;
+
+    uint32_t const first = firstQuery(oldestIndex);
+    m_source->readTimestamps(first, m_resolvedCount * 2, m_timestamps.data());
+
+    double const ticksToMs = 1000.0 / static_cast<double>(std::max<uint64_t>(m_source->getFrequency(), 1));
+    for (uint32_t i = 0; i < m_resolvedCount; i++)
+    {
+        ProfilerEntry const& entry = oldest->entries[i];
+        uint64_t const start = m_timestamps[entry.startIndex - first];
+        uint64_t const end = m_timestamps[entry.endIndex - first];
+        ResolvedProfilerEntry& resolved = m_resolved[i];
+        resolved.nameId = entry.nameId;
+        resolved.name = getName(entry.nameId);
+        resolved.time = end > start ? static_cast<float>((end - start) * ticksToMs) : 0.0f;
+        resolved.nesting = entry.nesting;
+        resolved.startTicks = start;
+        resolved.endTicks = end;
+    }
+    return true;
+}
+
+bool ProfilerFrameRing::sumResolved(std::vector<uint32_t> const& nameIds, float& time) const
+{
+    time = 0.0f;
+    bool found = false;
+    for (uint32_t i = 0; i < m_resolvedCount; i++)
+    {
+        if (std::find(nameIds.begin(), nameIds.end(), m_resolved[i].nameId) != nameIds.end())
+        {
+            time += m_resolved[i].time;
+            found = true;
+        }
+    }
+    return found;
+}
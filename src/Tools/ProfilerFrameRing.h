@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+class ITimestampSource;
+
+struct ProfilerEntry
+{
+    uint32_t nameId;
+    uint32_t startIndex;
+    uint32_t endIndex;
+    uint32_t nesting;
+};
+
+struct ResolvedProfilerEntry
+{
+    uint32_t nameId;
+    const char* name;
+    float time; // ms
+    uint32_t nesting;
+    uint64_t startTicks; // raw timestamps, for placing the entry on a timeline
+    uint64_t endTicks;
+};
+
+/*
+ * CPU side of the GPU profiler, no D3D12 dependencies.
+ * Every frame gets its own slot with fixed entry storage and its own range of queries, slots are reused
+ * round robin, so recording and reading back never allocate and never wait for the GPU.
+ * Results come back in submission order, a few frames late.
+ */
+class ProfilerFrameRing
+{
+public:
+    static constexpr uint32_t INVALID_QUERY = UINT32_MAX;
+
+    // Allocates everything up front, frameCount should cover the frames the GPU can be behind
+    void initialize(ITimestampSource* source, uint32_t frameCount, uint32_t maxEntriesPerFrame);
+
+    // Allocates the first time a name is seen only, callers are expected to cache the id
+    uint32_t internName(std::string const& name);
+    const char* getName(uint32_t nameId) const { return m_names[nameId].c_str(); }
+
+    void beginFrame();
+    // Returns nullptr when the frame is out of entries, endEntry ignores it
+    ProfilerEntry* startEntry(uint32_t nameId);
+    void endEntry(ProfilerEntry* entry);
+    // Closes entries left open and resolves the frame's queries
+    void endFrame();
+    // Fence value the frame's command list was signalled with, the frame can be read once it completes
+    void frameSubmitted(uint64_t fenceValue);
+
+    // Resolves the oldest finished frame, returns false when no frame finished since the last call
+    bool collect();
+
+    uint32_t numResolved() const { return m_resolvedCount; }
+    ResolvedProfilerEntry const& getResolved(uint32_t index) const { return m_resolved[index]; }
+    // Total time of the collected frame's entries named any of nameIds, false when the frame has none of them
+    bool sumResolved(std::vector<uint32_t> const& nameIds, float& time) const;
+    // Entries that did not fit into the collected frame
+    uint32_t droppedEntries() const { return m_resolvedDropped; }
+    // Frames whose slot was reused before they could be collected
+    uint64_t lostFrames() const { return m_lostFrames; }
+
+    uint32_t frameCount() const { return static_cast<uint32_t>(m_slots.size()); }
+    uint32_t maxEntriesPerFrame() const { return m_maxEntries; }
+
+private:
+    struct FrameSlot
+    {
+        std::vector<ProfilerEntry> entries;
+        uint32_t entryCount = 0;
+        uint32_t dropped = 0;
+        uint64_t frameNumber = 0;
+        uint64_t fenceValue = 0;
+        bool pending = false; // submitted, not collected yet
+    };
+
+    FrameSlot& currentSlot() { return m_slots[m_currentSlot]; }
+    uint32_t firstQuery(uint32_t slot) const { return slot * m_maxEntries * 2; }
+
+    ITimestampSource* m_source = nullptr;
+    uint32_t m_maxEntries = 0;
+    std::vector<FrameSlot> m_slots;
+    uint32_t m_currentSlot = 0;
+    uint64_t m_frameNumber = 0;
+    uint32_t m_currentNesting = 0;
+    uint64_t m_lostFrames = 0;
+
+    // deque keeps the strings in place, resolved entries point into it
+    std::deque<std::string> m_names;
+
+    std::vector<uint64_t> m_timestamps;
+    std::vector<ResolvedProfilerEntry> m_resolved;
+    uint32_t m_resolvedCount = 0;
+    uint32_t m_resolvedDropped = 0;
+};
@@ -0,0 +1,121 @@
+#include "RecordingSchedule.h"
+
+#include <algorithm>
+
+namespace recording
+{
+    void partitionByCost(std::vector<uint64_t> const& costs, uint32_t maxChunks, uint64_t minChunkCost, std::vector<RecordingChunk>& chunks)
+    {
+        chunks.clear();
+        if (costs.empty())
+            return;
+
+        // Every item takes some recording, even when its cost estimate says otherwise
+        uint64_t total = 0;
+        for (uint64_t const cost : costs)
+        {
+            total += std::max<uint64_t>(cost, 1);
+        }
+
+        uint64_t chunkCount = std::min<uint64_t>(std::max(maxChunks, 1u), costs.size());
+        if (minChunkCost > 0)
+            chunkCount = std::clamp<uint64_t>(total / minChunkCost, 1, chunkCount);
+
+        // A chunk closes once it holds its share of what the open chunks still have to take, an item bigger than
+        // a share closes its own chunk and the rest is split again, so there may be fewer chunks but never empty ones
+        RecordingChunk chunk;
+        uint64_t remainingCost = total;
+        for (uint32_t i = 0; i < costs.size(); i++)
+        {
+            chunk.count++;
+            chunk.cost += std::max<uint64_t>(costs[i], 1);
+
+            uint64_t const openChunks = chunkCount - chunks.size();
+            if (openChunks > 1 && chunk.cost * openChunks >= remainingCost)
+            {
+                remainingCost -= chunk.cost;
+                chunks.push_back(chunk);
+                chunk = RecordingChunk();
+                chunk.first = i + 1;
+            }
+        }
+
+        if (chunk.count > 0)
+            chunks.push_back(chunk);
+    }
+
+    void WorkerPool::start(uint32_t threadCount)
+    {
+        stop();
+
+        m_stopping = false;
+        m_threads.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; i++)
+        {
+            m_threads.emplace_back(&WorkerPool::workerLoop, this);
+        }
+    }
+
+    void WorkerPool::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+    void WorkerPool::run(uint32_t taskCount, std::function<void(uint32_t)> const& task)
+    {
+        if (m_threads.empty())
+        {
+            for (uint32_t i = 0; i < taskCount; i++)
+            {
+                task(i);
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_taskCount = taskCount;
+        m_nextTask = 0;
+        m_finishedTasks = 0;
+        m_generation++;
+        m_wake.notify_all();
+
+        m_done.wait(lock, [this] { return m_finishedTasks == m_taskCount; });
+        m_task = nullptr;
+    }
+
+    void WorkerPool::workerLoop()
+    {
+        uint64_t seenGeneration = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping)
+                return;
+
+            seenGeneration = m_generation;
+            // A worker that wakes after run() returned finds no tasks left
+            while (m_nextTask < m_taskCount)
+            {
+                uint32_t const index = m_nextTask++;
+                lock.unlock();
+                (*m_task)(index);
+                lock.lock();
+
+                if (++m_finishedTasks == m_taskCount)
+                    m_done.notify_one();
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// No engine dependencies, so scheduling can be checked outside of the renderer
+namespace recording
+{
+    // Contiguous run of items recorded into one command list
+    struct RecordingChunk
+    {
+        uint32_t first = 0;
+        uint32_t count = 0;
+        uint64_t cost = 0;
+    };
+
+    /*
+     * Splits items into at most maxChunks contiguous chunks of similar total cost. Chunks keep item order, so submitting
+     * their command lists in chunk order gives the GPU the same work as recording everything into one list.
+     * Only the costs decide the split, never timing or which thread runs a chunk.
+     * Fewer chunks are made when each would cost less than minChunkCost, an extra command list isn't free either.
+     */
+    void partitionByCost(std::vector<uint64_t> const& costs, uint32_t maxChunks, uint64_t minChunkCost, std::vector<RecordingChunk>& chunks);
+
+    /*
+     * Fixed set of threads, run() blocks the caller until every task finished.
+     * Tasks go to whichever worker is free, anything that has to be deterministic must depend on the task index only.
+     */
+    class WorkerPool
+    {
+    public:
+        WorkerPool() = default;
+        ~WorkerPool() { stop(); }
+
+        // Joins the current threads first, with 0 threads run() executes tasks on the calling thread
+        void start(uint32_t threadCount);
+        void stop();
+        uint32_t threadCount() const { return static_cast<uint32_t>(m_threads.size()); }
+
+        void run(uint32_t taskCount, std::function<void(uint32_t)> const& task);
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> m_threads;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        std::function<void(uint32_t)> const* m_task = nullptr;
+        uint32_t m_taskCount = 0;
+        uint32_t m_nextTask = 0;
+        uint32_t m_finishedTasks = 0;
+        // Bumped by every run(), workers compare it to know there is new work
+        uint64_t m_generation = 0;
+        bool m_stopping = false;
+    };
+}
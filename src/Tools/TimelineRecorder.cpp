@@ -0,0 +1,264 @@
+#include "TimelineRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <imgui.h>
+
+TimelineRecorder* TimelineRecorder::m_instance;
+std::atomic<bool> TimelineRecorder::s_capturing = false;
+thread_local TimelineRecorder::ThreadBufferOwner TimelineRecorder::s_threadBuffer;
+
+namespace
+{
+    // Chrome trace timestamps are microseconds
+    void writeEvent(std::ofstream& file, bool& first, const char* name, uint32_t tid, int64_t startNs, int64_t endNs, int64_t originNs)
+    {
+        char buffer[512];
+        snprintf(buffer, sizeof(buffer), "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            first ? "" : ",", name, tid, (startNs - originNs) / 1000.0, (endNs - startNs) / 1000.0);
+        file << buffer;
+        first = false;
+    }
+
+    void writeThreadName(std::ofstream& file, bool& first, uint32_t tid, const char* name)
+    {
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",", tid, name);
+        file << buffer;
+        first = false;
+    }
+}
+
+void TimelineRecorder::create()
+{
+    m_instance = new TimelineRecorder();
+    m_instance->m_gpuEvents.reserve(MAX_GPU_EVENTS);
+    // Main thread gets the first buffer
+    m_instance->getThreadBuffer();
+}
+
+TimelineRecorder* TimelineRecorder::getInstance()
+{
+    return m_instance;
+}
+
+int64_t TimelineRecorder::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TimelineRecorder::ThreadBufferOwner::~ThreadBufferOwner()
+{
+    if (buffer == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_instance->m_registrationMutex);
+    buffer->retired = true;
+}
+
+TimelineRecorder::ThreadBuffer* TimelineRecorder::getThreadBuffer()
+{
+    if (s_threadBuffer.buffer != nullptr)
+        return s_threadBuffer.buffer;
+
+    std::lock_guard<std::mutex> lock(m_registrationMutex);
+    // Short lived threads would otherwise add a buffer each, events of exited threads are kept until the next capture
+    for (auto& buffer : m_threadBuffers)
+    {
+        if (buffer->retired && buffer->count.load(std::memory_order_relaxed) == 0)
+        {
+            buffer->retired = false;
+            s_threadBuffer.buffer = buffer.get();
+            return s_threadBuffer.buffer;
+        }
+    }
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->events.resize(EVENTS_PER_THREAD);
+    buffer->threadIndex = static_cast<uint32_t>(m_threadBuffers.size());
+    s_threadBuffer.buffer = buffer.get();
+    m_threadBuffers.push_back(std::move(buffer));
+    return s_threadBuffer.buffer;
+}
+
+void TimelineRecorder::startCapture(uint32_t frameCount)
+{
+    if (isCapturing() || m_gpuDrainFramesLeft > 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_registrationMutex);
+        for (auto& buffer : m_threadBuffers)
+        {
+            buffer->count.store(0, std::memory_order_relaxed);
+            buffer->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_gpuEvents.clear();
+    m_droppedGpuEvents = 0;
+    m_frameStarts.clear();
+    m_frameStarts.reserve(frameCount + 1);
+
+    m_framesLeft = std::max(frameCount, 1u);
+    m_captureStartNs = now();
+    m_frameStarts.push_back(m_captureStartNs);
+    s_capturing.store(true, std::memory_order_release);
+}
+
+void TimelineRecorder::endFrame()
+{
+    if (isCapturing())
+    {
+        int64_t const frameEnd = now();
+        m_framesLeft--;
+        if (m_framesLeft == 0)
+        {
+            s_capturing.store(false, std::memory_order_release);
+            m_captureEndNs = frameEnd;
+            m_gpuDrainFramesLeft = GPU_DRAIN_FRAMES;
+        }
+        else
+        {
+            m_frameStarts.push_back(frameEnd);
+        }
+        return;
+    }
+
+    if (m_gpuDrainFramesLeft > 0)
+    {
+        m_gpuDrainFramesLeft--;
+        if (m_gpuDrainFramesLeft == 0)
+            finishCapture();
+    }
+}
+
+void TimelineRecorder::recordZone(const char* name, int64_t startNs, int64_t endNs)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+    uint32_t const index = buffer->count.load(std::memory_order_relaxed);
+    if (index == buffer->events.size())
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = { name, startNs, endNs };
+    // Publishes the event to the thread writing the trace
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+void TimelineRecorder::recordGpuZone(const char* name, int64_t startNs, int64_t endNs)
+{
+    if (startNs < m_captureStartNs || (!isCapturing() && startNs > m_captureEndNs))
+        return;
+
+    if (m_gpuEvents.size() == MAX_GPU_EVENTS)
+    {
+        m_droppedGpuEvents++;
+        return;
+    }
+    m_gpuEvents.push_back({ name, startNs, endNs });
+}
+
+void TimelineRecorder::finishCapture()
+{
+    std::filesystem::create_directories(m_path);
+    char filename[64];
+    snprintf(filename, sizeof(filename), "timeline_%lld.json", static_cast<long long>(std::time(nullptr)));
+    m_lastTracePath = m_path + filename;
+    if (!writeChromeTrace(m_lastTracePath))
+        m_lastTracePath = "";
+}
+
+bool TimelineRecorder::writeChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+        return false;
+
+    bool first = true;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    // GPU gets tid 0 so it sorts above the CPU threads
+    writeThreadName(file, first, 0, "GPU direct queue");
+    for (auto const& event : m_gpuEvents)
+    {
+        writeEvent(file, first, event.name, 0, event.startNs, event.endNs, m_captureStartNs);
+    }
+
+    for (uint32_t i = 0; i < m_frameStarts.size(); i++)
+    {
+        int64_t const end = i + 1 < m_frameStarts.size() ? m_frameStarts[i + 1] : m_captureEndNs;
+        char name[32];
+        snprintf(name, sizeof(name), "Frame %u", i);
+        // Frame ranges on a track of their own, zones of the main thread line up under them
+        writeEvent(file, first, name, 1, m_frameStarts[i], end, m_captureStartNs);
+    }
+    writeThreadName(file, first, 1, "Frames");
+
+    std::lock_guard<std::mutex> lock(m_registrationMutex);
+    for (auto const& buffer : m_threadBuffers)
+    {
+        uint32_t const tid = buffer->threadIndex + 2;
+        char threadName[32];
+        if (buffer->threadIndex == 0)
+            snprintf(threadName, sizeof(threadName), "Main thread");
+        else
+            snprintf(threadName, sizeof(threadName), "Thread %u", buffer->threadIndex);
+        writeThreadName(file, first, tid, threadName);
+
+        uint32_t const count = buffer->count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto const& event = buffer->events[i];
+            writeEvent(file, first, event.name, tid, event.startNs, event.endNs, m_captureStartNs);
+        }
+    }
+
+    file << "\n]}\n";
+    file.close();
+    return !file.fail();
+}
+
+void TimelineRecorder::drawEditor()
+{
+    ImGui::SeparatorText("Timeline capture");
+    ImGui::InputInt("Frames to capture", &m_captureFrames);
+    m_captureFrames = std::max(m_captureFrames, 1);
+
+    bool const busy = isCapturing() || m_gpuDrainFramesLeft > 0;
+    ImGui::BeginDisabled(busy);
+    if (ImGui::Button("Capture timeline"))
+    {
+        startCapture(static_cast<uint32_t>(m_captureFrames));
+    }
+    ImGui::EndDisabled();
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+    {
+        ImGui::SetTooltip("Writes CPU zones and GPU profiler ranges as Chrome trace JSON, open in chrome://tracing or ui.perfetto.dev");
+    }
+
+    if (busy)
+    {
+        ImGui::Text("Capturing, %u frames left", m_framesLeft + m_gpuDrainFramesLeft);
+    }
+    else if (!m_lastTracePath.empty())
+    {
+        ImGui::Text("Last trace: %s", m_lastTracePath.c_str());
+    }
+
+    uint32_t dropped = m_droppedGpuEvents;
+    std::lock_guard<std::mutex> lock(m_registrationMutex);
+    for (auto const& buffer : m_threadBuffers)
+    {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    if (dropped > 0)
+    {
+        ImGui::Text("%u events did not fit into the buffers", dropped);
+    }
+}
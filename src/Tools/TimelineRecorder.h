@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tracy/Tracy.hpp"
+
+/*
+ * Records CPU zones of every thread and GPU ranges from GPUProfiler on one clock, and writes
+ * the captured frames as Chrome trace JSON (chrome://tracing, Perfetto).
+ * Recording is off until a capture is started, zones then cost a clock read and an append to
+ * the calling thread's own buffer, no locks. Names must be string literals or otherwise outlive the capture.
+ */
+class TimelineRecorder
+{
+public:
+    static constexpr uint32_t EVENTS_PER_THREAD = 1 << 16;
+    static constexpr uint32_t MAX_GPU_EVENTS = 1 << 16;
+    // Frames the GPU results trail the CPU, GPU ranges are still accepted for this long after the capture ends
+    static constexpr uint32_t GPU_DRAIN_FRAMES = 8;
+
+    static void create();
+    static TimelineRecorder* getInstance();
+
+    // Nanoseconds on the clock all events are recorded on
+    static int64_t now();
+    static bool isCapturing() { return s_capturing.load(std::memory_order_relaxed); }
+
+    void startCapture(uint32_t frameCount);
+    // Called once per frame on the main thread, ends the capture and writes the trace when it's done
+    void endFrame();
+
+    void recordZone(const char* name, int64_t startNs, int64_t endNs);
+    // Already converted to the CPU clock
+    void recordGpuZone(const char* name, int64_t startNs, int64_t endNs);
+    bool acceptsGpuZones() const { return isCapturing() || m_gpuDrainFramesLeft > 0; }
+
+    bool writeChromeTrace(const std::string& path) const;
+
+    void drawEditor();
+
+private:
+    struct Event
+    {
+        const char* name;
+        int64_t startNs;
+        int64_t endNs;
+    };
+
+    // Written by its own thread only, read after count is published
+    struct ThreadBuffer
+    {
+        std::vector<Event> events;
+        std::atomic<uint32_t> count = 0;
+        std::atomic<uint32_t> dropped = 0;
+        uint32_t threadIndex = 0;
+        bool retired = false; // owning thread exited, can be handed to a new thread once its events are not needed
+    };
+
+    // Retires the thread's buffer on thread exit
+    struct ThreadBufferOwner
+    {
+        ThreadBuffer* buffer = nullptr;
+        ~ThreadBufferOwner();
+    };
+
+    ThreadBuffer* getThreadBuffer();
+    void finishCapture();
+
+    static TimelineRecorder* m_instance;
+    static std::atomic<bool> s_capturing;
+    static thread_local ThreadBufferOwner s_threadBuffer;
+
+    mutable std::mutex m_registrationMutex; // taken once per thread, on its first zone, and when reading the buffer list
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+
+    std::vector<Event> m_gpuEvents;
+    uint32_t m_droppedGpuEvents = 0;
+    std::vector<int64_t> m_frameStarts;
+
+    int32_t m_captureFrames = 60;
+    uint32_t m_framesLeft = 0;
+    uint32_t m_gpuDrainFramesLeft = 0;
+    int64_t m_captureStartNs = 0;
+    int64_t m_captureEndNs = 0;
+
+    std::string m_lastTracePath;
+    const std::string m_path = "../../cache/traces/";
+};
+
+class TimelineZone
+{
+public:
+    explicit TimelineZone(const char* name) : m_name(name), m_startNs(TimelineRecorder::isCapturing() ? TimelineRecorder::now() : -1) {}
+    ~TimelineZone()
+    {
+        if (m_startNs >= 0)
+            TimelineRecorder::getInstance()->recordZone(m_name, m_startNs, TimelineRecorder::now());
+    }
+
+    TimelineZone(const TimelineZone&) = delete;
+    TimelineZone& operator=(const TimelineZone&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_startNs;
+};
+
+#define TIMELINE_CONCAT_IMPL(a, b) a##b
+#define TIMELINE_CONCAT(a, b) TIMELINE_CONCAT_IMPL(a, b)
+#define TIMELINE_ZONE(name) TimelineZone TIMELINE_CONCAT(timelineZone, __LINE__)(name)
+// Tracy zone and timeline zone in one
+#define PROFILE_ZONE(name) ZoneScopedN(name); TIMELINE_ZONE(name)
@@ -74,7 +74,7 @@ void DebugDrawer::eraseDebugDrawing(DebugDrawing* drawing)
 void DebugDrawer::draw()
 {
 
-    auto cmd_list = Renderer::get_instance()->g_pd3dCommandList;
+    auto cmd_list = Renderer::get_instance()->get_command_list();
     cmd_list->SetPipelineState(m_pipelineState->PSO());
     cmd_list->SetGraphicsRootSignature(m_pipelineState->dx12RootSignature());
     cmd_list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -25,11 +25,26 @@ extern "C"
 }
 #endif
 
+#include <cstring>
+
 #include "Engine.h"
+#include "Tools/MeshletSweep.h"
+#include "Tools/PerformanceCounters.h"
 
 // Main code
-int main(int, char**)
+int main(int argc, char** argv)
 {
+    // Headless, meshletizes models on the CPU and exits without creating a window or device
+    if (argc > 1 && std::strcmp(argv[1], sweep::ARGUMENT) == 0)
+        return sweep::runFromCommandLine(argc, argv);
+
+    // --counters-log <path> appends counter increments as JSON lines, once per second
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--counters-log") == 0)
+            counters::startLog(argv[i + 1]);
+    }
+
     Engine::setup();
     Engine::run();
     Engine::cleanup();
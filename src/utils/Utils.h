@@ -2,6 +2,7 @@
 #include <sstream>
 #include <Windows.h>
 #include "Types.h"
+#include "Hash.h"
 
 namespace olej_utils
 {
@@ -59,49 +60,6 @@ namespace olej_utils
         return result;
     }
 
-    inline u32 murmurHash(u8 const* key, size_t const len, u32 const seed)
-    {
-        u32 h = seed;
-        if (len > 3)
-        {
-            u32 const* key_x4 = reinterpret_cast<u32 const*>(key);
-            size_t i = len >> 2;
-            do
-            {
-                u32 k = *key_x4++;
-                k *= 0xcc9e2d51;
-                k = (k << 15) | (k >> 17);
-                k *= 0x1b873593;
-                h ^= k;
-                h = (h << 13) | (h >> 19);
-                h = h * 5 + 0xe6546b64;
-            } while (--i);
-            key = reinterpret_cast<u8 const*>(key_x4);
-        }
-        if (len & 3)
-        {
-            size_t i = len & 3;
-            u32 k = 0;
-            key = &key[i - 1];
-            do
-            {
-                k <<= 8;
-                k |= *key--;
-            } while (--i);
-            k *= 0xcc9e2d51;
-            k = (k << 15) | (k >> 17);
-            k *= 0x1b873593;
-            h ^= k;
-        }
-        h ^= len;
-        h ^= h >> 16;
-        h *= 0x85ebca6b;
-        h ^= h >> 13;
-        h *= 0xc2b2ae35;
-        h ^= h >> 16;
-        return h;
-    }
-
     inline LPCWSTR const stringToLPCWSTR(std::string const& s)
     {
         std::wstring wsTmp(s.begin(), s.end());
@@ -116,13 +74,4 @@ namespace olej_utils
         return wsTmp;
     }
 
-    inline uint32_t packTriangle(uint8_t x, uint8_t y, uint8_t z)
-    {
-        uint32_t packed_triangle =
-            (static_cast<uint32_t>(x) << 0)
-            | (static_cast<uint32_t>(y) << 8)
-            | (static_cast<uint32_t>(z) << 16);
-        return packed_triangle;
-    }
-
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cfloat>
+#include <climits>
+#include <cstdint>
 #include <cstring>
 #include <vector>
 
@@ -569,4 +571,10 @@ namespace hlsl
         return (numerator + denominator - 1) / denominator;
     }
 
+    // Largest axis scale of a transform, used to grow bounding spheres
+    inline float maxScale(const float4x4& matrix)
+    {
+        return std::max(length(matrix[0].xyz), std::max(length(matrix[1].xyz), length(matrix[2].xyz)));
+    }
+
 } // namespace hlsl
@@ -0,0 +1,150 @@
+#include <cmath>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Tools/BenchmarkStatistics.h"
+
+namespace
+{
+    void testSampleRingOverwrite()
+    {
+        stats::SampleRing ring;
+        ring.reset(3);
+        CHECK(ring.capacity() == 3);
+        CHECK(ring.size() == 0);
+
+        ring.push(1.0f);
+        ring.push(2.0f);
+        CHECK(ring.size() == 2);
+        CHECK(ring.at(0) == 1.0f);
+        CHECK(ring.at(1) == 2.0f);
+
+        // Full, the oldest samples go first
+        ring.push(3.0f);
+        ring.push(4.0f);
+        ring.push(5.0f);
+        CHECK(ring.size() == 3);
+        std::vector<float> samples;
+        ring.copySamples(samples);
+        CHECK((samples == std::vector<float>{ 3.0f, 4.0f, 5.0f }));
+
+        // Wraps more than once
+        for (int i = 6; i <= 10; i++)
+        {
+            ring.push(static_cast<float>(i));
+        }
+        ring.copySamples(samples);
+        CHECK((samples == std::vector<float>{ 8.0f, 9.0f, 10.0f }));
+
+        ring.reset(2);
+        CHECK(ring.size() == 0);
+        ring.copySamples(samples);
+        CHECK(samples.empty());
+
+        // Pushing before reset and a zero capacity both get a single slot
+        stats::SampleRing unset;
+        unset.push(1.0f);
+        unset.push(2.0f);
+        CHECK(unset.capacity() == 1);
+        CHECK(unset.size() == 1);
+        CHECK(unset.at(0) == 2.0f);
+
+        unset.reset(0);
+        CHECK(unset.capacity() == 1);
+    }
+
+    void testPercentileEdges()
+    {
+        CHECK(stats::percentile({}, 0.5f) == 0.0f);
+
+        const std::vector<float> single = { 7.0f };
+        CHECK(stats::percentile(single, 0.0f) == 7.0f);
+        CHECK(stats::percentile(single, 0.5f) == 7.0f);
+        CHECK(stats::percentile(single, 1.0f) == 7.0f);
+
+        // Nearest rank is ceil(fraction * count), clamped to the first and last sample
+        const std::vector<float> sorted = { 1.0f, 2.0f, 3.0f, 4.0f };
+        CHECK(stats::percentile(sorted, 0.0f) == 1.0f);
+        CHECK(stats::percentile(sorted, 0.25f) == 1.0f);
+        CHECK(stats::percentile(sorted, 0.3f) == 2.0f);
+        CHECK(stats::percentile(sorted, 0.5f) == 2.0f);
+        CHECK(stats::percentile(sorted, 0.75f) == 3.0f);
+        CHECK(stats::percentile(sorted, 0.95f) == 4.0f);
+        CHECK(stats::percentile(sorted, 1.0f) == 4.0f);
+    }
+
+    void testWelford()
+    {
+        stats::BenchmarkStatistics const empty = stats::computeStatistics({});
+        CHECK(empty.count == 0);
+        CHECK(empty.mean == 0.0f);
+
+        stats::BenchmarkStatistics const single = stats::computeStatistics({ 3.5f });
+        CHECK(single.count == 1);
+        CHECK(single.min == 3.5f && single.max == 3.5f);
+        CHECK(single.mean == 3.5f && single.median == 3.5f && single.p99 == 3.5f);
+        CHECK(single.stddev == 0.0f);
+
+        // Mean 5, squared deviations sum to 32, sample stddev is sqrt(32 / 7)
+        stats::BenchmarkStatistics const known = stats::computeStatistics({ 9.0f, 2.0f, 5.0f, 4.0f, 4.0f, 7.0f, 4.0f, 5.0f });
+        CHECK(known.count == 8);
+        CHECK(known.min == 2.0f);
+        CHECK(known.max == 9.0f);
+        CHECK_NEAR(known.mean, 5.0f, 1e-6f);
+        CHECK_NEAR(known.stddev, std::sqrt(32.0f / 7.0f), 1e-5f);
+        CHECK(known.median == 4.0f);
+
+        // Large offset with a small spread, a float sum of squares would cancel it out
+        std::vector<float> offset;
+        for (int i = 0; i < 10000; i++)
+        {
+            offset.push_back(10000.0f + static_cast<float>(i % 3));
+        }
+        stats::BenchmarkStatistics const shifted = stats::computeStatistics(offset);
+        CHECK_NEAR(shifted.mean, 10001.0f, 1e-2f);
+        CHECK_NEAR(shifted.stddev, std::sqrt(2.0f / 3.0f), 1e-3f);
+
+        // Constant stream
+        stats::BenchmarkStatistics const constant = stats::computeStatistics(std::vector<float>(1000, 16.6f));
+        CHECK_NEAR(constant.mean, 16.6f, 1e-4f);
+        CHECK(constant.stddev < 1e-4f);
+        CHECK(constant.min == constant.max);
+    }
+
+    void testOutliers()
+    {
+        // One hitch in a hundred frames moves the mean and max, not the percentiles
+        std::vector<float> oneHitch(99, 10.0f);
+        oneHitch.insert(oneHitch.begin() + 40, 1000.0f);
+        stats::BenchmarkStatistics const hitch = stats::computeStatistics(oneHitch);
+        CHECK(hitch.count == 100);
+        CHECK(hitch.median == 10.0f);
+        CHECK(hitch.p95 == 10.0f);
+        CHECK(hitch.p99 == 10.0f);
+        CHECK(hitch.max == 1000.0f);
+        CHECK_NEAR(hitch.mean, 19.9f, 1e-4f);
+
+        // Two of them reach p99
+        std::vector<float> twoHitches = oneHitch;
+        twoHitches[0] = 1000.0f;
+        stats::BenchmarkStatistics const hitches = stats::computeStatistics(twoHitches);
+        CHECK(hitches.p95 == 10.0f);
+        CHECK(hitches.p99 == 1000.0f);
+
+        // Outliers at the low end
+        std::vector<float> fast(100, 10.0f);
+        fast[5] = 0.1f;
+        stats::BenchmarkStatistics const low = stats::computeStatistics(fast);
+        CHECK(low.min == 0.1f);
+        CHECK(low.median == 10.0f);
+    }
+}
+
+int main()
+{
+    testSampleRingOverwrite();
+    testPercentileEdges();
+    testWelford();
+    testOutliers();
+    return testing::result();
+}
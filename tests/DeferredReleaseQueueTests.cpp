@@ -0,0 +1,240 @@
+#include <cstdint>
+#include <vector>
+
+#include "TestCheck.h"
+#include "ResourceLoaders/DeferredReleaseQueue.h"
+
+namespace
+{
+    // Releases append their id, so the tests can see what ran and in which order
+    struct Released
+    {
+        std::vector<uint32_t> ids;
+    };
+
+    struct Object
+    {
+        Released* released;
+        uint32_t id;
+    };
+
+    void recordRelease(void* pointer)
+    {
+        auto object = static_cast<Object*>(pointer);
+        object->released->ids.push_back(object->id);
+    }
+
+    release::Release recorded(Object& object)
+    {
+        return { recordRelease, &object };
+    }
+
+    void testFenceOrder()
+    {
+        Released released;
+        std::vector<Object> objects;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            objects.push_back({ &released, i });
+        }
+
+        release::DeferredReleaseQueue queue;
+        CHECK(queue.empty());
+        CHECK(queue.oldestFenceValue() == 0);
+
+        // In order, then older fences going through the upper_bound path, equal fences keep push order
+        queue.push(2, recorded(objects[0]));
+        queue.push(4, recorded(objects[1]));
+        queue.push(4, recorded(objects[2]));
+        queue.push(1, recorded(objects[3]));
+        queue.push(4, recorded(objects[4]));
+        queue.push(2, recorded(objects[5]));
+        queue.push(3, recorded(objects[6]));
+        queue.push(1, recorded(objects[7]));
+        CHECK(queue.size() == 8);
+        CHECK(queue.oldestFenceValue() == 1);
+
+        // Nothing complete yet
+        CHECK(queue.drain(0, INT64_MAX) == 0);
+        CHECK(released.ids.empty());
+
+        CHECK(queue.drain(2, INT64_MAX) == 4);
+        CHECK((released.ids == std::vector<uint32_t>{ 3, 7, 0, 5 }));
+        CHECK(queue.oldestFenceValue() == 3);
+
+        CHECK(queue.drain(10, INT64_MAX) == 4);
+        CHECK((released.ids == std::vector<uint32_t>{ 3, 7, 0, 5, 6, 1, 2, 4 }));
+        CHECK(queue.empty());
+    }
+
+    // Fake clock, every release takes releaseCost nanoseconds
+    int64_t fakeTime = 0;
+    int64_t releaseCost = 0;
+
+    int64_t fakeNow()
+    {
+        return fakeTime;
+    }
+
+    void timedRelease(void* pointer)
+    {
+        fakeTime += releaseCost;
+        recordRelease(pointer);
+    }
+
+    void testBudget()
+    {
+        Released released;
+        std::vector<Object> objects;
+        for (uint32_t i = 0; i < 10; i++)
+        {
+            objects.push_back({ &released, i });
+        }
+
+        release::DeferredReleaseQueue queue;
+        for (auto& object : objects)
+        {
+            queue.push(1, { timedRelease, &object });
+        }
+
+        // Budget is checked before each release, 10 ns per release spends 25 ns after the third one
+        releaseCost = 10;
+        CHECK(queue.drain(1, 25, fakeNow) == 3);
+        CHECK(queue.size() == 7);
+
+        // Spent budget or a release slower than the whole budget still runs one per call
+        CHECK(queue.drain(1, 0, fakeNow) == 1);
+        releaseCost = 1000;
+        CHECK(queue.drain(1, 25, fakeNow) == 1);
+        CHECK(queue.size() == 5);
+
+        // Budget left over doesn't run releases of unfinished frames
+        Object late = { &released, 10 };
+        queue.push(2, { timedRelease, &late });
+        releaseCost = 0;
+        CHECK(queue.drain(1, 25, fakeNow) == 5);
+        CHECK(queue.size() == 1);
+        CHECK(queue.oldestFenceValue() == 2);
+
+        // Not even one when none is ready
+        CHECK(queue.drain(1, 25, fakeNow) == 0);
+        CHECK(queue.drain(2, 25, fakeNow) == 1);
+        CHECK(released.ids.size() == 11);
+        for (uint32_t i = 0; i < released.ids.size(); i++)
+        {
+            CHECK(released.ids[i] == i);
+        }
+    }
+
+    // Pushes its children into the queue when released, like an object owning other GPU objects
+    struct Owner
+    {
+        release::DeferredReleaseQueue* queue;
+        Released* released;
+        uint32_t id;
+        std::vector<Owner> children;
+    };
+
+    void releaseOwner(void* pointer)
+    {
+        auto owner = static_cast<Owner*>(pointer);
+        owner->released->ids.push_back(owner->id);
+        for (auto& child : owner->children)
+        {
+            owner->queue->push(0, { releaseOwner, &child });
+        }
+    }
+
+    void testPushDuringDrainAll()
+    {
+        Released released;
+        release::DeferredReleaseQueue queue;
+
+        // Two levels below the root, pushed with a fence older than anything left in the queue
+        Owner root = { &queue, &released, 0, {} };
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            root.children.push_back({ &queue, &released, 10 + i, {} });
+            root.children.back().children.push_back({ &queue, &released, 100 + i, {} });
+        }
+        Object other = { &released, 1 };
+        queue.push(5, { releaseOwner, &root });
+        queue.push(7, recorded(other));
+
+        CHECK(queue.drainAll() == 8);
+        CHECK(queue.empty());
+        CHECK((released.ids == std::vector<uint32_t>{ 0, 10, 11, 12, 100, 101, 102, 1 }));
+    }
+
+    // What ResourceManager::releaseAll() sees, a deleted mesh schedules its buffers outside the queue
+    struct Scheduler
+    {
+        std::vector<release::Release> scheduled;
+        uint32_t takes = 0;
+    };
+
+    struct FakeMesh
+    {
+        Scheduler* scheduler;
+        Released* released;
+        uint32_t id;
+        std::vector<Object> buffers;
+    };
+
+    void deleteMesh(void* pointer)
+    {
+        auto mesh = static_cast<FakeMesh*>(pointer);
+        mesh->released->ids.push_back(mesh->id);
+        for (auto& buffer : mesh->buffers)
+        {
+            mesh->scheduler->scheduled.push_back(recorded(buffer));
+        }
+    }
+
+    void testDrainAllScheduled()
+    {
+        Released released;
+        Scheduler scheduler;
+        release::DeferredReleaseQueue queue;
+
+        std::vector<FakeMesh> meshes;
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            meshes.push_back({ &scheduler, &released, i, {} });
+            for (uint32_t j = 0; j < 4; j++)
+            {
+                meshes.back().buffers.push_back({ &released, 10 * (i + 1) + j });
+            }
+        }
+
+        // One mesh still waits on its fence, one was scheduled this frame and has none yet
+        queue.push(3, { deleteMesh, &meshes[0] });
+        queue.push(4, { deleteMesh, &meshes[1] });
+        scheduler.scheduled.push_back({ deleteMesh, &meshes[2] });
+
+        uint32_t const count = queue.drainAll([&](std::vector<release::Release>& scheduled)
+        {
+            scheduler.takes++;
+            scheduled.swap(scheduler.scheduled);
+        });
+
+        CHECK(count == 15);
+        CHECK(queue.empty());
+        CHECK(scheduler.scheduled.empty());
+        // Queued meshes, then the scheduled mesh and their buffers, then its own buffers, then nothing new
+        CHECK(scheduler.takes == 3);
+        CHECK((released.ids == std::vector<uint32_t>{ 0, 1, 2, 10, 11, 12, 13, 20, 21, 22, 23, 30, 31, 32, 33 }));
+
+        // Nothing to do returns straight away
+        CHECK(queue.drainAll([](std::vector<release::Release>&) {}) == 0);
+    }
+}
+
+int main()
+{
+    testFenceOrder();
+    testBudget();
+    testPushDuringDrainAll();
+    testDrainAllScheduled();
+    return testing::result();
+}
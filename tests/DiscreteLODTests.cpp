@@ -0,0 +1,70 @@
+#include <cfloat>
+#include <vector>
+
+#include "TestCheck.h"
+#include "LOD/DiscreteLOD.h"
+
+namespace
+{
+    void testProjectedSphereSize()
+    {
+        const hlsl::float4 sphere(0.0f, 0.0f, 0.0f, 1.0f);
+
+        // Diameter 2 at distance 10, 100 pixels per unit at distance 1
+        CHECK_NEAR(lod::projectedSphereSize(sphere, hlsl::float3(0.0f, 0.0f, 10.0f), 100.0f), 20.0f, 1e-4f);
+        CHECK_NEAR(lod::projectedSphereSize(sphere, hlsl::float3(0.0f, 20.0f, 0.0f), 100.0f), 10.0f, 1e-4f);
+
+        // Camera inside or on the sphere
+        CHECK(lod::projectedSphereSize(sphere, hlsl::float3(0.0f, 0.5f, 0.0f), 100.0f) == FLT_MAX);
+        CHECK(lod::projectedSphereSize(sphere, hlsl::float3(1.0f, 0.0f, 0.0f), 100.0f) == FLT_MAX);
+
+        // Center isn't at the origin
+        const hlsl::float4 moved(5.0f, 0.0f, 0.0f, 2.0f);
+        CHECK_NEAR(lod::projectedSphereSize(moved, hlsl::float3(5.0f, 0.0f, 8.0f), 10.0f), 5.0f, 1e-4f);
+    }
+
+    void testSelectLOD()
+    {
+        // Radius 1 covering 200 pixels is 100 pixels per unit, errors are 1, 5 and 20 pixels
+        const std::vector<float> errors = { 0.0f, 0.01f, 0.05f, 0.2f };
+
+        CHECK(lod::selectLOD(200.0f, 1.0f, errors, 0.5f) == 0);
+        CHECK(lod::selectLOD(200.0f, 1.0f, errors, 1.0f) == 1);
+        CHECK(lod::selectLOD(200.0f, 1.0f, errors, 6.0f) == 2);
+        CHECK(lod::selectLOD(200.0f, 1.0f, errors, 100.0f) == 3);
+
+        // Smaller on screen, coarser LOD
+        CHECK(lod::selectLOD(20.0f, 1.0f, errors, 1.0f) == 2);
+        CHECK(lod::selectLOD(2.0f, 1.0f, errors, 1.0f) == 3);
+
+        // Camera inside the bounds, degenerate bounds and no LODs
+        CHECK(lod::selectLOD(FLT_MAX, 1.0f, errors, 100.0f) == 0);
+        CHECK(lod::selectLOD(200.0f, 0.0f, errors, 100.0f) == 0);
+        CHECK(lod::selectLOD(200.0f, 1.0f, { 0.0f }, 100.0f) == 0);
+    }
+
+    void testCompactVertices()
+    {
+        std::vector<uint32_t> indices = { 5, 3, 5, 7, 3, 9 };
+        std::vector<uint32_t> sourceVertices;
+        lod::compactVertices(indices, 10, sourceVertices);
+
+        // Renumbered in first use order, unreferenced vertices dropped
+        CHECK((indices == std::vector<uint32_t>{ 0, 1, 0, 2, 1, 3 }));
+        CHECK((sourceVertices == std::vector<uint32_t>{ 5, 3, 7, 9 }));
+
+        // Already compact stays as it is
+        std::vector<uint32_t> compact = { 0, 1, 2, 2, 1, 3 };
+        lod::compactVertices(compact, 4, sourceVertices);
+        CHECK((compact == std::vector<uint32_t>{ 0, 1, 2, 2, 1, 3 }));
+        CHECK((sourceVertices == std::vector<uint32_t>{ 0, 1, 2, 3 }));
+    }
+}
+
+int main()
+{
+    testProjectedSphereSize();
+    testSelectLOD();
+    testCompactVertices();
+    return testing::result();
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "TestCheck.h"
+#include "Tools/FramePacing.h"
+
+namespace
+{
+    // Stands in for the direct queue fence, the GPU completes submissions in order
+    class FakeFence
+    {
+    public:
+        uint64_t signal() { return ++m_signalled; }
+        uint64_t completedValue() const { return m_completed; }
+        uint64_t lastSignalled() const { return m_signalled; }
+
+        void completeUpTo(uint64_t value) { m_completed = std::max(m_completed, std::min(value, m_signalled)); }
+
+    private:
+        uint64_t m_signalled = 0;
+        uint64_t m_completed = 0;
+    };
+
+    // Same order of calls as FramePacer::beginFrame(), the wait completes the fence it waits for
+    uint64_t beginFrame(pacing::FrameTracker& tracker, FakeFence& fence)
+    {
+        uint64_t const waited = tracker.fenceToWaitFor();
+        if (waited != 0)
+            fence.completeUpTo(waited);
+        tracker.retire(fence.completedValue());
+        tracker.beginFrame();
+        return waited;
+    }
+
+    void testWaitsFramesInFlightBack()
+    {
+        for (uint32_t framesInFlight = 1; framesInFlight <= 4; framesInFlight++)
+        {
+            pacing::FrameTracker tracker;
+            tracker.setFramesInFlight(framesInFlight);
+            FakeFence fence;
+
+            for (uint32_t frame = 1; frame <= 20; frame++)
+            {
+                uint64_t const newest = fence.lastSignalled();
+                uint64_t const waited = beginFrame(tracker, fence);
+
+                // The GPU never catches up on its own, so every frame past the first framesInFlight waits
+                if (frame <= framesInFlight)
+                    CHECK(waited == 0);
+                else
+                    CHECK(waited == frame - framesInFlight);
+
+                // With more than one frame in flight the newest submission is never waited for
+                if (framesInFlight > 1)
+                    CHECK(waited != newest || newest == 0);
+
+                CHECK(tracker.pendingFrames() < framesInFlight);
+                tracker.endFrame(fence.signal());
+                CHECK(tracker.pendingFrames() <= framesInFlight);
+            }
+            CHECK(tracker.frameNumber() == 20);
+        }
+    }
+
+    void testGPUAhead()
+    {
+        pacing::FrameTracker tracker;
+        tracker.setFramesInFlight(3);
+        FakeFence fence;
+
+        for (uint32_t frame = 0; frame < 3; frame++)
+        {
+            beginFrame(tracker, fence);
+            tracker.endFrame(fence.signal());
+        }
+        CHECK(tracker.fenceToWaitFor() == 1);
+
+        // Everything already done, nothing left to wait for
+        fence.completeUpTo(3);
+        tracker.retire(fence.completedValue());
+        CHECK(tracker.pendingFrames() == 0);
+        CHECK(tracker.fenceToWaitFor() == 0);
+    }
+
+    void testShrinkWhilePending()
+    {
+        pacing::FrameTracker tracker;
+        tracker.setFramesInFlight(4);
+        FakeFence fence;
+
+        for (uint32_t frame = 0; frame < 4; frame++)
+        {
+            beginFrame(tracker, fence);
+            tracker.endFrame(fence.signal());
+        }
+        CHECK(tracker.pendingFrames() == 4);
+        CHECK(tracker.fenceToWaitFor() == 1);
+
+        // Frames already submitted stay pending, the wait moves forward so one wait brings it back to the limit
+        tracker.setFramesInFlight(2);
+        CHECK(tracker.pendingFrames() == 4);
+        CHECK(tracker.fenceToWaitFor() == 3);
+
+        CHECK(beginFrame(tracker, fence) == 3);
+        CHECK(tracker.pendingFrames() == 1);
+        tracker.endFrame(fence.signal());
+        CHECK(tracker.pendingFrames() == 2);
+        CHECK(tracker.fenceToWaitFor() == 4);
+
+        // One frame in flight waits for the previous frame
+        tracker.setFramesInFlight(1);
+        CHECK(tracker.fenceToWaitFor() == 5);
+        CHECK(beginFrame(tracker, fence) == 5);
+        CHECK(tracker.pendingFrames() == 0);
+        tracker.endFrame(fence.signal());
+
+        // Zero is clamped to one
+        tracker.setFramesInFlight(0);
+        CHECK(tracker.framesInFlight() == 1);
+        CHECK(tracker.fenceToWaitFor() == 6);
+
+        // Growing again doesn't wait until the new limit is reached
+        tracker.setFramesInFlight(3);
+        CHECK(tracker.fenceToWaitFor() == 0);
+    }
+
+    void testRetireOutOfOrder()
+    {
+        pacing::FrameTracker tracker;
+        tracker.setFramesInFlight(8);
+
+        // Fence values of frames don't have to be consecutive, other submissions signal in between
+        uint64_t const fences[] = { 10, 20, 30, 40, 50 };
+        for (uint64_t fenceValue : fences)
+        {
+            tracker.beginFrame();
+            tracker.endFrame(fenceValue);
+        }
+
+        // Between two frames retires only the older one
+        tracker.retire(25);
+        CHECK(tracker.pendingFrames() == 3);
+
+        // A stale completed value read later doesn't bring anything back or retire more
+        tracker.retire(15);
+        CHECK(tracker.pendingFrames() == 3);
+        tracker.retire(0);
+        CHECK(tracker.pendingFrames() == 3);
+
+        tracker.setFramesInFlight(2);
+        CHECK(tracker.fenceToWaitFor() == 40);
+
+        tracker.retire(50);
+        CHECK(tracker.pendingFrames() == 0);
+        tracker.retire(30);
+        CHECK(tracker.pendingFrames() == 0);
+        CHECK(tracker.fenceToWaitFor() == 0);
+    }
+
+    void testRandomCompletion()
+    {
+        std::mt19937 rng(5);
+        pacing::FrameTracker tracker;
+        FakeFence fence;
+
+        for (uint32_t frame = 0; frame < 10000; frame++)
+        {
+            if (rng() % 50 == 0)
+                tracker.setFramesInFlight(1 + rng() % 4);
+
+            // The GPU sometimes runs ahead of the wait
+            if (rng() % 3 == 0)
+                fence.completeUpTo(fence.completedValue() + rng() % 3);
+
+            uint64_t const newest = fence.lastSignalled();
+            uint64_t const waited = beginFrame(tracker, fence);
+            if (!CHECK(tracker.pendingFrames() < tracker.framesInFlight()))
+                return;
+            if (tracker.framesInFlight() > 1)
+                CHECK(waited != newest || waited == 0);
+
+            tracker.endFrame(fence.signal());
+        }
+    }
+}
+
+int main()
+{
+    testWaitsFramesInFlightBack();
+    testGPUAhead();
+    testShrinkWhilePending();
+    testRetireOutOfOrder();
+    testRandomCompletion();
+    return testing::result();
+}
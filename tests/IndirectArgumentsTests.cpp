@@ -0,0 +1,159 @@
+#include <cstdint>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Indirect/IndirectArguments.h"
+
+namespace
+{
+    // Every record from first on stays within the dispatch limits and covers its meshlets with its groups
+    bool withinLimits(indirect::IndirectArguments const& arguments, uint32_t meshletsPerGroup, uint32_t first = 0)
+    {
+        for (uint32_t i = first; i < arguments.count(); i++)
+        {
+            auto const& dispatch = arguments.commands[i].dispatch;
+            if (dispatch.threadGroupCountX > MAX_DISPATCH_GROUPS_PER_DIMENSION || dispatch.threadGroupCountY > MAX_DISPATCH_GROUPS_PER_DIMENSION)
+                return false;
+            if (static_cast<uint64_t>(dispatch.threadGroupCountX) * dispatch.threadGroupCountY * dispatch.threadGroupCountZ > MAX_DISPATCH_GROUPS)
+                return false;
+            if (static_cast<uint64_t>(dispatch.threadGroupCountX) * meshletsPerGroup < arguments.meshInfos[i].MeshletCount)
+                return false;
+        }
+        return true;
+    }
+
+    void testRangeSplitting()
+    {
+        // A BVH leaf per group, one record covers at most 32 * 65535 meshlets
+        uint32_t const maxMeshlets = 32 * MAX_DISPATCH_GROUPS_PER_DIMENSION;
+        indirect::IndirectArguments arguments;
+        indirect::appendCommands({ { 10, maxMeshlets * 2 + 100 } }, 2, 32, 1, arguments);
+
+        CHECK(arguments.count() == 3);
+        CHECK(arguments.meshInfos.size() == arguments.commands.size());
+        CHECK(arguments.meshInfos[0].MeshletOffset == 10);
+        CHECK(arguments.meshInfos[1].MeshletOffset == 10 + maxMeshlets);
+        CHECK(arguments.meshInfos[2].MeshletOffset == 10 + maxMeshlets * 2);
+        CHECK(arguments.meshInfos[0].MeshletCount == maxMeshlets);
+        CHECK(arguments.meshInfos[2].MeshletCount == 100);
+        CHECK(arguments.commands[0].dispatch.threadGroupCountX == MAX_DISPATCH_GROUPS_PER_DIMENSION);
+        CHECK(arguments.commands[2].dispatch.threadGroupCountX == 4);
+        for (auto const& info : arguments.meshInfos)
+        {
+            CHECK(info.IndexBytes == 2);
+            CHECK(info.InstanceOffset == 0);
+        }
+        CHECK(withinLimits(arguments, 32));
+
+        // One meshlet per group, appended after what is already there
+        indirect::appendCommands({ { 0, MAX_DISPATCH_GROUPS_PER_DIMENSION }, { 70000, MAX_DISPATCH_GROUPS_PER_DIMENSION + 1 } }, 4, 1, 1, arguments);
+        CHECK(arguments.count() == 6);
+        CHECK(arguments.meshInfos[3].MeshletCount == MAX_DISPATCH_GROUPS_PER_DIMENSION);
+        CHECK(arguments.meshInfos[4].MeshletOffset == 70000);
+        CHECK(arguments.meshInfos[5].MeshletOffset == 70000 + MAX_DISPATCH_GROUPS_PER_DIMENSION);
+        CHECK(arguments.meshInfos[5].MeshletCount == 1);
+        CHECK(arguments.commands[5].dispatch.threadGroupCountX == 1);
+        CHECK(withinLimits(arguments, 1, 3));
+
+        // Empty ranges produce nothing
+        indirect::IndirectArguments empty;
+        indirect::appendCommands({ { 5, 0 } }, 2, 32, 4, empty);
+        CHECK(empty.count() == 0);
+    }
+
+    void testInstanceBatching()
+    {
+        // 65535 groups per instance leave room for 64 instances in 2^22 groups
+        indirect::IndirectArguments arguments;
+        indirect::appendCommands({ { 0, 32 * MAX_DISPATCH_GROUPS_PER_DIMENSION } }, 2, 32, 200, arguments);
+        CHECK(MAX_DISPATCH_GROUPS / MAX_DISPATCH_GROUPS_PER_DIMENSION == 64);
+        CHECK(arguments.count() == 4);
+        uint32_t const expectedInstances[] = { 64, 64, 64, 8 };
+        for (uint32_t i = 0; i < arguments.count(); i++)
+        {
+            CHECK(arguments.meshInfos[i].InstanceOffset == i * 64);
+            CHECK(arguments.commands[i].dispatch.threadGroupCountY == expectedInstances[i]);
+            CHECK(arguments.meshInfos[i].MeshletOffset == 0);
+        }
+        CHECK(withinLimits(arguments, 32));
+
+        // Small ranges are capped by group Y instead
+        indirect::IndirectArguments many;
+        indirect::appendCommands({ { 0, 10 } }, 2, 1, 70000, many);
+        CHECK(many.count() == 2);
+        CHECK(many.commands[0].dispatch.threadGroupCountY == MAX_DISPATCH_GROUPS_PER_DIMENSION);
+        CHECK(many.commands[1].dispatch.threadGroupCountY == 70000 - MAX_DISPATCH_GROUPS_PER_DIMENSION);
+        CHECK(many.meshInfos[1].InstanceOffset == MAX_DISPATCH_GROUPS_PER_DIMENSION);
+        CHECK(withinLimits(many, 1));
+
+        // Split ranges batch instances separately, instance batches follow their range
+        indirect::IndirectArguments both;
+        indirect::appendCommands({ { 0, 32 * MAX_DISPATCH_GROUPS_PER_DIMENSION + 32 } }, 2, 32, 100, both);
+        CHECK(both.count() == 3);
+        CHECK(both.meshInfos[1].MeshletOffset == 0 && both.meshInfos[1].InstanceOffset == 64);
+        CHECK(both.meshInfos[2].MeshletCount == 32 && both.meshInfos[2].InstanceOffset == 0);
+        CHECK(both.commands[2].dispatch.threadGroupCountY == 100);
+        CHECK(withinLimits(both, 32));
+    }
+
+    void testCompaction()
+    {
+        indirect::IndirectArguments arguments;
+        std::vector<MeshSubset> ranges;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            ranges.push_back({ i * 100, 10 + i });
+        }
+        indirect::appendCommands(ranges, 2, 1, 1, arguments);
+        CHECK(arguments.count() == 8);
+
+        // Survivors keep their order and their MeshInfo stays next to their dispatch
+        CHECK(indirect::compactCommands({ 0, 1, 1, 0, 0, 1, 0, 1 }, arguments) == 4);
+        CHECK(arguments.count() == 4);
+        CHECK(arguments.meshInfos.size() == 4);
+        uint32_t const survivors[] = { 1, 2, 5, 7 };
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            CHECK(arguments.meshInfos[i].MeshletOffset == survivors[i] * 100);
+            CHECK(arguments.meshInfos[i].MeshletCount == 10 + survivors[i]);
+            CHECK(arguments.commands[i].dispatch.threadGroupCountX == 10 + survivors[i]);
+        }
+
+        // Records without a visibility entry are dropped
+        CHECK(indirect::compactCommands({ 1, 1 }, arguments) == 2);
+        CHECK(arguments.meshInfos[1].MeshletOffset == 200);
+
+        CHECK(indirect::compactCommands({ 0, 0 }, arguments) == 0);
+        CHECK(arguments.meshInfos.empty() && arguments.commands.empty());
+    }
+
+    void testPatchAddresses()
+    {
+        CHECK(sizeof(indirect::MeshInfoRecord) == 256);
+
+        indirect::IndirectArguments arguments;
+        indirect::appendCommands({ { 0, 4 }, { 10, 4 }, { 20, 4 } }, 2, 1, 1, arguments);
+        uint64_t const base = 0x10000;
+        indirect::patchMeshInfoAddresses(base, sizeof(indirect::MeshInfoRecord), arguments);
+        for (uint32_t i = 0; i < arguments.count(); i++)
+        {
+            CHECK(arguments.commands[i].meshInfoAddress == base + i * 256);
+        }
+
+        // Patched after compaction, addresses follow the compacted order
+        indirect::compactCommands({ 1, 0, 1 }, arguments);
+        indirect::patchMeshInfoAddresses(base, 512, arguments);
+        CHECK(arguments.commands[0].meshInfoAddress == base);
+        CHECK(arguments.commands[1].meshInfoAddress == base + 512);
+        CHECK(arguments.meshInfos[1].MeshletOffset == 20);
+    }
+}
+
+int main()
+{
+    testRangeSplitting();
+    testInstanceBatching();
+    testCompaction();
+    testPatchAddresses();
+    return testing::result();
+}
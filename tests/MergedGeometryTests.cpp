@@ -0,0 +1,193 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Geometry/MergedGeometry.h"
+
+namespace
+{
+    struct SyntheticMesh
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> meshletTriangles;
+        std::vector<CullData> cullData;
+
+        geometry::MeshGeometryView view() const { return { &vertices, &indices, &meshlets, &meshletTriangles, &cullData }; }
+    };
+
+    // Every vertex is unique, so a corner resolved through the wrong offset ends at a different vertex
+    SyntheticMesh makeMesh(std::mt19937& rng, uint32_t meshIndex, uint32_t vertexCount, uint32_t meshletCount, bool withCullData)
+    {
+        SyntheticMesh mesh;
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            float const id = static_cast<float>(meshIndex * 100000 + v);
+            mesh.vertices.emplace_back(hlsl::float3(id, -id, 0.5f * id), hlsl::float3(0.0f, 1.0f, static_cast<float>(meshIndex)), hlsl::float2(id, 1.0f));
+        }
+
+        for (uint32_t m = 0; m < meshletCount; m++)
+        {
+            Meshlet meshlet;
+            meshlet.VertOffset = static_cast<uint32_t>(mesh.indices.size());
+            meshlet.VertCount = 3 + rng() % 62;
+            meshlet.PrimOffset = static_cast<uint32_t>(mesh.meshletTriangles.size());
+            meshlet.PrimCount = 1 + rng() % 124;
+            for (uint32_t v = 0; v < meshlet.VertCount; v++)
+            {
+                mesh.indices.push_back(rng() % vertexCount);
+            }
+            for (uint32_t p = 0; p < meshlet.PrimCount; p++)
+            {
+                mesh.meshletTriangles.push_back(olej_utils::packTriangle(
+                    static_cast<uint8_t>(rng() % meshlet.VertCount), static_cast<uint8_t>(rng() % meshlet.VertCount), static_cast<uint8_t>(rng() % meshlet.VertCount)));
+            }
+            mesh.meshlets.push_back(meshlet);
+
+            if (withCullData)
+            {
+                CullData cull;
+                cull.BoundingSphere = hlsl::float4(static_cast<float>(meshIndex), static_cast<float>(m), 0.0f, 1.0f + m);
+                cull.NormalCone[0] = static_cast<uint8_t>(meshIndex);
+                cull.NormalCone[1] = static_cast<uint8_t>(m);
+                cull.NormalCone[2] = 0;
+                cull.NormalCone[3] = 0xff;
+                cull.ApexOffset = 0.25f * m;
+                mesh.cullData.push_back(cull);
+            }
+        }
+        return mesh;
+    }
+
+    void testPackAndVerify()
+    {
+        std::mt19937 rng(7);
+        std::vector<SyntheticMesh> meshes;
+        meshes.push_back(makeMesh(rng, 0, 500, 12, true));
+        meshes.push_back(makeMesh(rng, 1, 40, 3, false));
+        meshes.push_back(makeMesh(rng, 2, 10, 0, true));
+        meshes.push_back(makeMesh(rng, 3, 2000, 30, true));
+
+        std::vector<geometry::MeshGeometryView> views;
+        for (auto const& mesh : meshes)
+        {
+            views.push_back(mesh.view());
+        }
+
+        geometry::MergedGeometry merged;
+        geometry::packMergedGeometry(views, merged);
+        CHECK(geometry::verifyMergedGeometry(views, merged));
+
+        CHECK(merged.vertices.size() == 2550);
+        CHECK(merged.meshlets.size() == 45);
+        CHECK(merged.cullData.size() == merged.meshlets.size());
+        CHECK(merged.indexBytes == sizeof(uint16_t));
+
+        // Ranges follow input order, offsets add up
+        CHECK(merged.ranges.size() == 4);
+        uint32_t vertexOffset = 0;
+        uint32_t indexOffset = 0;
+        uint32_t meshletOffset = 0;
+        uint32_t triangleOffset = 0;
+        for (uint32_t m = 0; m < meshes.size(); m++)
+        {
+            auto const& range = merged.ranges[m];
+            CHECK(range.vertexOffset == vertexOffset);
+            CHECK(range.indexOffset == indexOffset);
+            CHECK(range.meshletOffset == meshletOffset);
+            CHECK(range.triangleOffset == triangleOffset);
+            CHECK(range.meshletCount == meshes[m].meshlets.size());
+            vertexOffset += static_cast<uint32_t>(meshes[m].vertices.size());
+            indexOffset += static_cast<uint32_t>(meshes[m].indices.size());
+            meshletOffset += static_cast<uint32_t>(meshes[m].meshlets.size());
+            triangleOffset += static_cast<uint32_t>(meshes[m].meshletTriangles.size());
+        }
+
+        // Mesh without cull data keeps the arrays aligned with zeroed entries
+        for (uint32_t i = 0; i < merged.ranges[1].meshletCount; i++)
+        {
+            CHECK(merged.cullData[merged.ranges[1].meshletOffset + i].BoundingSphere.w == 0.0f);
+        }
+
+        // Every kind of corruption is caught
+        geometry::MergedGeometry broken = merged;
+        Meshlet const& meshlet = merged.meshlets[20];
+        uint32_t const firstCorner = merged.meshletTriangles[meshlet.PrimOffset] & 0xFF;
+        broken.indices[meshlet.VertOffset + firstCorner] ^= 1;
+        CHECK(!geometry::verifyMergedGeometry(views, broken));
+
+        broken = merged;
+        broken.meshlets[5].PrimOffset++;
+        CHECK(!geometry::verifyMergedGeometry(views, broken));
+
+        broken = merged;
+        broken.cullData[0].ApexOffset += 1.0f;
+        CHECK(!geometry::verifyMergedGeometry(views, broken));
+
+        broken = merged;
+        broken.ranges.pop_back();
+        CHECK(!geometry::verifyMergedGeometry(views, broken));
+
+        // More vertices than 16 bit indices can address
+        std::vector<SyntheticMesh> big;
+        big.push_back(makeMesh(rng, 0, 40000, 2, true));
+        big.push_back(makeMesh(rng, 1, 40000, 2, true));
+        geometry::MergedGeometry wide;
+        geometry::packMergedGeometry({ big[0].view(), big[1].view() }, wide);
+        CHECK(geometry::verifyMergedGeometry({ big[0].view(), big[1].view() }, wide));
+        CHECK(wide.indexBytes == sizeof(uint32_t));
+    }
+
+    bool sameRanges(std::vector<MeshSubset> const& a, std::vector<MeshSubset> const& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].offset != b[i].offset || a[i].size != b[i].size)
+                return false;
+        }
+        return true;
+    }
+
+    void testCoalesceRanges()
+    {
+        // Touching ranges join regardless of input order, empty ones are dropped
+        std::vector<MeshSubset> ranges = { { 10, 5 }, { 0, 10 }, { 30, 0 }, { 15, 5 } };
+        geometry::coalesceRanges(ranges, 100);
+        CHECK(sameRanges(ranges, { { 0, 20 } }));
+
+        // Gaps stay
+        ranges = { { 0, 5 }, { 6, 4 } };
+        geometry::coalesceRanges(ranges, 100);
+        CHECK(sameRanges(ranges, { { 0, 5 }, { 6, 4 } }));
+
+        // Long ranges are split into maxMeshlets pieces
+        ranges = { { 0, 250 } };
+        geometry::coalesceRanges(ranges, 100);
+        CHECK(sameRanges(ranges, { { 0, 100 }, { 100, 100 }, { 200, 50 } }));
+
+        // Joined first, then split, later ranges keep their place
+        ranges = { { 200, 10 }, { 60, 60 }, { 0, 60 }, { 500, 300 } };
+        geometry::coalesceRanges(ranges, 100);
+        CHECK(sameRanges(ranges, { { 0, 100 }, { 100, 20 }, { 200, 10 }, { 500, 100 }, { 600, 100 }, { 700, 100 } }));
+
+        // Exactly maxMeshlets isn't split
+        ranges = { { 0, 50 }, { 50, 50 } };
+        geometry::coalesceRanges(ranges, 100);
+        CHECK(sameRanges(ranges, { { 0, 100 } }));
+
+        ranges.clear();
+        geometry::coalesceRanges(ranges, 100);
+        CHECK(ranges.empty());
+    }
+}
+
+int main()
+{
+    testPackAndVerify();
+    testCoalesceRanges();
+    return testing::result();
+}
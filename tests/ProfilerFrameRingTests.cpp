@@ -0,0 +1,280 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Tools/ITimestampSource.h"
+#include "Tools/ProfilerFrameRing.h"
+
+namespace
+{
+    // Every timestamp is 10 ticks after the previous one, at 1000 ticks per second a tick is a millisecond
+    class FakeTimestampSource : public ITimestampSource
+    {
+    public:
+        explicit FakeTimestampSource(uint32_t queryCount) : queries(queryCount, 0) {}
+
+        void writeTimestamp(uint32_t queryIndex) override
+        {
+            writes.push_back(queryIndex);
+            queries[queryIndex] = clock;
+            clock += 10;
+        }
+
+        void resolve(uint32_t firstQuery, uint32_t queryCount) override
+        {
+            resolves.push_back({ firstQuery, queryCount });
+        }
+
+        bool isComplete(uint64_t fenceValue) override { return fenceValue <= completedFence; }
+
+        void readTimestamps(uint32_t firstQuery, uint32_t queryCount, uint64_t* timestamps) override
+        {
+            for (uint32_t i = 0; i < queryCount; i++)
+            {
+                timestamps[i] = queries[firstQuery + i];
+            }
+        }
+
+        uint64_t getFrequency() override { return 1000; }
+
+        struct Range
+        {
+            uint32_t first;
+            uint32_t count;
+        };
+
+        std::vector<uint64_t> queries;
+        std::vector<uint32_t> writes;
+        std::vector<Range> resolves;
+        uint64_t clock = 0;
+        uint64_t completedFence = 0;
+    };
+
+    void testPerSlotQueryRanges()
+    {
+        FakeTimestampSource source(3 * 4 * 2);
+        ProfilerFrameRing ring;
+        ring.initialize(&source, 3, 4);
+        uint32_t const name = ring.internName("Pass");
+
+        for (uint32_t frame = 1; frame <= 6; frame++)
+        {
+            source.writes.clear();
+            source.resolves.clear();
+            ring.beginFrame();
+            ring.endEntry(ring.startEntry(name));
+            ring.endEntry(ring.startEntry(name));
+            ring.endFrame();
+
+            // Frame n uses slot n % 3, two queries per entry
+            uint32_t const first = (frame % 3) * 4 * 2;
+            CHECK((source.writes == std::vector<uint32_t>{ first, first + 1, first + 2, first + 3 }));
+            CHECK(source.resolves.size() == 1);
+            CHECK(source.resolves[0].first == first);
+            CHECK(source.resolves[0].count == 4);
+
+            ring.frameSubmitted(frame);
+            source.completedFence = frame;
+            CHECK(ring.collect());
+        }
+
+        // Nothing written, nothing resolved
+        source.resolves.clear();
+        ring.beginFrame();
+        ring.endFrame();
+        CHECK(source.resolves.empty());
+    }
+
+    void testEntryOverflow()
+    {
+        FakeTimestampSource source(2 * 2 * 2);
+        ProfilerFrameRing ring;
+        ring.initialize(&source, 2, 2);
+        uint32_t const name = ring.internName("Pass");
+
+        ring.beginFrame();
+        ProfilerEntry* first = ring.startEntry(name);
+        ProfilerEntry* second = ring.startEntry(name);
+        ProfilerEntry* third = ring.startEntry(name);
+        ProfilerEntry* fourth = ring.startEntry(name);
+        CHECK(first != nullptr && second != nullptr);
+        CHECK(third == nullptr && fourth == nullptr);
+        // Dropped entries are ignored, open ones are closed by endFrame
+        ring.endEntry(fourth);
+        ring.endEntry(third);
+        ring.endEntry(second);
+        ring.endFrame();
+        ring.frameSubmitted(1);
+
+        source.completedFence = 1;
+        CHECK(ring.collect());
+        CHECK(ring.numResolved() == 2);
+        CHECK(ring.droppedEntries() == 2);
+        CHECK(ring.getResolved(0).nesting == 0);
+        CHECK(ring.getResolved(1).nesting == 1);
+        CHECK(ring.getResolved(0).endTicks > ring.getResolved(1).endTicks);
+
+        // Counted per frame
+        ring.beginFrame();
+        ring.endEntry(ring.startEntry(name));
+        ring.endFrame();
+        ring.frameSubmitted(2);
+        source.completedFence = 2;
+        CHECK(ring.collect());
+        CHECK(ring.numResolved() == 1);
+        CHECK(ring.droppedEntries() == 0);
+    }
+
+    void testInOrderCollect()
+    {
+        FakeTimestampSource source(4 * 4 * 2);
+        ProfilerFrameRing ring;
+        ring.initialize(&source, 4, 4);
+        uint32_t const outer = ring.internName("Frame");
+        uint32_t const inner = ring.internName("Shadows");
+        CHECK(ring.internName("Frame") == outer);
+
+        // Frame 1 has a nested entry, frame 2 a single longer one
+        ring.beginFrame();
+        ProfilerEntry* frame = ring.startEntry(outer);
+        ring.endEntry(ring.startEntry(inner));
+        ring.endEntry(frame);
+        ring.endFrame();
+        ring.frameSubmitted(1);
+
+        ring.beginFrame();
+        ring.endEntry(ring.startEntry(inner));
+        ring.endFrame();
+        ring.frameSubmitted(2);
+
+        CHECK(!ring.collect());
+
+        // Frame 2 done out of order is not read before frame 1
+        source.completedFence = 1;
+        CHECK(ring.collect());
+        CHECK(ring.numResolved() == 2);
+        CHECK(ring.getResolved(0).nameId == outer);
+        CHECK(ring.getResolved(1).nameId == inner);
+        CHECK(std::string(ring.getResolved(1).name) == "Shadows");
+        CHECK_NEAR(ring.getResolved(0).time, 30.0f, 1e-4f);
+        CHECK_NEAR(ring.getResolved(1).time, 10.0f, 1e-4f);
+        CHECK(ring.getResolved(0).nesting == 0);
+        CHECK(ring.getResolved(1).nesting == 1);
+        CHECK(!ring.collect());
+
+        source.completedFence = 2;
+        CHECK(ring.collect());
+        CHECK(ring.numResolved() == 1);
+        CHECK(ring.getResolved(0).nameId == inner);
+        CHECK(ring.getResolved(0).startTicks == 40);
+        CHECK(!ring.collect());
+        CHECK(ring.lostFrames() == 0);
+    }
+
+    void testLostFrames()
+    {
+        FakeTimestampSource source(2 * 1 * 2);
+        ProfilerFrameRing ring;
+        ring.initialize(&source, 2, 1);
+        uint32_t const name = ring.internName("Pass");
+
+        auto submit = [&](uint64_t fence)
+        {
+            ring.beginFrame();
+            ring.endEntry(ring.startEntry(name));
+            ring.endFrame();
+            ring.frameSubmitted(fence);
+        };
+
+        // Frame 3 reuses frame 1's slot before anyone collected it
+        submit(1);
+        submit(2);
+        CHECK(ring.lostFrames() == 0);
+        submit(3);
+        CHECK(ring.lostFrames() == 1);
+        submit(4);
+        CHECK(ring.lostFrames() == 2);
+
+        // What is left comes back oldest first
+        source.completedFence = 4;
+        CHECK(ring.collect());
+        CHECK(ring.getResolved(0).startTicks == 40);
+        CHECK(ring.collect());
+        CHECK(ring.getResolved(0).startTicks == 60);
+        CHECK(!ring.collect());
+
+        // Collected slots are not lost when reused
+        submit(5);
+        submit(6);
+        CHECK(ring.lostFrames() == 2);
+    }
+
+    // One frame per draw path of Model::draw, the way GPUProfiler feeds MeshletBenchmark. Every path has to
+    // produce a sample, otherwise a benchmark run never ends
+    void testSumResolved()
+    {
+        FakeTimestampSource source(8 * 8 * 2);
+        ProfilerFrameRing ring;
+        ring.initialize(&source, 8, 8);
+        uint32_t const drawName = ring.internName("Model Draw");
+        uint32_t const meshName = ring.internName("Dispatch Mesh");
+        uint32_t const mergedName = ring.internName("Dispatch Merged");
+        uint32_t const indirectName = ring.internName("Dispatch Indirect");
+        std::vector<uint32_t> const benchmarkNames = { meshName, mergedName, indirectName };
+
+        // Per mesh path: three dispatches nested in the draw, 10 ms each
+        ring.beginFrame();
+        auto draw = ring.startEntry(drawName);
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            ring.endEntry(ring.startEntry(meshName));
+        }
+        ring.endEntry(draw);
+        ring.endFrame();
+        ring.frameSubmitted(1);
+
+        // Merged and indirect paths: a single dispatch each
+        uint64_t fenceValue = 1;
+        for (uint32_t const pathName : { mergedName, indirectName })
+        {
+            ring.beginFrame();
+            draw = ring.startEntry(drawName);
+            ring.endEntry(ring.startEntry(pathName));
+            ring.endEntry(draw);
+            ring.endFrame();
+            ring.frameSubmitted(++fenceValue);
+        }
+
+        // Nothing the benchmark counts
+        ring.beginFrame();
+        ring.endEntry(ring.startEntry(drawName));
+        ring.endFrame();
+        ring.frameSubmitted(++fenceValue);
+
+        source.completedFence = fenceValue;
+        float const expected[] = { 30.0f, 10.0f, 10.0f };
+        for (float const expectedTime : expected)
+        {
+            float time = -1.0f;
+            CHECK(ring.collect());
+            CHECK(ring.sumResolved(benchmarkNames, time));
+            CHECK_NEAR(time, expectedTime, 1e-4f);
+        }
+
+        float time = -1.0f;
+        CHECK(ring.collect());
+        CHECK(!ring.sumResolved(benchmarkNames, time));
+        CHECK(time == 0.0f);
+    }
+}
+
+int main()
+{
+    testPerSlotQueryRanges();
+    testEntryOverflow();
+    testInOrderCollect();
+    testLostFrames();
+    testSumResolved();
+    return testing::result();
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "Tools/RecordingSchedule.h"
+
+namespace
+{
+    // Chunks cover every item once, in order, none of them empty
+    bool validChunks(std::vector<uint64_t> const& costs, uint32_t maxChunks, std::vector<recording::RecordingChunk> const& chunks)
+    {
+        if (costs.empty())
+            return chunks.empty();
+        if (chunks.empty() || chunks.size() > std::max(maxChunks, 1u) || chunks.size() > costs.size())
+            return false;
+
+        uint32_t next = 0;
+        for (auto const& chunk : chunks)
+        {
+            if (chunk.first != next || chunk.count == 0)
+                return false;
+
+            uint64_t cost = 0;
+            for (uint32_t i = chunk.first; i < chunk.first + chunk.count; i++)
+            {
+                cost += std::max<uint64_t>(costs[i], 1);
+            }
+            if (cost != chunk.cost)
+                return false;
+            next += chunk.count;
+        }
+        return next == costs.size();
+    }
+
+    bool sameChunks(std::vector<recording::RecordingChunk> const& a, std::vector<recording::RecordingChunk> const& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].first != b[i].first || a[i].count != b[i].count || a[i].cost != b[i].cost)
+                return false;
+        }
+        return true;
+    }
+
+    void testChunksAreContiguous()
+    {
+        std::vector<recording::RecordingChunk> chunks;
+        recording::partitionByCost({}, 4, 0, chunks);
+        CHECK(chunks.empty());
+
+        std::mt19937 rng(3);
+        uint32_t const maxChunkCounts[] = { 0, 1, 2, 3, 7, 16, 100 };
+        for (uint32_t round = 0; round < 200; round++)
+        {
+            // Zero costs and single huge items included
+            std::vector<uint64_t> costs(1 + rng() % 60);
+            for (auto& cost : costs)
+            {
+                uint32_t const kind = rng() % 10;
+                cost = kind == 0 ? 0 : kind == 1 ? 100000 + rng() % 100000 : rng() % 1000;
+            }
+
+            for (uint32_t maxChunks : maxChunkCounts)
+            {
+                recording::partitionByCost(costs, maxChunks, 0, chunks);
+                if (!CHECK(validChunks(costs, maxChunks, chunks)))
+                    return;
+            }
+        }
+
+        // Equal costs split evenly
+        recording::partitionByCost(std::vector<uint64_t>(16, 5), 4, 0, chunks);
+        CHECK(chunks.size() == 4);
+        for (auto const& chunk : chunks)
+        {
+            CHECK(chunk.count == 4);
+        }
+
+        // An item bigger than a share closes its own chunk, the rest is split again
+        recording::partitionByCost({ 100, 1, 1, 1, 1, 1, 1 }, 3, 0, chunks);
+        CHECK(validChunks({ 100, 1, 1, 1, 1, 1, 1 }, 3, chunks));
+        CHECK(chunks[0].first == 0 && chunks[0].count == 1);
+        CHECK(chunks.size() == 3);
+    }
+
+    void testMinChunkCost()
+    {
+        std::vector<recording::RecordingChunk> chunks;
+        std::vector<uint64_t> const costs(10, 10);
+
+        recording::partitionByCost(costs, 8, 0, chunks);
+        CHECK(chunks.size() == 8);
+
+        // Total of 100 makes room for three chunks of at least 30
+        recording::partitionByCost(costs, 8, 30, chunks);
+        CHECK(validChunks(costs, 3, chunks));
+        CHECK(chunks.size() == 3);
+
+        // Cheaper than a single chunk is still one chunk
+        recording::partitionByCost(costs, 8, 1000, chunks);
+        CHECK(chunks.size() == 1);
+        CHECK(chunks[0].count == 10 && chunks[0].cost == 100);
+
+        // maxChunks still caps it
+        recording::partitionByCost(costs, 2, 1, chunks);
+        CHECK(chunks.size() == 2);
+    }
+
+    // Chunk results are written by chunk index, so the assembled output can't depend on which thread ran what
+    std::vector<uint32_t> recordInChunks(recording::WorkerPool& pool, std::vector<uint64_t> const& costs, std::vector<recording::RecordingChunk>& chunks)
+    {
+        recording::partitionByCost(costs, 8, 50, chunks);
+        std::vector<std::vector<uint32_t>> recorded(chunks.size());
+        pool.run(static_cast<uint32_t>(chunks.size()), [&](uint32_t chunkIndex)
+        {
+            auto const& chunk = chunks[chunkIndex];
+            for (uint32_t i = chunk.first; i < chunk.first + chunk.count; i++)
+            {
+                recorded[chunkIndex].push_back(i);
+            }
+        });
+
+        std::vector<uint32_t> order;
+        for (auto const& items : recorded)
+        {
+            order.insert(order.end(), items.begin(), items.end());
+        }
+        return order;
+    }
+
+    void testDeterministicAcrossThreadCounts()
+    {
+        std::mt19937 rng(11);
+        std::vector<uint64_t> costs(500);
+        for (auto& cost : costs)
+        {
+            cost = rng() % 300;
+        }
+
+        std::vector<uint32_t> expectedOrder(costs.size());
+        for (uint32_t i = 0; i < expectedOrder.size(); i++)
+        {
+            expectedOrder[i] = i;
+        }
+
+        recording::WorkerPool pool;
+        std::vector<recording::RecordingChunk> reference;
+        CHECK(recordInChunks(pool, costs, reference) == expectedOrder);
+
+        for (uint32_t threads : { 1u, 2u, 3u, 8u })
+        {
+            pool.start(threads);
+            for (uint32_t repeat = 0; repeat < 20; repeat++)
+            {
+                std::vector<recording::RecordingChunk> chunks;
+                CHECK(recordInChunks(pool, costs, chunks) == expectedOrder);
+                CHECK(sameChunks(chunks, reference));
+            }
+        }
+        pool.stop();
+    }
+
+    bool runEachOnce(recording::WorkerPool& pool, uint32_t taskCount)
+    {
+        std::vector<std::atomic<uint32_t>> executed(taskCount);
+        pool.run(taskCount, [&](uint32_t index) { executed[index].fetch_add(1, std::memory_order_relaxed); });
+        for (auto const& count : executed)
+        {
+            if (count.load() != 1)
+                return false;
+        }
+        return true;
+    }
+
+    void testWorkerPoolRestarts()
+    {
+        recording::WorkerPool pool;
+        CHECK(pool.threadCount() == 0);
+        CHECK(runEachOnce(pool, 10));
+
+        for (uint32_t threads : { 4u, 1u, 0u, 6u, 3u })
+        {
+            pool.start(threads);
+            CHECK(pool.threadCount() == threads);
+            for (uint32_t taskCount : { 0u, 1u, 3u, 64u, 1000u })
+            {
+                CHECK(runEachOnce(pool, taskCount));
+            }
+        }
+
+        // Back on the calling thread after stop
+        pool.stop();
+        CHECK(pool.threadCount() == 0);
+        CHECK(runEachOnce(pool, 5));
+    }
+}
+
+int main()
+{
+    testChunksAreContiguous();
+    testMinChunkCost();
+    testDeterministicAcrossThreadCounts();
+    testWorkerPoolRestarts();
+    return testing::result();
+}
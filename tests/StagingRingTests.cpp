@@ -0,0 +1,140 @@
+#include <cstdint>
+
+#include "TestCheck.h"
+#include "DX12Wrappers/StagingRing.h"
+
+namespace
+{
+    void testWrapWithAlignmentPadding()
+    {
+        StagingRing ring(256);
+        uint64_t offset = UINT64_MAX;
+
+        CHECK(ring.allocate(100, 1, offset));
+        CHECK(offset == 0);
+        ring.submit(1);
+
+        // 28 bytes of padding up to the next 64 byte boundary count as used
+        CHECK(ring.allocate(100, 64, offset));
+        CHECK(offset == 128);
+        CHECK(ring.usedBytes() == 228);
+        ring.submit(2);
+
+        ring.reclaim(1);
+        CHECK(ring.usedBytes() == 128);
+
+        // Aligned start 240 doesn't fit, wraps to 0 and the 28 byte tail is freed with it
+        CHECK(ring.allocate(50, 16, offset));
+        CHECK(offset == 0);
+        CHECK(ring.usedBytes() == 128 + 28 + 50);
+        ring.submit(3);
+
+        ring.reclaim(2);
+        CHECK(ring.usedBytes() == 78);
+        // Next one goes right after the wrapped allocation
+        CHECK(ring.allocate(10, 16, offset));
+        CHECK(offset == 64);
+        ring.submit(4);
+
+        ring.reclaim(4);
+        CHECK(ring.usedBytes() == 0);
+    }
+
+    void testLargerThanFreeTail()
+    {
+        StagingRing ring(256);
+        uint64_t offset = UINT64_MAX;
+
+        CHECK(!ring.allocate(0, 1, offset));
+        CHECK(!ring.allocate(257, 1, offset));
+
+        CHECK(ring.allocate(200, 1, offset));
+        ring.submit(1);
+
+        // 56 free at the end, 0..200 still in flight
+        CHECK(!ring.allocate(100, 1, offset));
+        CHECK(ring.usedBytes() == 200);
+        CHECK(!ring.hasUnsubmitted());
+
+        // The tail is enough for a small one
+        CHECK(ring.allocate(56, 1, offset));
+        CHECK(offset == 200);
+        ring.submit(2);
+
+        // Empty ring starts over, the whole buffer is available
+        ring.reclaim(2);
+        CHECK(ring.allocate(256, 1, offset));
+        CHECK(offset == 0);
+        CHECK(ring.usedBytes() == 256);
+        CHECK(!ring.allocate(1, 1, offset));
+        ring.submit(3);
+        ring.reclaim(3);
+        CHECK(ring.allocate(1, 1, offset));
+        CHECK(offset == 0);
+    }
+
+    void testPartiallyCompletedFences()
+    {
+        StagingRing ring(256);
+        uint64_t offset = 0;
+
+        for (uint64_t fence = 1; fence <= 3; fence++)
+        {
+            CHECK(ring.allocate(32, 1, offset));
+            CHECK(ring.allocate(32, 1, offset));
+            CHECK(ring.hasUnsubmitted());
+            ring.submit(fence);
+            CHECK(!ring.hasUnsubmitted());
+        }
+        CHECK(ring.usedBytes() == 192);
+
+        // Submitting nothing adds no submission
+        ring.submit(4);
+        CHECK(ring.oldestFenceValue() == 1);
+
+        ring.reclaim(0);
+        CHECK(ring.usedBytes() == 192);
+        ring.reclaim(2);
+        CHECK(ring.usedBytes() == 64);
+        CHECK(ring.oldestFenceValue() == 3);
+
+        // Freed space is reused, the oldest submission keeps its bytes
+        CHECK(ring.allocate(64, 1, offset));
+        CHECK(offset == 192);
+        CHECK(ring.allocate(128, 1, offset));
+        CHECK(offset == 0);
+        CHECK(!ring.allocate(1, 1, offset));
+        ring.submit(5);
+
+        ring.reclaim(3);
+        CHECK(ring.oldestFenceValue() == 5);
+        CHECK(ring.usedBytes() == 192);
+        ring.reclaim(5);
+        CHECK(ring.usedBytes() == 0);
+    }
+
+    void testOldestFenceValueWhenEmpty()
+    {
+        StagingRing ring(64);
+        CHECK(ring.oldestFenceValue() == 0);
+
+        uint64_t offset = 0;
+        CHECK(ring.allocate(16, 1, offset));
+        // Not submitted yet
+        CHECK(ring.oldestFenceValue() == 0);
+        ring.submit(7);
+        CHECK(ring.oldestFenceValue() == 7);
+        ring.reclaim(7);
+        CHECK(ring.oldestFenceValue() == 0);
+        CHECK(ring.usedBytes() == 0);
+    }
+}
+
+int main()
+{
+    testWrapWithAlignmentPadding();
+    testLargerThanFreeTail();
+    testPartiallyCompletedFences();
+    testOldestFenceValueWhenEmpty();
+    return testing::result();
+}
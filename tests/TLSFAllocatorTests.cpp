@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "DX12Wrappers/TLSFAllocator.h"
+
+namespace
+{
+    constexpr uint32_t OPERATIONS_PER_ROUND = 200000;
+    constexpr uint32_t CHECK_INTERVAL = 5000;
+
+    bool overlaps(std::vector<TLSFAllocator::Allocation> live)
+    {
+        std::sort(live.begin(), live.end(), [](auto const& a, auto const& b) { return a.offset < b.offset; });
+        for (size_t i = 1; i < live.size(); i++)
+        {
+            if (live[i - 1].offset + live[i - 1].size > live[i].offset)
+                return true;
+        }
+        return false;
+    }
+
+    // Random allocate/free mix, mostly small sizes with the occasional large one
+    void fuzzRound(std::mt19937_64& rng, uint64_t capacity, uint64_t alignment)
+    {
+        TLSFAllocator allocator(capacity, alignment);
+        std::vector<TLSFAllocator::Allocation> live;
+
+        for (uint32_t i = 0; i < OPERATIONS_PER_ROUND; i++)
+        {
+            if (live.empty() || rng() % 3 != 0)
+            {
+                uint64_t const size = rng() % 4 != 0 ? rng() % 4096 + 1 : rng() % (capacity / 4) + 1;
+                TLSFAllocator::Allocation allocation;
+                if (allocator.allocate(size, allocation))
+                {
+                    if (!CHECK(allocation.size >= size && allocation.offset % alignment == 0 && allocation.offset + allocation.size <= capacity))
+                        return;
+                    live.push_back(allocation);
+                }
+            }
+            else
+            {
+                size_t const index = rng() % live.size();
+                allocator.free(live[index]);
+                live[index] = live.back();
+                live.pop_back();
+            }
+
+            if (i % CHECK_INTERVAL == 0)
+            {
+                if (!CHECK(allocator.validate()) || !CHECK(!overlaps(live)) || !CHECK(allocator.allocationCount() == live.size()))
+                    return;
+            }
+        }
+
+        CHECK(!overlaps(live));
+        uint64_t liveBytes = 0;
+        for (auto const& allocation : live)
+        {
+            liveBytes += allocation.size;
+        }
+        CHECK(allocator.usedBytes() == liveBytes);
+
+        // Everything freed has to merge back into the single block it started as
+        for (auto& allocation : live)
+        {
+            allocator.free(allocation);
+        }
+        CHECK(allocator.validate());
+        CHECK(allocator.usedBytes() == 0);
+        CHECK(allocator.allocationCount() == 0);
+        CHECK(allocator.freeBlockCount() == 1);
+        CHECK(allocator.largestFreeBlock() == allocator.capacity());
+    }
+
+    void testRandomAllocFree()
+    {
+        std::mt19937_64 rng(1);
+        for (uint32_t round = 0; round < 8; round++)
+        {
+            uint64_t const capacity = rng() % (1 << 24) + 1000;
+            fuzzRound(rng, capacity, uint64_t(1) << (round % 3 * 4));
+        }
+    }
+}
+
+int main()
+{
+    testRandomAllocFree();
+    return testing::result();
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+/*
+ * Minimal checks for the unit tests, no framework needed. A failed check prints its location and the test carries on,
+ * main() returns testing::result() so CTest sees the failure. Unlike assert they also run in release builds.
+ */
+namespace testing
+{
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline bool check(bool condition, const char* expression, const char* file, int line)
+    {
+        if (!condition)
+        {
+            printf("%s(%d): check failed: %s\n", file, line, expression);
+            failures()++;
+        }
+        return condition;
+    }
+
+    inline int result()
+    {
+        if (failures() > 0)
+            printf("%d check(s) failed\n", failures());
+        return failures() > 0 ? 1 : 0;
+    }
+}
+
+#define CHECK(condition) testing::check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b, epsilon) testing::check(std::fabs((a) - (b)) <= (epsilon), #a " ~ " #b, __FILE__, __LINE__)
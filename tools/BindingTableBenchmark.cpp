@@ -0,0 +1,127 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "utils/Hash.h"
+
+/*
+ * CPU cost of binding a mesh's root SRVs per draw, without a device:
+ *   name lookup   - what Resource::bindResource did, std::string name, murmur hash and root parameter map find
+ *   binding table - what BindingTable::apply does, replays (root parameter index, address) pairs
+ * SetGraphicsRootShaderResourceView is replaced by a noinline sink, so only the binding path itself is measured.
+ *   BindingTableBenchmark [draws]
+ */
+
+#ifdef _MSC_VER
+#define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+    // Same seed PSOParser hashes root parameter names with
+    constexpr u32 NAME_HASH_SEED = 69;
+    constexpr uint32_t BINDINGS_PER_DRAW = 5;
+
+    const char* const ROOT_PARAMETER_NAMES[] = { "Vertices", "Meshlets", "IndexBuffer", "LocalIndexBuffer", "meshletcullData", "MeshInfo", "Instances", "CameraData" };
+
+    volatile uint64_t g_sink = 0;
+
+    BENCHMARK_NOINLINE void setRootShaderResourceView(uint32_t rootParameterIndex, uint64_t address)
+    {
+        g_sink = g_sink + (rootParameterIndex ^ address);
+    }
+
+    u32 hashName(std::string_view name)
+    {
+        return olej_utils::murmurHash(reinterpret_cast<const u8*>(name.data()), name.size(), NAME_HASH_SEED);
+    }
+
+    // PipelineState::m_rootParameterMap
+    std::unordered_map<u32, uint32_t> g_rootParameterMap;
+
+    BENCHMARK_NOINLINE int32_t getRootParameterIndex(std::string name)
+    {
+        auto const it = g_rootParameterMap.find(hashName(name));
+        return it != g_rootParameterMap.end() ? static_cast<int32_t>(it->second) : -1;
+    }
+
+    BENCHMARK_NOINLINE void bindByName(const char* name, uint64_t address)
+    {
+        int32_t const index = getRootParameterIndex(name);
+        if (index != -1)
+            setRootShaderResourceView(static_cast<uint32_t>(index), address);
+    }
+
+    struct Table
+    {
+        struct Binding
+        {
+            uint32_t rootParameterIndex;
+            uint64_t address;
+        };
+
+        Binding bindings[8];
+        uint32_t count = 0;
+    };
+
+    BENCHMARK_NOINLINE void applyTable(Table const& table)
+    {
+        for (uint32_t i = 0; i < table.count; i++)
+        {
+            setRootShaderResourceView(table.bindings[i].rootParameterIndex, table.bindings[i].address);
+        }
+    }
+
+    double nanosecondsPerDraw(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end, uint64_t draws)
+    {
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(draws);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t const draws = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    if (draws == 0)
+    {
+        printf("Usage: BindingTableBenchmark [draws]\n");
+        return 1;
+    }
+
+    uint32_t index = 0;
+    for (const char* name : ROOT_PARAMETER_NAMES)
+    {
+        g_rootParameterMap[hashName(name)] = index++;
+    }
+
+    Table table;
+    for (uint32_t i = 0; i < BINDINGS_PER_DRAW; i++)
+    {
+        table.bindings[table.count++] = { static_cast<uint32_t>(getRootParameterIndex(ROOT_PARAMETER_NAMES[i])), i * 4096ull };
+    }
+
+    auto const lookupStart = std::chrono::steady_clock::now();
+    for (uint64_t draw = 0; draw < draws; draw++)
+    {
+        for (uint32_t i = 0; i < BINDINGS_PER_DRAW; i++)
+        {
+            bindByName(ROOT_PARAMETER_NAMES[i], i * 4096ull);
+        }
+    }
+    auto const tableStart = std::chrono::steady_clock::now();
+    for (uint64_t draw = 0; draw < draws; draw++)
+    {
+        applyTable(table);
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    printf("%u SRVs per draw, %llu draws\n", BINDINGS_PER_DRAW, static_cast<unsigned long long>(draws));
+    printf("name lookup:   %.1f ns/draw\n", nanosecondsPerDraw(lookupStart, tableStart, draws));
+    printf("binding table: %.1f ns/draw\n", nanosecondsPerDraw(tableStart, end, draws));
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "DX12Wrappers/StagingRing.h"
+
+/*
+ * CPU cost of ConstantBufferRing::allocate, without a device: the mutex, StagingRing bookkeeping with 256 byte
+ * alignment, peak tracking, the copy into the ring and the two counter adds. The mapped upload heap is replaced
+ * by host memory and the GPU by a fence that completes framesInFlight frames late, like FramePacer allows.
+ *   ConstantBufferRingBenchmark [frames] [allocations per frame] [bytes per allocation]
+ */
+
+namespace
+{
+    // ConstantBufferRing::SIZE and D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+    constexpr uint64_t RING_SIZE = 16ull * 1024 * 1024;
+    constexpr uint64_t ALIGNMENT = 256;
+    constexpr uint64_t FRAMES_IN_FLIGHT = 3;
+
+    class Ring
+    {
+    public:
+        Ring() : m_ring(RING_SIZE), m_data(RING_SIZE) {}
+
+        uint64_t allocate(const void* data, uint64_t size)
+        {
+            std::unique_lock<std::mutex> lock(m_allocationMutex);
+            uint64_t offset = 0;
+            while (!m_ring.allocate(size, ALIGNMENT, offset))
+            {
+                // Where the real ring waits for the GPU
+                if (m_ring.oldestFenceValue() == 0)
+                {
+                    printf("A single frame doesn't fit into the ring\n");
+                    std::exit(1);
+                }
+                m_ring.reclaim(m_ring.oldestFenceValue());
+                m_stalls++;
+            }
+            m_peakUsedBytes = std::max(m_peakUsedBytes, m_ring.usedBytes());
+            lock.unlock();
+
+            std::memcpy(m_data.data() + offset, data, size);
+            // counters::add, one relaxed add per counter
+            m_allocations.fetch_add(1, std::memory_order_relaxed);
+            m_bytes.fetch_add(size, std::memory_order_relaxed);
+            return offset;
+        }
+
+        void endFrame(uint64_t fenceValue) { m_ring.submit(fenceValue); }
+        void reclaim(uint64_t completedFenceValue) { m_ring.reclaim(completedFenceValue); }
+
+        uint64_t peakUsedBytes() const { return m_peakUsedBytes; }
+        uint64_t stalls() const { return m_stalls; }
+
+    private:
+        StagingRing m_ring;
+        std::vector<uint8_t> m_data;
+        std::mutex m_allocationMutex;
+        uint64_t m_peakUsedBytes = 0;
+        uint64_t m_stalls = 0;
+        std::atomic<uint64_t> m_allocations = 0;
+        std::atomic<uint64_t> m_bytes = 0;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t const frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    uint64_t const allocationsPerFrame = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    uint64_t const bytesPerAllocation = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 64;
+    if (frames == 0 || allocationsPerFrame == 0 || bytesPerAllocation == 0 || bytesPerAllocation > RING_SIZE)
+    {
+        printf("Usage: ConstantBufferRingBenchmark [frames] [allocations per frame] [bytes per allocation]\n");
+        return 1;
+    }
+
+    Ring ring;
+    std::vector<uint8_t> const source(bytesPerAllocation, 0x5a);
+    uint64_t checksum = 0;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (uint64_t frame = 1; frame <= frames; frame++)
+    {
+        // FramePacer::beginFrame, the frame framesInFlight back has completed
+        if (frame > FRAMES_IN_FLIGHT)
+            ring.reclaim(frame - FRAMES_IN_FLIGHT);
+
+        for (uint64_t i = 0; i < allocationsPerFrame; i++)
+        {
+            checksum += ring.allocate(source.data(), bytesPerAllocation);
+        }
+        ring.endFrame(frame);
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    double const nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+    printf("%llu frames, %llu allocations of %llu bytes per frame, %llu frames in flight\n",
+        static_cast<unsigned long long>(frames), static_cast<unsigned long long>(allocationsPerFrame),
+        static_cast<unsigned long long>(bytesPerAllocation), static_cast<unsigned long long>(FRAMES_IN_FLIGHT));
+    printf("allocation: %.1f ns\n", nanoseconds / static_cast<double>(frames * allocationsPerFrame));
+    printf("frame:      %.3f ms\n", nanoseconds / static_cast<double>(frames) / 1000000.0);
+    printf("peak used:  %.2f MB, stalls: %llu (checksum %llu)\n", static_cast<double>(ring.peakUsedBytes()) / (1024.0 * 1024.0),
+        static_cast<unsigned long long>(ring.stalls()), static_cast<unsigned long long>(checksum));
+    return 0;
+}
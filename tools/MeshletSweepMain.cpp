@@ -0,0 +1,7 @@
+#include "Tools/MeshletSweep.h"
+
+// Headless build of the meshlet sweep, takes the same arguments with or without --meshlet-sweep in front
+int main(int argc, char** argv)
+{
+    return sweep::runFromCommandLine(argc, argv);
+}